@@ -30,9 +30,15 @@
 
 
 using namespace std;
+// Os modelos no so modificados pelas funes abaixo (state e as funes de
+// sada so const), portanto podem ser chamadas de vrias threads.
 Ashrae g;
 Giacomo iso;
 
+// Propriedades do ltimo estado consultado em cada thread (ver MoistAirCache): uma
+// planilha costuma pedir vrias propriedades do mesmo estado, uma clula de cada vez
+static thread_local MoistAirCache gcache, isocache;
+
 const int R=0, B=1, D=2, W=3, X=4;
 char cc[]={'R', 'B', 'D', 'W', 'X'};
 extern "C" {
@@ -44,8 +50,8 @@ extern "C" {
     char c=cc[*ch];
     soma = 0.0;
     if (c == 'B' || c == 'D') soma = 273.15;
-    g.set((*t+273.15), c, *umidade + soma, *p * 1000.0);
-    *r = g.DENSITY(*t + 273.15, *p * 1000.0);
+    MoistAirState s = g.state((*t+273.15), c, *umidade + soma, *p * 1000.0);
+    *r = g.evaluate(gcache, s, PROP_DENSITY).density;
     
 	
   }
@@ -58,8 +64,8 @@ extern "C" {
     double soma;
     soma = 0.0;
     if (c == 'B' || c == 'D') soma = 273.15;
-    g.set((*t+273.15), c, *umidade+soma, *p*1000.0);
-    *r = g.VOLUME(*t + 273.15, *p * 1000.0);
+    MoistAirState s = g.state((*t+273.15), c, *umidade+soma, *p*1000.0);
+    *r = g.evaluate(gcache, s, PROP_VOLUME).volume;
     
     
     // Teste
@@ -79,8 +85,8 @@ extern "C" {
     double soma;
     soma = 0.0;
     if (c == 'B' || c == 'D') soma = 273.15;
-    g.set((*t+273.15), c, *umidade+soma, *p*1000.0);
-    *r = g.ENTHALPY(*t + 273.15, *p * 1000.0);
+    MoistAirState s = g.state((*t+273.15), c, *umidade+soma, *p*1000.0);
+    *r = g.evaluate(gcache, s, PROP_ENTHALPY).enthalpy;
     
 	
   }
@@ -92,8 +98,8 @@ extern "C" {
     double soma;
     soma = 0.0;
     if (c == 'B' || c == 'D') soma = 273.15;
-    g.set((*t+273.15), c, *umidade+soma, *p*1000.0);
-    *r = g.WETBULB(*t + 273.15, *p * 1000.0) - 273.15;
+    MoistAirState s = g.state((*t+273.15), c, *umidade+soma, *p*1000.0);
+    *r = g.evaluate(gcache, s, PROP_WETBULB).wetbulb - 273.15;
     
 	
   }
@@ -105,8 +111,8 @@ extern "C" {
     double soma;
     soma = 0.0;
     if (c == 'B' || c == 'D') soma = 273.15;
-    g.set((*t+273.15), c, *umidade+soma, *p*1000.0);
-    *r = g.DEWPOINT(*t + 273.15, *p * 1000.0) - 273.15;
+    MoistAirState s = g.state((*t+273.15), c, *umidade+soma, *p*1000.0);
+    *r = g.evaluate(gcache, s, PROP_DEWPOINT).dewpoint - 273.15;
     
 	
   }
@@ -119,8 +125,8 @@ extern "C" {
     double soma;
     soma = 0.0;
     if (c == 'B' || c == 'D') soma = 273.15;
-    g.set((*t+273.15), c, *umidade+soma, *p*1000.0);
-    *r = g.RELHUM(*t + 273.15, *p * 1000.0);
+    MoistAirState s = g.state((*t+273.15), c, *umidade+soma, *p*1000.0);
+    *r = g.evaluate(gcache, s, PROP_RELHUM).relhum;
     
 	
   }
@@ -133,8 +139,8 @@ extern "C" {
     double soma;
     soma = 0.0;
     if (c == 'B' || c == 'D') soma = 273.15;
-    g.set((*t+273.15), c, *umidade+soma, *p*1000.0);
-    *r = g.HUMRAT();
+    MoistAirState s = g.state((*t+273.15), c, *umidade+soma, *p*1000.0);
+    *r = s.W;
   }
 
 
@@ -145,8 +151,8 @@ extern "C" {
     double soma;
     soma = 0.0;
     if (c == 'B' || c == 'D') soma = 273.15;
-    g.set((*t+273.15), c, *umidade+soma, *p*1000.0);
-    *r = g.MOLFRAC();
+    MoistAirState s = g.state((*t+273.15), c, *umidade+soma, *p*1000.0);
+    *r = s.xv;
   }
   
   PSYCHROAPI void PSYCHROCALL psychro_Z(int *ch, double *t, 
@@ -156,8 +162,8 @@ extern "C" {
     double soma;
     soma = 0.0;
     if (c == 'B' || c == 'D') soma = 273.15;
-    g.set((*t+273.15), c, *umidade+soma, *p*1000.0);
-    *r = g.Z(*t+273.15, *p * 1000.0, g.XV);
+    MoistAirState s = g.state((*t+273.15), c, *umidade+soma, *p*1000.0);
+    *r = g.Z(s.T, s.P, s.xv);
   }
   
   PSYCHROAPI void PSYCHROCALL psychro_psat(double *t, double *r)
@@ -189,8 +195,8 @@ extern "C" {
     char c=cc[*ch];
     soma = 0.0;
     if (c == 'B' || c == 'D') soma = 273.15;
-    iso.set((*t+273.15), c, *umidade + soma, *p * 1000.0);
-    *r = iso.DENSITY(*t + 273.15, *p * 1000.0);
+    MoistAirState s = iso.state((*t+273.15), c, *umidade + soma, *p * 1000.0);
+    *r = iso.evaluate(isocache, s, PROP_DENSITY).density;
     
 	
   }
@@ -203,8 +209,8 @@ extern "C" {
     double soma;
     soma = 0.0;
     if (c == 'B' || c == 'D') soma = 273.15;
-    iso.set((*t+273.15), c, *umidade+soma, *p*1000.0);
-    *r = iso.VOLUME(*t + 273.15, *p * 1000.0);
+    MoistAirState s = iso.state((*t+273.15), c, *umidade+soma, *p*1000.0);
+    *r = iso.evaluate(isocache, s, PROP_VOLUME).volume;
     
     
     // Teste
@@ -224,8 +230,8 @@ extern "C" {
     double soma;
     soma = 0.0;
     if (c == 'B' || c == 'D') soma = 273.15;
-    iso.set((*t+273.15), c, *umidade+soma, *p*1000.0);
-    *r = iso.ENTHALPY(*t + 273.15, *p * 1000.0);
+    MoistAirState s = iso.state((*t+273.15), c, *umidade+soma, *p*1000.0);
+    *r = iso.evaluate(isocache, s, PROP_ENTHALPY).enthalpy;
     
 	
   }
@@ -237,8 +243,8 @@ extern "C" {
     double soma;
     soma = 0.0;
     if (c == 'B' || c == 'D') soma = 273.15;
-    iso.set((*t+273.15), c, *umidade+soma, *p*1000.0);
-    *r = iso.WETBULB(*t + 273.15, *p * 1000.0) - 273.15;
+    MoistAirState s = iso.state((*t+273.15), c, *umidade+soma, *p*1000.0);
+    *r = iso.evaluate(isocache, s, PROP_WETBULB).wetbulb - 273.15;
     
 	
   }
@@ -250,8 +256,8 @@ extern "C" {
     double soma;
     soma = 0.0;
     if (c == 'B' || c == 'D') soma = 273.15;
-    iso.set((*t+273.15), c, *umidade+soma, *p*1000.0);
-    *r = iso.DEWPOINT(*t + 273.15, *p * 1000.0) - 273.15;
+    MoistAirState s = iso.state((*t+273.15), c, *umidade+soma, *p*1000.0);
+    *r = iso.evaluate(isocache, s, PROP_DEWPOINT).dewpoint - 273.15;
     
 	
   }
@@ -264,8 +270,8 @@ extern "C" {
     double soma;
     soma = 0.0;
     if (c == 'B' || c == 'D') soma = 273.15;
-    iso.set((*t+273.15), c, *umidade+soma, *p*1000.0);
-    *r = iso.RELHUM(*t + 273.15, *p * 1000.0);
+    MoistAirState s = iso.state((*t+273.15), c, *umidade+soma, *p*1000.0);
+    *r = iso.evaluate(isocache, s, PROP_RELHUM).relhum;
     
 	
   }
@@ -278,8 +284,8 @@ extern "C" {
     double soma;
     soma = 0.0;
     if (c == 'B' || c == 'D') soma = 273.15;
-    iso.set((*t+273.15), c, *umidade+soma, *p*1000.0);
-    *r = iso.HUMRAT();
+    MoistAirState s = iso.state((*t+273.15), c, *umidade+soma, *p*1000.0);
+    *r = s.W;
   }
 
 
@@ -290,8 +296,8 @@ extern "C" {
     double soma;
     soma = 0.0;
     if (c == 'B' || c == 'D') soma = 273.15;
-    iso.set((*t+273.15), c, *umidade+soma, *p*1000.0);
-    *r = iso.MOLFRAC();
+    MoistAirState s = iso.state((*t+273.15), c, *umidade+soma, *p*1000.0);
+    *r = s.xv;
   }
   
   PSYCHROAPI void PSYCHROCALL iso_Z(int *ch, double *t, 
@@ -301,8 +307,8 @@ extern "C" {
     double soma;
     soma = 0.0;
     if (c == 'B' || c == 'D') soma = 273.15;
-    iso.set((*t+273.15), c, *umidade+soma, *p*1000.0);
-    *r = iso.Z(*t+273.15, *p * 1000.0, iso.XV);
+    MoistAirState s = iso.state((*t+273.15), c, *umidade+soma, *p*1000.0);
+    *r = iso.Z(s.T, s.P, s.xv);
   }
   
   PSYCHROAPI void PSYCHROCALL iso_psat(double *t, double *r)
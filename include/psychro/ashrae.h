@@ -1,7 +1,10 @@
 #ifndef _Ashrae_h
 #define _Ashrae_h
 
+#include <memory>
+
 #include "gas_perfeito.h"
+#include "chebyshev.h"
 
 /*! \file Ashrae.h
 
@@ -37,10 +40,119 @@ De uma maneira geral, os m
 class Ashrae: public GasPerfeito{
  public:
   
+  /*! \brief Coeficientes viriais e suas derivadas em uma temperatura
+
+  Todos os coeficientes viriais (\f$m^3/kmol\f$ e \f$m^6/kmol^2\f$) e as suas derivadas em relao  temperatura, calculados de uma s vez pela funo Ashrae::virial.
+  */
+  struct VirialSet{
+    double Baa, Bww, Baw;
+    double Caaa, Cwww, Caaw, Caww;
+    double dBaa, dBww, dBaw;
+    double dCaaa, dCwww, dCaaw, dCaww;
+
+    /// Segundo coeficiente virial da mistura com frao molar de vapor xv
+    double Bm(double xv) const{
+      double xa = 1.0 - xv;
+      return xa*xa*Baa + 2*xa*xv*Baw + xv*xv*Bww;
+    }
+    /// Terceiro coeficiente virial da mistura com frao molar de vapor xv
+    double Cm(double xv) const{
+      double xa = 1.0 - xv;
+      return xa*xa*xa*Caaa + 3*xa*xa*xv*Caaw + 3*xa*xv*xv*Caww + xv*xv*xv*Cwww;
+    }
+    /// Derivada de Bm em relao  temperatura
+    double dBm(double xv) const{
+      double xa = 1.0 - xv;
+      return xa*xa*dBaa + 2*xa*xv*dBaw + xv*xv*dBww;
+    }
+    /// Derivada de Cm em relao  temperatura
+    double dCm(double xv) const{
+      double xa = 1.0 - xv;
+      return xa*xa*xa*dCaaa + 3*xa*xa*xv*dCaaw + 3*xa*xv*xv*dCaww + xv*xv*xv*dCwww;
+    }
+  };
+
+  /*! \brief Grandezas de saturao que dependem apenas da temperatura
+
+  Calculada pela funo Ashrae::saturation. Contm tudo o que o enhancement factor precisa e que no depende da presso nem da frao molar: presso de vapor (e sua derivada), volume molar e compressibilidade da fase condensada, constante de Henry e coeficientes viriais. Pode ser reutilizada em vrios clculos na mesma temperatura.
+  */
+  struct SaturationPoint{
+    /// Temperatura K
+    double T;
+    /// Presso de vapor saturado Pa
+    double Pws;
+    /// Derivada da presso de vapor saturado Pa/K (calculada junto com Pws, ver PwsdPws)
+    double dPws;
+    /// Volume molar da fase condensada \f$m^3/kmol\f$
+    double vc;
+    /// Compressibilidade isotrmica da fase condensada 1/Pa
+    double kappa;
+    /// Constante de Henry do ar 1/Pa (0 para T < 273.15)
+    double k;
+    /// Coeficientes viriais
+    VirialSet v;
+  };
+  
+
+  /// Mtodos de soluo da equao virial (ver vMvirial)
+  enum VirialMethod{
+    VIRIAL_ITERATIVE,		///< Substituies sucessivas a partir do gs perfeito
+    VIRIAL_HALLEY		///< Dois passos de Halley sobre a cbica (sem lao condicional)
+  };
+
+  /// Mtodo utilizado para resolver a equao virial em Z, vM_a_ e vM_v_
+  VirialMethod virialMethod;
+
+  /*! Valores iniciais dos mtodos iterativos obtidos do modelo de gs perfeito (ver seedModel): Tws e DEWPOINT partem de GasPerfeito::Tws, WETBULB do bulbo mido do gs perfeito e CalcWfromB da expresso explcita de GasPerfeito::state. Ativado por padro; os resultados so os mesmos dentro das tolerncias (ver Tolerances), com menos iteraes.
+   */
+  bool perfectGasSeed;
+
+  /*! \brief Tabelas do modo rpido (ver Ashrae::fastMode)
+
+  Aproximaes por polinmios de Chebyshev das funes de saturao, separadas em gelo (T < 273.15) e gua lquida. As funes retornam false se o ponto estiver fora do domnio ajustado; neste caso deve-se utilizar a funo exata.
+  */
+  struct FastTables{
+    /// Presso de vapor em funo de T
+    ChebyshevTable pws_s, pws_l;
+    /// Temperatura de saturao em funo de ln P
+    ChebyshevTable tws_s, tws_l;
+    /// Enhancement factor em funo de T e P
+    ChebyshevTable ef_s, ef_l;
+    /// Identifica as tabelas em configHash
+    ModelId id;
+
+    bool Pws(double T, double &p, double *dp=0) const;
+    bool Tws(double P, double &T) const;
+    bool eFactor(double T, double P, double &f) const;
+  };
+
+  /// Funes que podem ser tabeladas no modo rpido (ver fastTables)
+  enum FastFunction{
+    FAST_PWS = 1,		///< Pws e PwsdPws
+    FAST_TWS = 2,		///< Tws
+    FAST_EFACTOR = 4		///< eFactor
+  };
+
+  /// Tabelas do modo rpido. Nulo no modo exato. Compartilhadas entre cpias do modelo
+  std::shared_ptr<const FastTables> fast;
 
   Ashrae();
   virtual void set(double T, char ch, double umidade, double P);
-  virtual double Z(double T, double P, double xv); // Compressibilidade
+  /// Ativa o modo rpido (funes de saturao tabeladas)
+  int fastMode(double Tlo, double Thi, double Plo, double Phi, double tol=1e-9);
+  /// Volta ao modo exato
+  void exactMode();
+  /// Funes tabeladas por fastMode (combinao de FastFunction)
+  virtual unsigned fastTables() const;
+  virtual uint64_t configHash() const;
+  virtual MoistAirState state(double T, char ch, double umidade, double P) const;
+  virtual MoistAirState state(double T, char ch, double umidade, double P, SolverContext &c) const;
+  /// Estados de n amostras (verso em lote de state)
+  virtual void stateBatch(size_t n, char ch, const double *T, const double *umidade,
+			  const double *P, MoistAirState *s) const;
+  virtual double Z(double T, double P, double xv, int *err=0) const; // Compressibilidade
+  virtual void ZBatch(size_t n, const double *T, const double *P, const double *xv,
+		      double *Z, int *err=0) const;
   
   
 
@@ -56,129 +168,246 @@ class Ashrae: public GasPerfeito{
   virtual double RELHUM(double T, double P);    	// Umidade relativa;
   virtual double MOLFRAC();		// Frao molar de vapor
   virtual int ERROR();   		// Cdigo de erro.
+
+  // Funes de sada reentrantes (no modificam o modelo)
+  virtual double ENTHALPY(const MoistAirState &s, int *err=0) const;
+  virtual double VOLUME(const MoistAirState &s, int *err=0) const;
+  virtual double DENSITY(const MoistAirState &s, int *err=0) const;
+  virtual double WETBULB(const MoistAirState &s, int *err=0) const;
+  virtual double WETBULB(const MoistAirState &s, SolverContext &c, int *err=0) const;
+  virtual double DEWPOINT(const MoistAirState &s, int *err=0) const;
+  virtual double DEWPOINT(const MoistAirState &s, SolverContext &c, int *err=0) const;
+  virtual double RELHUM(const MoistAirState &s, int *err=0) const;
+  virtual MoistAirProperties evaluate_all(const MoistAirState &s, unsigned mask=PROP_ALL) const;
+  virtual const MoistAirProperties &evaluate(MoistAirCache &c, const MoistAirState &s,
+					     unsigned mask=PROP_ALL) const;
+  virtual void gridRow(double T, size_t nP, const double *P, char ch, size_t nU,
+		       const double *umidade, const MoistAirColumns &out) const;
+  virtual void batch(size_t n, char ch, const double *T, const double *umidade,
+		     const double *P, const MoistAirColumns &out) const;
+  virtual void batchFloat(size_t n, char ch, const float *T, const float *umidade,
+			  const float *P, const MoistAirColumnsF &out) const;
+  virtual bool nativeBatch() const;
+  /// Temperatura de bulbo mido de n estados (verso vetorial de WETBULB)
+  virtual void WETBULBBatch(size_t n, const double *T, const double *P, const double *W,
+			    double *B, int *err=0) const;
+  /// Ponto de orvalho de n estados (verso vetorial de DEWPOINT)
+  virtual void DEWPOINTBatch(size_t n, const double *P, const double *xv, double *D,
+			     int *err=0) const;
   
 
   // Funes auxiliares:
-  virtual double eFactor(double T, double P);	// Enhancement factor
-  virtual double Pws(double T);  	// Presso de saturao de vapor
-  virtual double Tws(double P);         // Temperatura de saturao de vapor
+  virtual double eFactor(double T, double P) const;	// Enhancement factor
+  virtual double eFactor(const SaturationPoint &sp, double P, int *err=0) const;	// Enhancement factor
+  /// Enhancement factor partindo de f0 (ver SolverContext)
+  virtual double eFactor(const SaturationPoint &sp, double P, double f0, int *err=0) const;
+  virtual void eFactorBatch(size_t n, const double *T, const double *P, double *f,
+			    int *err=0) const;
+  /// Grandezas de saturao na temperatura T
+  virtual SaturationPoint saturation(double T) const;
+  virtual double Pws(double T, int *err=0) const;  	// Presso de saturao de vapor
+  virtual double Tws(double P, int *err=0) const;         // Temperatura de saturao de vapor
+  virtual void TwsBatch(size_t n, const double *P, double *T, int *err=0) const;
+  /// Estimativa explcita de Tws
+  double Tws0(double P) const;
+  /// Modelo de gs perfeito que fornece os valores iniciais (ver perfectGasSeed)
+  static const GasPerfeito &seedModel();
 
   //virtual double Pws_s(double T);	// Presso de saturao de vapor
   //virtual double Pws_l(double T);	// Presso de saturao de vapor
 
   // Propriedades:
   // Entalpia:
-  virtual double h_a_(double T, double P=101325.0);
-  virtual double h_v_(double T);
-  virtual double h_l_(double T);
-  virtual double h_s_(double T);
-  virtual double h_f_(double T);
-  virtual double h_(double T, double P, double xv);
+  virtual double h_a_(double T, double P=101325.0, int *err=0) const;
+  virtual double h_v_(double T, int *err=0) const;
+  virtual double h_l_(double T) const;
+  virtual double h_s_(double T) const;
+  virtual double h_f_(double T) const;
+  virtual double dh_f_(double T) const;
+  /// Entalpia da fase condensada e sua derivada a partir das grandezas de saturao (sem recalcular a presso de vapor)
+  virtual double hfSat(const SaturationPoint &sp, double ref, double *dh=0) const;
+  /// Termo de referncia da entalpia da gua lquida, \f$v_l(273.15) P_{ws}'(273.15)\f$ (ver h_l_)
+  double hlRef() const;
+  /// Entalpia da fase condensada e sua derivada de n temperaturas (verso vetorial de h_f_ e dh_f_)
+  virtual void hfBatch(size_t n, const double *T, double *h, double *dh=0) const;
+  virtual double h_(double T, double P, double xv, int *err=0) const;
+  /// Entalpia molar do ar mido J/kmol e derivadas
+  double hM_(double T, double P, double xv, double *dhdx=0, double *dhdT=0, int *err=0) const;
+  /// Entalpia do ar mido por kg de ar seco e derivadas
+  double hw_(double T, double P, double w, double *dHdw=0, double *dHdT=0, int *err=0) const;
+  /// Entalpia por kg de ar seco e derivadas de n estados (verso vetorial de hw_)
+  virtual void hwBatch(size_t n, const double *T, const double *P, const double *w, double *H,
+		       double *dHdw=0, double *dHdT=0, int *err=0) const;
 
   // volume:
-  virtual double v_a_(double T, double P);
-  virtual double v_v_(double T);
-  virtual double v_(double T, double P, double xv);
+  virtual double v_a_(double T, double P, int *err=0) const;
+  virtual double v_v_(double T, int *err=0) const;
+  virtual double v_(double T, double P, double xv, int *err=0) const;
   
 
   // Volume molar
-  virtual double vM_a_(double T, double P);
-  virtual double vM_v_(double T);
-  virtual double vM_(double T, double P, double xv);
+  virtual double vM_a_(double T, double P, int *err=0) const;
+  virtual double vM_v_(double T, int *err=0) const;
+  virtual double vM_(double T, double P, double xv, int *err=0) const;
+  /// vM_ com os coeficientes viriais v da temperatura T j calculados
+  virtual double vMfromVirial(const VirialSet &v, double T, double P, double xv, int *err=0) const;
 
   // Densidade
   // volume:
-  virtual double r_a_(double T, double P);
-  virtual double r_v_(double T);
-  virtual double r_(double T, double P, double xv);
+  virtual double r_a_(double T, double P, int *err=0) const;
+  virtual double r_v_(double T, int *err=0) const;
+  virtual double r_(double T, double P, double xv, int *err=0) const;
   
 
 
   // Funes auxiliares
   /// Compressibilidade isotrmica do gelo 1/Pa
-  virtual double kappa_s(double T);
+  virtual double kappa_s(double T) const;
   /// Compressibilidade isotrmica da gua 1/Pa
-  virtual double kappa_l(double T);
+  virtual double kappa_l(double T) const;
   /// Compressibilidade isotrmica da agua (T>273.15) ou gelo (T<273.15) 1/Pa
-  virtual double kappa_f(double T);
+  virtual double kappa_f(double T) const;
+  /// Compressibilidade isotrmica da fase condensada de n temperaturas (verso vetorial de kappa_f)
+  virtual void kappafBatch(size_t n, const double *T, double *k) const;
 
   /// Constante de Henry para o ar seco 1/Pa
-  virtual double henryk (double T); 
+  virtual double henryk(double T) const; 
+  /// Constante de Henry para o ar seco de n temperaturas (verso vetorial de henryk)
+  virtual void henrykBatch(size_t n, const double *T, double *k) const;
   /// Constante de Henry do nitrognio 1/Pa
-  virtual double henryk_N2 (double T);
+  virtual double henryk_N2(double T) const;
   /// Constante de Henry do oxignio 1/Pa
-  virtual double henryk_O2 (double T);
+  virtual double henryk_O2(double T) const;
 
   /// Funo auxilar para o clculo do enhancement factor
-  virtual double lnf(double Tk, double P, double xas);
+  virtual double lnf(double Tk, double P, double xas) const;
+  /// Funo auxilar para o clculo do enhancement factor
+  double lnf(const SaturationPoint &sp, double P, double xas) const;
+
+  /// Soluo da equao virial para o volume molar (\f$m^3/kmol\f$)
+  double vMvirial(double Tk, double P, double B, double C, int NMAX, double EPS,
+		  int codigo, int *err=0) const;
 
 
 
   /// Coeficiente virial do ar puro
-  virtual double Baa(double T);
+  virtual double Baa(double T) const;
   /// Constante virial da gua pura
-  virtual double Bww(double T);
+  virtual double Bww(double T) const;
   /// Segundo coeficiente virial cruzado ar-agua
-  virtual double Baw(double T);
+  virtual double Baw(double T) const;
   /// Terceiro coeficiente virial do ar puro
-  virtual double Caaa(double T);
+  virtual double Caaa(double T) const;
   /// Terceiro coeficiente virial da gua pura
-  virtual double Cwww(double T);
+  virtual double Cwww(double T) const;
   /// Terceiro coeficiente virial cruzado ar-gua
-  virtual double Caaw(double T);
+  virtual double Caaw(double T) const;
   /// Terceiro coeficiente virial cruzado ar-gua
-  virtual double Caww(double T);
+  virtual double Caww(double T) const;
   
   /// Derivada do coeficiente virial do ar puro
-  virtual double dBaa(double T);
+  virtual double dBaa(double T) const;
   /// Derivada do constante virial da gua pura
-  virtual double dBww(double T);
+  virtual double dBww(double T) const;
   /// Derivada do segundo coeficiente virial cruzado ar-agua
-  virtual double dBaw(double T);
+  virtual double dBaw(double T) const;
 
   /// Derivada do terceiro coeficiente virial do ar puro
-  virtual double dCaaa(double T);
+  virtual double dCaaa(double T) const;
   /// Derivada do terceiro coeficiente virial da gua pura
-  virtual double dCwww(double T);
+  virtual double dCwww(double T) const;
   /// Derivada do terceiro coeficiente virial cruzado ar-gua
-  virtual double dCaaw(double T);
+  virtual double dCaaw(double T) const;
   /// Derivada do terceiro coeficiente virial cruzado ar-gua
-  virtual double dCaww(double T);
+  virtual double dCaww(double T) const;
 
   /// Terceiro coeficiente virial da gua pura
-  virtual double Clinha(double T);
+  virtual double Clinha(double T) const;
   /// Constante virial da gua pura
-  virtual double Blinha(double T);
+  virtual double Blinha(double T) const;
   /// Derivada do constante virial da gua pura
-  virtual double dBlinha(double T);
+  virtual double dBlinha(double T) const;
   /// Derivada do terceiro coeficiente virial da gua pura
-  virtual double dClinha(double T);
+  virtual double dClinha(double T) const;
+
+  /// Todos os coeficientes viriais e derivadas de uma s vez
+  virtual VirialSet virial(double T) const;
+  /// Coeficientes viriais de n temperaturas (verso vetorial de virial)
+  virtual void virialBatch(size_t n, const double *T, VirialSet *v) const;
 
   /// Coeficiente virial da mistura ar-agua
-  virtual double Bm(double T, double xv);
+  virtual double Bm(double T, double xv) const;
   /// Terceiro coeficiente virial da mistura ar-gua
-  virtual double Cm(double T, double xv);
+  virtual double Cm(double T, double xv) const;
   
   /// Presso de vapor saturado em equilbrio com gelo
-  virtual double Pws_s(double T);  	// Presso de saturao de vapor
+  virtual double Pws_s(double T) const;  	// Presso de saturao de vapor
   /// Presso de vapor saturado em equilbrio com gua
-  virtual double Pws_l(double T);  	// Presso de saturao de vapor
+  virtual double Pws_l(double T) const;  	// Presso de saturao de vapor
 
   /// Derivada da presso de vapor saturado em equilbrio com gelo
-  virtual double dPws_s(double T);  	// Presso de saturao de vapor
+  virtual double dPws_s(double T) const;  	// Presso de saturao de vapor
   /// Derivada da presso de vapor saturado em equilbrio com gua
-  virtual double dPws_l(double T);  	// Presso de saturao de vapor
+  virtual double dPws_l(double T) const;  	// Presso de saturao de vapor
   /// Derivada da presso de vapor saturado 
-  virtual double dPws(double T);  	// Presso de saturao de vapor
+  virtual double dPws(double T) const;  	// Presso de saturao de vapor
+  /// Presso de vapor saturado e sua derivada
+  virtual double PwsdPws(double T, double &dP) const;
+  /// Presso de vapor saturado de n temperaturas (verso vetorial de Pws)
+  virtual void PwsBatch(size_t n, const double *T, double *p) const;
+  /// Presso de vapor saturado e sua derivada de n temperaturas (verso vetorial de PwsdPws)
+  virtual void PwsdPwsBatch(size_t n, const double *T, double *p, double *dp) const;
 
 
 
   
   // Funes auxiliares:
   /// Funo auxiliar para o clculo do teor de umidade dado e a temperatura de bulbo mido
-  double CalcWfromB(double T, double B, double P);
+  double CalcWfromB(double T, double B, double P, int *err=0) const;
+  /// Teor de umidade de n estados dada a temperatura de bulbo mido (verso vetorial de CalcWfromB)
+  virtual void CalcWfromBBatch(size_t n, const double *T, const double *B, const double *P,
+			       double *W, int *err=0) const;
+  /// Funo auxiliar para o clculo do bulbo mido
+  double AuxWB(double w, double T, double B, double P, int *err=0) const;
   /// Funo auxiliar para o clculo do bulbo mido
-  double AuxWB(double w, double T, double B, double P);
+  double AuxWB(double w, double T, const SaturationPoint &sb, double P, int *err=0) const;
+
+  /// Algoritmos das funes de sada para o modelo do tipo Model (ver ashrae_kernel.h)
+  template<class Model> struct Kernel;
+  /// Clculo em lote em vetores float para o modelo do tipo Model (ver ashrae_lanes.h)
+  template<class Model> struct LaneKernel;
+  /// gridRow com o modelo esttico m (ver models.h)
+  template<class Model> void gridRowModel(const Model &m, double T, size_t nP, const double *P,
+					  char ch, size_t nU, const double *umidade,
+					  const MoistAirColumns &out) const;
+  /// batchFloat com o modelo esttico m (ver models.h)
+  template<class Model> void batchFloatModel(const Model &m, size_t n, char ch, const float *T,
+					     const float *umidade, const float *P,
+					     const MoistAirColumnsF &out) const;
+
+  /// \name Verses vetoriais das funes em lote para o vetor V (ver PSYCHRO_SIMD_DISPATCH em vecmath.h)
+  ///@{
+  template<class V> void virialLanes(size_t n, const double *T, VirialSet *v) const;
+  template<class V> void PwsLanes(size_t n, const double *T, double *p) const;
+  template<class V> void PwsdPwsLanes(size_t n, const double *T, double *p, double *dp) const;
+  template<class V> void TwsLanes(size_t n, const double *P, double *T, int *err) const;
+  template<class V> V Tws0Lanes(const V &P) const;
+  template<class V> void ZLanes(size_t n, const double *T, const double *P, const double *xv,
+				double *Z, int *err) const;
+  template<class V> void eFactorLanes(size_t n, const double *T, const double *P, double *f,
+				      int *err) const;
+  template<class V> void hwLanes(size_t n, const double *T, const double *P, const double *w,
+				 double *H, double *dHdw, double *dHdT, int *err) const;
+  template<class V> void henrykLanes(size_t n, const double *T, double *k) const;
+  template<class V> void kappafLanes(size_t n, const double *T, double *k) const;
+  template<class V> void hfLanes(size_t n, const double *T, double *h, double *dh) const;
+  template<class V> void DEWPOINTLanes(size_t n, const double *P, const double *xv, double *D,
+				       int *err) const;
+  template<class V> void WETBULBLanes(size_t n, const double *T, const double *P, const double *W,
+				      double *B, int *err) const;
+  template<class V> void CalcWfromBLanes(size_t n, const double *T, const double *B,
+					 const double *P, double *W, int *err) const;
+  ///@}
   
   
 
@@ -0,0 +1,668 @@
+/*! \file ashrae_kernel.h
+
+\brief Algoritmos das funes de sada da classe Ashrae
+
+Implementao das funes de sada de Ashrae (state, WETBULB, DEWPOINT, ...), das funes auxiliares utilizadas nas iteraes (CalcWfromB, AuxWB, hM_ e hw_) e das correlaes compostas (saturation, h_f_, vM_, Tws, ...) como funes estticas de Ashrae::Kernel<Model>. As correlaes explcitas esto em correlations.h. Ver gas_perfeito_kernel.h. A classe Giacomo e os modelos estticos (ver models.h) utilizam os mesmos algoritmos.
+*/
+
+#ifndef _ashrae_kernel_h
+#define _ashrae_kernel_h
+
+#include <cmath>
+
+#include "correlations.h"
+
+
+/*! \brief Algoritmos do modelo da ASHRAE para o modelo do tipo Model
+
+Ver a documentao das funes de mesmo nome da classe Ashrae.
+*/
+template<class Model>
+struct Ashrae::Kernel{
+
+  /// \name Correlaes compostas (ver as funes de mesmo nome de Ashrae)
+  ///@{
+  static SaturationPoint saturation(const Model &m, double Tk){
+    SaturationPoint sp;
+    sp.T = Tk;
+    sp.Pws = m.PwsdPws(Tk, sp.dPws);
+    sp.vc = m.v_f_(Tk) * Mv;
+    sp.kappa = m.kappa_f(Tk);
+    if (Tk < 273.15)
+      sp.k = 0.0;
+    else
+      sp.k = m.henryk(Tk);
+    sp.v = m.virial(Tk);
+    return sp;
+  }
+
+  static double kappa_f(const Model &m, double Tk){
+    if (Tk < 273.15)
+      return m.kappa_s(Tk);
+    else
+      return m.kappa_l(Tk);
+  }
+
+  static double henryk(const Model &m, double Tk){
+    return AshraeCorrelations::henryk(m.henryk_O2(Tk), m.henryk_N2(Tk));
+  }
+
+  static double Tws0(const Model &m, double PP){
+    if (m.perfectGasSeed){
+      int e = 0;
+      double T = m.seedModel().Tws(PP, &e);
+      if (!e) return T;
+    }
+    return AshraeCorrelations::tws0(PP);
+  }
+
+  static double Tws(const Model &m, double PP, int *err){
+    double T;
+    if (m.fast && m.fast->Tws(PP, T)) return T;
+
+    T = m.Tws0(PP);
+
+    const double NMAX=100;
+    const double EPS=m.tol.Tws;
+
+    double f, df, dT;
+
+    for(int iter=0; iter < NMAX; ++iter){
+      f = PP-m.PwsdPws(T, df);
+      df = - df;
+      dT = - f/df;
+
+      T += dT;
+
+      if (fabs(dT) < EPS) return T;
+    }
+    if (err) *err = 106;
+
+    return T;
+  }
+
+  static double vMvirial(const Model &m, double Tk, double P, double B, double C, int NMAX,
+			 double EPS, int codigo, int *err){
+    double vm =  R*Tk/P;
+    double vmn;
+
+    if (m.virialMethod == VIRIAL_HALLEY){
+      double a = vm;
+      double f, df, d2f;
+      vmn = a + B;
+      for (int k = 0; k < 2; ++k){
+	f = ((vmn - a)*vmn - a*B)*vmn - a*C;
+	df = (3*vmn - 2*a)*vmn - a*B;
+	d2f = 6*vmn - 2*a;
+	vmn -= 2*f*df / (2*df*df - f*d2f);
+      }
+      if (vmn > 0.0) return vmn;
+    }
+
+    double erro;
+    for (int iter = 0; iter < NMAX; ++iter){
+      vmn = R*Tk/P * (1 + B/vm + C/(vm*vm));
+      erro = fabs(vmn - vm);
+      vm = vmn;
+
+      if (erro < EPS*vm) return vm;
+    }
+    if (err) *err = codigo;
+    return(vm);
+  }
+
+  static double vM_(const Model &m, double Tk, double P, double xv, int *err){
+    return m.Z(Tk, P, xv, err) * R*Tk/P;
+  }
+
+  static double v_(const Model &m, double T, double P, double xv, int *err){
+    return m.vM_(T, P, xv, err) / ((1.0-xv)*Ma + xv * Mv);
+  }
+
+  static double r_(const Model &m, double T, double P, double xv, int *err){
+    return 1.0/m.v_(T, P, xv, err);
+  }
+
+  static double vM_a_(const Model &m, double Tk, double P, int *err){
+    VirialSet v = m.virial(Tk);
+    return vMvirial(m, Tk, P, v.Baa, v.Caaa, 100, m.tol.volume, 102, err);
+  }
+
+  static double vM_v_(const Model &m, double Tk, int *err){
+    VirialSet v = m.virial(Tk);
+    return vMvirial(m, Tk, m.Pws(Tk), v.Bww, v.Cwww, 200, m.tol.volume, 101, err);
+  }
+
+  static double h_a_(const Model &m, double Tk, double P, int *err){
+    double b[] = {-0.79078691e4,
+		  0.28709015e2,
+		  0.26431805e-2,
+		  -0.10405863e-4,
+		  0.18660410e-7,
+		  -0.97843331e-11};
+
+    VirialSet v = m.virial(Tk);
+    double B = v.Baa;
+    double C = v.Caaa;
+    double dB = v.dBaa;
+    double dC = v.dCaaa;
+
+    double Vm = m.vM_a_(Tk, P, err);
+
+    double ha = 1000*(b[0] + b[1]*Tk + b[2]*Tk*Tk + b[3]*Tk*Tk*Tk +
+		      b[4]*pow(Tk,4) + b[5]*pow(Tk,5));
+
+    ha = ha + R*Tk * ( (B - Tk*dB)/Vm + (C - 0.5*Tk*dC)/(Vm*Vm)  );
+    return ha/Ma;
+  }
+
+  static double h_v_(const Model &m, double Tk, int *err){
+    double d[] = {-0.5008e-2,
+		  0.32491829e2,
+		  0.65576345e-2,
+		  -0.26442147e-4,
+		  0.51751789e-7,
+		  -0.31541624e-10};
+
+    // Clculo dos coeficientes
+    VirialSet v = m.virial(Tk);
+    double B = v.Bww;
+    double C = v.Cwww;
+
+    double dB = v.dBww;
+    double dC = v.dCwww;
+
+    double hv = 35994.17;
+
+    double termo2 = d[0] + d[1]*Tk + d[2]*Tk*Tk + d[3]*Tk*Tk*Tk +
+      d[4]*pow(Tk,4) + d[5]*pow(Tk,5) + hv;
+
+    // Clculo do volume molar
+    double Vm = m.vM_v_(Tk, err);
+
+    double termo3 = (B - Tk*dB)/Vm + (C - 0.5*Tk*dC)/(Vm*Vm);
+
+    double hm =  termo2 * 1000.0 + R*Tk*termo3;
+
+    return hm/Mv;
+  }
+
+  static double h_s_(const Model &m, double Tk){
+    return AshraeCorrelations::hs(Tk, m.Pws(Tk));
+  }
+
+  static double h_l_(const Model &m, double Tk){
+    return 1000.0 * AshraeCorrelations::hlAlpha(Tk) + Tk * (m.v_l_(Tk) * m.dPws(Tk) - m.hlRef());
+  }
+
+  static double hlRef(const Model &m){
+    return m.v_l_(273.15) * m.dPws(273.15);
+  }
+
+  static double dh_f_(const Model &m, double Tk){
+    if (Tk < 273.15) return AshraeCorrelations::dhs(Tk, m.dPws(Tk));
+
+    double dalfa;
+    AshraeCorrelations::hlAlpha(Tk, &dalfa);
+    return 1000.0 * dalfa;
+  }
+
+  static double h_f_(const Model &m, double Tk){
+    if (Tk < 273.15)
+      return m.h_s_(Tk);
+    else
+      return m.h_l_(Tk);
+  }
+
+  static double h_(const Model &m, double Tk, double P, double xv, int *err){
+    double  xa = 1.0 - xv;
+
+    return hM_(m, Tk, P, xv, 0, 0, err)/(xa * Ma + xv*Mv);
+  }
+  ///@}
+
+
+  /// PwsT e fT, se PwsT no for nulo, so a presso de saturao em T e o enhancement factor em T e P j calculados, e errT o cdigo de erro de fT (ver grid)
+  static MoistAirState state(const Model &m, double T, char ch, double umidade, double P,
+			     SolverContext *c=0, double PwsT=0, double fT=0, int errT=0){
+    double B, Rel, D, XSV, Pws = 0;
+    // Enhancement factor: parte do valor da amostra anterior, se houver
+    double f0 = (c && c->eFactor && c->near(T, P)) ? c->eFactor : 1.0, f = 0;
+    SaturationPoint sp;
+    MoistAirState s;
+    s.T = T;
+    s.P = P;
+    s.xv = 0.0;
+    s.W = 0.0;
+
+    // Verificar faixa de temperatura e presso
+    s.status = m.FaixaT(T);
+    if (!s.status) s.status = m.FaixaP(P);
+
+    // Saturao na temperatura T
+    if (ch == 'X' || ch == 'W' || ch == 'R'){
+      if (PwsT){
+	Pws = PwsT;
+	f = fT;
+	if (errT) s.status = errT;
+      }
+      else{
+	sp = m.saturation(T);
+	Pws = sp.Pws;
+	f = m.eFactor(sp, P, f0, &s.status);
+      }
+    }
+
+    switch(ch){
+    case 'X':			// Frao molar de vapor
+      s.xv = umidade;
+      XSV = f * Pws / P;
+      if (s.xv < 0.0 || s.xv > XSV) {
+        s.status = 16;
+      }
+      s.W = Mv/Ma * s.xv/(1.0 - s.xv);
+      break;
+    case 'W':			// Teor de umidade
+      s.W = umidade;
+      s.xv = s.W / (Mv/Ma + s.W);
+      XSV = f * Pws / P;
+      if (s.xv < 0.0 || s.xv > XSV) {
+        s.status = 15;
+      }
+      break;
+    case 'R':			// UMidade relativa
+      Rel = umidade;
+      if (Rel < 0.0){
+        s.status = 12; Rel = 0.0;
+      }
+      s.xv = Rel * f * Pws / P;
+      s.W = Mv/Ma * s.xv/(1.0 - s.xv);
+      break;
+
+    case 'B':			// Temp. de bulbo mido
+      // A aproximao linear facilita mesmo estes clculos...
+
+      B = umidade;
+      if (B > T){
+        s.status = 14; B = T;
+      }
+      s.W = CalcWfromB(m, T,B,P, &s.status);	
+      s.xv = s.W / (Mv/Ma + s.W);
+      break;
+    case 'D':			// Ponto de orvalho
+      D = umidade;
+      if (D > T){
+        s.status = 13; D = T;
+      }
+      sp = m.saturation(D);
+      f = m.eFactor(sp, P, f0, &s.status);
+      s.xv = f * sp.Pws/P;
+      s.W = Mv/Ma * s.xv/(1.0 - s.xv);
+      break;
+
+    };
+
+    if (c){
+      c->update(s);
+      if (f) c->eFactor = f;
+    }
+    return s;
+  }
+
+  static double hM_(const Model &m, double Tk, double P, double xv, double *dhdx, double *dhdT, int *err){
+    VirialSet v = m.virial(Tk);
+    double Vm = m.vM_(Tk, P, xv, err);
+    return hM_(m, v, Vm, Tk, P, xv, dhdx, dhdT);
+  }
+
+  /// hM_ com os coeficientes viriais v e o volume molar Vm j calculados
+  static double hM_(const Model &, const VirialSet &v, double Vm, double Tk, double P, double xv,
+		    double *dhdx, double *dhdT){
+    double  xa = 1.0 - xv;
+
+    double a[] = {0.63290874e1,
+           0.28709015e2,
+           0.26431805e-2,
+           -0.10405863e-4,
+           0.18660410e-7,
+		-0.9784331e-11};
+    double d[] = {-0.5008e-2,
+           0.32491829e2,
+           0.65576345e-2,
+           -0.26442147e-4,
+           0.51751789e-7,
+		-0.31541624e-10};
+
+    // Clculo dos coeficientes
+    double B = v.Bm(xv);
+    double C = v.Cm(xv);
+
+    double dB = v.dBm(xv);
+    double dC = v.dCm(xv);
+
+    double ha = -7914.1982;
+    double hv = 35994.17;
+
+    double termo1 = a[0] + a[1]*Tk + a[2]*Tk*Tk + a[3]*Tk*Tk*Tk +
+      a[4]*Tk*Tk*Tk*Tk + a[5]*pow(Tk, 5) + ha;
+
+    double termo2 = d[0] + d[1]*Tk + d[2]*Tk*Tk + d[3]*Tk*Tk*Tk +
+      d[4]*pow(Tk,4) + d[5]*pow(Tk,5) + hv;
+
+    double g1 = B - Tk*dB;
+    double g2 = C - 0.5*Tk*dC;
+    double termo3 = g1/Vm + g2/(Vm*Vm);
+
+    if (dhdx){
+      // Derivadas dos coeficientes da mistura em relao a xv
+      double Bx = 2*(-xa*v.Baa + (xa - xv)*v.Baw + xv*v.Bww);
+      double dBx = 2*(-xa*v.dBaa + (xa - xv)*v.dBaw + xv*v.dBww);
+      double Cx = 3*(-xa*xa*v.Caaa + (xa*xa - 2*xa*xv)*v.Caaw +
+		   (2*xa*xv - xv*xv)*v.Caww + xv*xv*v.Cwww);
+      double dCx = 3*(-xa*xa*v.dCaaa + (xa*xa - 2*xa*xv)*v.dCaaw +
+		    (2*xa*xv - xv*xv)*v.dCaww + xv*xv*v.dCwww);
+      // Variao do volume molar: derivada implcita da equao virial
+      double aa = R*Tk/P;
+      double Vx = aa*(Bx*Vm + Cx) / (3*Vm*Vm - 2*aa*Vm - aa*B);
+      double dtermo3 = (Bx - Tk*dBx)/Vm + (Cx - 0.5*Tk*dCx)/(Vm*Vm) -
+        (g1/(Vm*Vm) + 2*g2/(Vm*Vm*Vm)) * Vx;
+      *dhdx = (termo2 - termo1) * 1000.0 + R*Tk*dtermo3;
+    }
+
+    if (dhdT){
+      double dtermo1 = a[1] + 2*a[2]*Tk + 3*a[3]*Tk*Tk + 4*a[4]*Tk*Tk*Tk + 5*a[5]*pow(Tk,4);
+      double dtermo2 = d[1] + 2*d[2]*Tk + 3*d[3]*Tk*Tk + 4*d[4]*Tk*Tk*Tk + 5*d[5]*pow(Tk,4);
+      *dhdT = xa * dtermo1 * 1000.0 + xv * dtermo2 * 1000.0 + R*termo3;
+    }
+
+    return xa * termo1 * 1000.0 + xv * termo2 * 1000.0 + R*Tk*termo3;
+  }
+
+  static double hw_(const Model &m, double Tk, double P, double w, double *dHdw, double *dHdT, int *err){
+    // Nmero de kmols de mistura por kg de ar seco
+    double n = 1.0/Ma + w/Mv;
+    double xv = w / Mv / n;
+    double dhdx, dhdT;
+    double hm = hM_(m, Tk, P, xv, dHdw ? &dhdx : 0, dHdT ? &dhdT : 0, err);
+
+    if (dHdw) *dHdw = hm/Mv + dhdx / (Ma*Mv*n);
+    if (dHdT) *dHdT = n * dhdT;
+
+    return n * hm;
+  }
+
+  static double AuxWB(const Model &m, double w, double T, double B, double P, int *err){
+    return AuxWB(m, w, T, m.saturation(B), P, err);
+  }
+
+  static double AuxWB(const Model &m, double w, double T, const SaturationPoint &sb, double P, int *err){
+    double B = sb.T;
+    double xv1, xv2, w2;
+
+    xv1 = w / (Mv/Ma + w);
+    xv2 = m.eFactor(sb, P, err) * sb.Pws / P;
+
+    w2 = Mv / Ma * xv2 / (1 - xv2);
+
+    return (1.0 + w)*m.h_(T, P, xv1, err) + (w2 - w) * m.h_f_(B) - (1.0 + w2) * m.h_(B,P,xv2, err);
+  }
+
+  static double CalcWfromB(const Model &m, double T, double B, double P, int *err){
+    // Esta funo calcula o teor de umidade dado T, B(TBU) e P
+
+    // Caso fosse mistura de gases ideais, seria muito simples. Mas neste caso temos que
+    // iterar. Mas usaremos o dado de TBU de gs perfeito como dado inicial.
+
+    double w, w2, xsv;
+    const double EPS = m.tol.W;
+    const int NMAX = 100;
+    double f, df, dw;
+
+    SaturationPoint sb = m.saturation(B);
+    xsv = m.eFactor(sb, P, err) * sb.Pws / P;
+    w2 = Mv / Ma * xsv / (1 - xsv);
+
+    // Sada do saturador: no depende de w
+    double hf = m.h_f_(B);
+    double H2 = hw_(m, B, P, w2, 0, 0, err);
+
+    if (m.perfectGasSeed){
+      w = seedW(m.seedModel(), T, B, w2);
+    }
+    else
+      w = ( m.h_a_(B, 101325.0, err) - m.h_a_(T, 101325.0, err) - w2 * hf + w2 * m.h_v_(B, err) ) / ( m.h_v_(T, err) - hf );
+    // Agora com este valor inicial, iterar at conseguir chegar
+    for (int iter = 0; iter < NMAX; ++iter){
+      double dH;
+      f = hw_(m, T, P, w, &dH, 0, err) + (w2 - w) * hf - H2;
+      df = dH - hf;
+
+      dw = -f / df;
+      w = w + dw;
+      if (fabs(dw) < EPS*w2) return w;
+    }
+
+    if (err) *err = 103;
+    return w;
+  }
+
+  /// Valor inicial de CalcWfromB: expresso explcita do gs perfeito g (ver GasPerfeito::state) com o w2 do modelo
+  template<class Seed>
+  static double seedW(const Seed &g, double T, double B, double w2){
+    double hfg = g.h_f_(B);
+    return (g.h_a_(B) - g.h_a_(T) + w2 * (g.h_v_(B) - hfg)) / (g.h_v_(T) - hfg);
+  }
+
+  static double ENTHALPY(const Model &m, const MoistAirState &s, int *err){
+    return m.h_(s.T, s.P, s.xv, err) * (1.0 + s.W);
+  }
+
+  static double VOLUME(const Model &m, const MoistAirState &s, int *err){
+    return m.v_(s.T, s.P, s.xv, err) * (1.0 + s.W);
+  }
+
+  static double DENSITY(const Model &m, const MoistAirState &s, int *err){
+    return m.r_(s.T, s.P, s.xv, err);
+  }
+
+  static double DEWPOINT(const Model &m, const MoistAirState &s, int *err, SolverContext *c=0){
+    double P = s.P;
+    double lnPv = log(s.xv * P);
+
+    // Chute inicial: o ponto de orvalho da amostra anterior, se houver, ou o gs perfeito
+    double D;
+    if (c) c->update(s);
+    if (c && c->dewpoint) D = c->dewpoint;
+    else D = m.Tws0(s.xv * P);
+    if (c) c->dewpoint = 0;
+    double f, dD;
+    const double EPS=m.tol.dewpoint;
+    const int NMAX = 100;
+    // Ponto anterior: temperatura, resduo e derivada analtica (correo secante, ver Tolerances)
+    double Da = 0, ga = 0, Ja = 0;
+
+    for (int iter = 0; iter < NMAX; ++iter){
+      if (c) ++c->iterations;
+      // A presso de vapor e sua derivada vm de saturation, uma vez por passo
+      SaturationPoint sp = m.saturation(D);
+      f = m.eFactor(sp, P, err);
+
+      // A derivada analtica no inclui a variao de f com D
+      double g = log(f*sp.Pws) - lnPv;
+      double J = sp.dPws / sp.Pws;
+      bool sec = iter > 0 && (D < 273.15) == (Da < 273.15);
+      double Js = sec ? (g - ga) / (D - Da) + (J - Ja) / 2 : J;
+      Da = D; ga = g; Ja = J;
+      dD = -g / Js;
+      D += dD;
+      // Temperatura negativa: a iterao divergiu (valor inicial ruim, fora das faixas)
+      if (!(D > 0)){
+	D = NAN;
+	break;
+      }
+      // Com a correo secante a convergncia  quadrtica (ver Tolerances)
+      if (fabs(dD) < EPS || (sec && dD*dD < EPS)){
+	if (c) c->dewpoint = D;
+	return D;
+      }
+    }
+
+    if (err) *err = 105;
+    return D;
+  }
+
+  static double RELHUM(const Model &m, const MoistAirState &s, int *err){
+    SaturationPoint sp = m.saturation(s.T);
+    return s.xv * s.P / (m.eFactor(sp, s.P, err) * sp.Pws);
+  }
+
+  static MoistAirProperties evaluate_all(const Model &m, const MoistAirState &s, unsigned mask){
+    MoistAirCache c;
+    return evaluate(m, c, s, mask);
+  }
+
+  /// vT, se no for nulo, so os coeficientes viriais na temperatura do estado j calculados (ver grid)
+  static const MoistAirProperties &evaluate(const Model &m, MoistAirCache &c, const MoistAirState &s,
+					    unsigned mask, const VirialSet *vT=0){
+    c.update(s);
+    MoistAirProperties &r = c.props;
+    int *err = &r.status;
+    unsigned n = c.need(mask & PROP_ALL);
+    double Mm = (1.0-s.xv)*Ma + s.xv * Mv;
+
+    // Volume molar: compartilhado pela massa especfica, volume, entalpia e bulbo mido
+    if (n & (PROP_DENSITY | PROP_VOLUME | PROP_ENTHALPY | PROP_WETBULB))
+      if (c.need(MoistAirCache::VOLM))
+	c.vM = vT ? m.vMfromVirial(*vT, s.T, s.P, s.xv, err) : m.vM_(s.T, s.P, s.xv, err);
+    if (n & PROP_DENSITY) r.density = 1.0/(c.vM / Mm);
+    if (n & PROP_VOLUME) r.volume = c.vM / Mm * (1.0 + s.W);
+
+    // Entalpia molar: compartilhada pela entalpia e pela entrada do saturador no bulbo mido
+    if (n & (PROP_ENTHALPY | PROP_WETBULB))
+      if (c.need(MoistAirCache::HM)) c.hM = hM_(m, vT ? *vT : m.virial(s.T), c.vM, s.T, s.P, s.xv, 0, 0);
+    if (n & PROP_ENTHALPY) r.enthalpy = c.hM/Mm * (1.0 + s.W);
+
+    if (n & PROP_RELHUM){
+      if (c.need(MoistAirCache::PWS | MoistAirCache::EFACTOR)){
+	SaturationPoint sp = m.saturation(s.T);
+	c.Pws = sp.Pws;
+	c.f = m.eFactor(sp, s.P, err);
+      }
+      r.relhum = s.xv * s.P / (c.f * c.Pws);
+    }
+    if (n & PROP_DEWPOINT) r.dewpoint = DEWPOINT(m, s, err);
+    if (n & PROP_WETBULB){
+      double H1 = (1.0/Ma + s.W/Mv) * c.hM;
+      r.wetbulb = WETBULB(m, s, err, 0, &H1);
+    }
+    return r;
+  }
+
+  /// states, se no for nulo, so os estados dos nP*nU pontos j calculados
+  static void grid(const Model &m, double T, size_t nP, const double *P, char ch, size_t nU,
+		   const double *umidade, const MoistAirColumns &out, const MoistAirState *states=0){
+    unsigned mask = 0;
+    if (out.density) mask |= PROP_DENSITY;
+    if (out.volume) mask |= PROP_VOLUME;
+    if (out.enthalpy) mask |= PROP_ENTHALPY;
+    if (out.relhum) mask |= PROP_RELHUM;
+    if (out.dewpoint) mask |= PROP_DEWPOINT;
+    if (out.wetbulb) mask |= PROP_WETBULB;
+
+    // Termos que dependem apenas de T: presso de vapor, fase condensada, constante de Henry e coeficientes viriais
+    SaturationPoint sp = m.saturation(T);
+    MoistAirCache c;
+
+    for (size_t j = 0; j < nP; ++j){
+      // Enhancement factor: depende apenas de T e P
+      int ef = 0;
+      double f = m.eFactor(sp, P[j], &ef);
+      for (size_t k = 0; k < nU; ++k){
+	size_t i = j*nU + k;
+	MoistAirState s = states ? states[i] : state(m, T, ch, umidade[k], P[j], 0, sp.Pws, f, ef);
+	c.update(s);
+	c.Pws = sp.Pws;
+	c.f = f;
+	// Se f no convergiu, a umidade relativa o recalcula para registrar o cdigo de erro na mesma ordem de evaluate
+	c.valid |= ef ? MoistAirCache::PWS : MoistAirCache::PWS | MoistAirCache::EFACTOR;
+	const MoistAirProperties &r = evaluate(m, c, s, mask, &sp.v);
+
+	if (out.W) out.W[i] = s.W;
+	if (out.xv) out.xv[i] = s.xv;
+	if (out.density) out.density[i] = r.density;
+	if (out.volume) out.volume[i] = r.volume;
+	if (out.enthalpy) out.enthalpy[i] = r.enthalpy;
+	if (out.relhum) out.relhum[i] = r.relhum;
+	if (out.dewpoint) out.dewpoint[i] = r.dewpoint;
+	if (out.wetbulb) out.wetbulb[i] = r.wetbulb;
+	if (out.status) out.status[i] = r.status;
+      }
+    }
+  }
+
+  static double WETBULB(const Model &m, const MoistAirState &s, int *err, SolverContext *c=0,
+			const double *H1s=0){
+    // Esta funo calcula a temperatura de bulbo mido
+    // Este aqui necessariamente tem que ser iterativo. CHute inicial TBS-1 ou o bulbo mido da amostra anterior
+    double T = s.T;
+    double P = s.P;
+
+    double B = T - 1.0, B0 = 0;
+    if (c){
+      c->update(s);
+      B0 = c->wetbulb;
+      c->wetbulb = 0;
+    }
+    if (!B0 && m.perfectGasSeed){
+      // Bulbo mido do gs perfeito (ver Ashrae::perfectGasSeed)
+      int e = 0;
+      B0 = m.seedModel().WETBULB(s, &e);
+      if (e) B0 = 0;
+    }
+    // Perto de 273.15 a equao tem uma raiz no gelo e outra na gua: a estimativa s 
+    // utilizada se estiver do mesmo lado que T - 1, para que a raiz encontrada seja a mesma
+    if (B0 && (B0 < 273.15) == (B < 273.15)) B = (B0 < T) ? B0 : T;
+    double f, df, w=s.W, dB;
+    const double EPS=m.tol.wetbulb;
+    const int NMAX = 400;
+
+    // Entrada do saturador (H1s, se j tiver sido calculada)
+    double H1 = H1s ? *H1s : hw_(m, T, P, w, 0, 0, err);
+    // A presso de vapor e sua derivada so calculadas uma vez por passo, em saturation
+    const double ref = m.hlRef();
+    // Ponto anterior: temperatura, resduo e derivada analtica (correo secante, ver Tolerances)
+    double Ba = 0, fa = 0, dfa = 0;
+
+    for (int iter = 0; iter < NMAX; ++iter){
+      if (c) ++c->iterations;
+      SaturationPoint sb = m.saturation(B);
+      double ef = m.eFactor(sb, P, err);
+      double xsv = ef * sb.Pws / P;
+      double w2 = Mv / Ma * xsv / (1 - xsv);
+      double dw2 = Mv / Ma * ef * sb.dPws / P / ((1 - xsv)*(1 - xsv));
+      double dhf;
+      double hf = m.hfSat(sb, ref, &dhf);
+      double dH2dw, dH2dT;
+      double H2 = hw_(m, B, P, w2, &dH2dw, &dH2dT, err);
+
+      f = H1 + (w2 - w) * hf - H2;
+      df = dw2 * hf + (w2 - w) * dhf - dH2dT - dH2dw * dw2;
+      bool sec = iter > 0 && (B < 273.15) == (Ba < 273.15);
+      double dfs = sec ? (f - fa) / (B - Ba) + (df - dfa) / 2 : df;
+      Ba = B; fa = f; dfa = df;
+      dB = -f / dfs;
+      B = B + dB;
+      // Um passo que atravessa 273.15 no indica convergncia: a entalpia da fase condensada  descontnua.
+      // Com a correo secante a convergncia  quadrtica (ver Tolerances)
+      if ((fabs(dB) < EPS || (sec && dB*dB < EPS)) && (B < 273.15) == (B - dB < 273.15)){
+	if (c) c->wetbulb = B;
+	return B;
+      }
+    }
+
+    if (err) *err = 100;
+    return B;
+  }
+};
+
+#endif
@@ -0,0 +1,390 @@
+/*! \file ashrae_lanes.h
+
+\brief Algoritmos vetoriais do modelo da ASHRAE em simples preciso
+
+Implementao do clculo em lote em float (ver Psychro::batchFloat) como funes estticas de Ashrae::LaneKernel<Model>: os estados, as propriedades explcitas, o ponto de orvalho e o bulbo mido de vtraits<V>::L amostras so calculados juntos, com as correlaes de correlations.h e as polticas do modelo esttico Model (ver models.h) avaliadas em vetores float. Os algoritmos so os de Ashrae::Kernel (ver ashrae_kernel.h) e das verses vetoriais em double de ashrae.cpp. Contm tambm a soluo vetorial da equao virial, vMvirialLanes, utilizada pelas duas precises.
+*/
+
+#ifndef _ashrae_lanes_h
+#define _ashrae_lanes_h
+
+#include <limits>
+
+#include "correlations.h"
+
+#if defined(__GNUC__)
+// Funes que retornam vetores de vecmath.h (ver o aviso de mudana de ABI em vecmath.h)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+
+
+/*! Soluo da equao virial (ver Ashrae::vMvirial) para vtraits<V>::L estados simultaneamente. As iteraes continuam at que todos os elementos tenham convergido; os que j convergiram ficam congelados.
+\param method Mtodo de soluo
+\param fail Recebe a mscara dos elementos que no convergiram em NMAX iteraes
+*/
+template<class V>
+V vMvirialLanes(Ashrae::VirialMethod method, const V &Tk, const V &P, const V &B,
+		const V &C, int NMAX, typename vscalar<V>::type EPS, typename vtraits<V>::mask &fail){
+  typedef typename vtraits<V>::mask M;
+  const typename vscalar<V>::type R = Psychro::R;
+  V vm = R*Tk/P;
+  V vmn = vm, res = vm;
+  M active = vnot(M());
+
+  if (method == Ashrae::VIRIAL_HALLEY){
+    V a = vm;
+    V f, df, d2f;
+    vmn = a + B;
+    for (int k = 0; k < 2; ++k){
+      f = ((vmn - a)*vmn - a*B)*vmn - a*C;
+      df = (3*vmn - 2*a)*vmn - a*B;
+      d2f = 6*vmn - 2*a;
+      vmn -= 2*f*df / (2*df*df - f*d2f);
+    }
+    res = vmn;
+    active = vnot((M)(vmn > 0.0));
+  }
+
+  for (int iter = 0; iter < NMAX && vany(active); ++iter){
+    vmn = R*Tk/P * (1 + B/vm + C/(vm*vm));
+    M conv = (M)(vfabs(vmn - vm) < EPS*vmn);
+    vm = vmn;
+    res = vselect(active, vm, res);
+    active = active & vnot(conv);
+  }
+  fail = active;
+  return res;
+}
+
+
+/*! \brief Grandezas de saturao de vtraits<V>::L temperaturas (ver Ashrae::SaturationPoint)
+ */
+template<class V>
+struct SaturationLanes{
+  /// Temperatura K
+  V T;
+  /// Presso de vapor Pa e sua derivada Pa/K
+  V Pws, dPws;
+  /// Volume molar da fase condensada \f$m^3/kmol\f$
+  V vc;
+  /// Compressibilidade isotrmica da fase condensada 1/Pa
+  V kappa;
+  /// Constante de Henry do ar 1/Pa (nula no gelo)
+  V k;
+  /// Coeficientes viriais e derivadas, na ordem de AshraeCorrelations::virial
+  V c[14];
+};
+
+
+/*! \brief Clculo em lote do modelo Model em vetores float (ver Ashrae::batchFloat)
+
+As iteraes so as de Ashrae::Kernel, com as seguintes diferenas:
+
+- As tolerncias de Tolerances so limitadas  resoluo do float: 1000 psilons (\f$1.2\times 10^{-4}\f$ K) no ponto de orvalho e no bulbo mido e \f$1.2\times 10^{-4}\f$ relativo no teor de umidade de CalcWfromB, e 8 psilons (\f$9.5\times 10^{-7}\f$) no enhancement factor e no volume molar. Com a correo secante (ver Tolerances) o erro depois do ltimo passo  muito menor que a tolerncia; o resultado  limitado pelo arredondamento dos resduos.
+- Os valores iniciais so sempre explcitos: tws0 no ponto de orvalho, o bulbo mido do gs perfeito (GasPerfeitoCorrelations::wetbulbLanes, com perfectGasSeed) ou T - 1 no bulbo mido e a expresso do gs perfeito em CalcWfromB. As tabelas do modo rpido no so utilizadas.
+- Uma amostra  marcada para o clculo em double (refine) se alguma iterao no convergiu, se algum resultado  NaN, se a umidade relativa de uma entrada 'W' ou 'X' est a menos de \f$10^{-5}\f$ da saturao (o cdigo 15 ou 16 depende do arredondamento), se \f$x_v > 0.5\f$ (W amplifica o erro de \f$x_v\f$ por \f$1/(1 - x_v)\f$), se o teor de umidade dado o bulbo mido  menor que \f$10^{-4}\f$ ou que um dcimo do teor de saturao no bulbo mido (diferena de termos muito maiores que o resultado), se o ponto de orvalho est a menos de 0.05 K de 273.15, se o bulbo mido B est acima de T ou a menos de \f$0.1(T-B) + 0.05\f$ K de 273.15. Perto de 273.15 a presso de vapor e a entalpia da fase condensada mudam de correlao: o resduo  descontnuo e pode ter uma raiz de cada lado (o salto de \f$h_f\f$, 334 kJ/kg vezes \f$\omega' - \omega\f$, corresponde a cerca de \f$0.075(T-B)\f$ K no bulbo mido), e a raiz encontrada depende do caminho da iterao.
+*/
+template<class Model>
+struct Ashrae::LaneKernel{
+  /// Tolerncia tol limitada a n psilons do tipo S
+  template<class S>
+  static S tolerance(double tol, int n){
+    S e = n * std::numeric_limits<S>::epsilon();
+    return (tol > e) ? S(tol) : e;
+  }
+
+  /// Grandezas de saturao (ver Ashrae::saturation)
+  template<class V>
+  static SaturationLanes<V> saturation(const Model &m, const V &Tk){
+    typedef typename vscalar<V>::type S;
+    SaturationLanes<V> sp;
+    sp.T = Tk;
+    sp.Pws = m.PwsdPwsLanes(Tk, sp.dPws);
+    sp.vc = GasPerfeitoCorrelations::v_f(Tk) * S(Mv);
+    sp.kappa = AshraeCorrelations::kappa_f(Tk);
+    sp.k = AshraeCorrelations::henrykSat(Tk);
+    AshraeCorrelations::virial(Tk, sp.c);
+    return sp;
+  }
+
+  /*! Entalpia por kg de ar seco e derivadas (ver Ashrae::hw_) com os coeficientes viriais c em Tk
+  \param fail Recebe a mscara dos elementos em que a equao virial no convergiu
+  */
+  template<class V>
+  static V hw(const Model &m, const V &Tk, const V &P, const V &w, const V c[14],
+	      typename vscalar<V>::type epsV, typename vtraits<V>::mask &fail,
+	      V *dHdw=0, V *dHdT=0){
+    typedef typename vscalar<V>::type S;
+    // Nmero de kmols de mistura por kg de ar seco
+    V n = S(1.0/Ma) + w/S(Mv);
+    V xv = w / S(Mv) / n;
+    V Vm = m.vMLanes(Tk, P, xv, c, epsV, fail);
+    V dhdx, dhdT;
+    V hm = AshraeCorrelations::hM(Tk, P, xv, c, Vm, dHdw ? &dhdx : 0, dHdT ? &dhdT : 0);
+    if (dHdw) *dHdw = hm/S(Mv) + dhdx / (S(Ma*Mv)*n);
+    if (dHdT) *dHdT = n * dhdT;
+    return n * hm;
+  }
+
+  /*! Teor de umidade dada a temperatura de bulbo mido Bk (ver Ashrae::CalcWfromB)
+  \param cT Coeficientes viriais em Tk
+  \param fail Recebe a mscara dos elementos que devem ser calculados em double
+  */
+  template<class V>
+  static V CalcWfromB(const Model &m, const V &Tk, const V &Bk, const V &Pk, const V cT[14],
+		      typename vscalar<V>::type beta0, typename vtraits<V>::mask &fail){
+    typedef typename vscalar<V>::type S;
+    typedef typename vtraits<V>::mask M;
+    const S EPS = tolerance<S>(m.tol.W, 1000);
+    const S epsF = tolerance<S>(m.tol.eFactor, 8), epsV = tolerance<S>(m.tol.volume, 8);
+    const int NMAX = 100;
+    M fe, fz, fw = M();
+
+    SaturationLanes<V> sb = saturation(m, Bk);
+    V xsv = m.eFactorLanes(sb, Pk, epsF, fe) * sb.Pws / Pk;
+    V w2 = S(Mv/Ma) * xsv / (1 - xsv);
+
+    // Sada do saturador: no depende de w
+    V hf = AshraeCorrelations::hf(Bk, sb.Pws, sb.dPws, sb.vc / S(Mv), beta0, (V *) 0);
+    V H2 = hw(m, Bk, Pk, w2, sb.c, epsV, fz);
+
+    // Valor inicial: expresso explcita do gs perfeito com o w2 do modelo (ver Kernel::seedW)
+    typedef GasPerfeitoCorrelations G;
+    V hfg = vselect((M)(Bk < tgelo<S>()), G::h_s(Bk), G::h_w(Bk));
+    V wk = (G::h_a(Bk) - G::h_a(Tk) + w2 * (G::h_v(Bk) - hfg)) / (G::h_v(Tk) - hfg);
+
+    M active = vnot(M()), nan = M();
+    for (int iter = 0; iter < NMAX && vany(active); ++iter){
+      V dH;
+      M f;
+      V F = hw(m, Tk, Pk, wk, cT, epsV, f, &dH) + (w2 - wk) * hf - H2;
+      fw = fw | f;
+      V dw = -F / (dH - hf);
+      wk = vselect(active, wk + dw, wk);
+      active = active & vnot((M)(vfabs(dw) < EPS*w2));
+      nan = nan | (active & vnot((M)(wk == wk)));
+      active = active & vnot(nan);
+    }
+    // Longe da saturao w  a diferena de termos da ordem de w2 e herda o erro relativo de w2 amplificado
+    // por w2/w; o arredondamento das entalpias (da ordem de 0.01 J/kg) limita w a cerca de 1e-8 em valor absoluto
+    fail = active | nan | fe | fz | fw | vnot((M)(wk >= S(0.1)*w2) & (M)(wk >= S(1e-4)));
+    return wk;
+  }
+
+  /*! Temperatura de ponto de orvalho (ver Ashrae::DEWPOINTBatch)
+  \param fail Recebe a mscara dos elementos que devem ser calculados em double
+  */
+  template<class V>
+  static V DEWPOINT(const Model &m, const V &Pk, const V &x, typename vtraits<V>::mask &fail){
+    typedef typename vscalar<V>::type S;
+    typedef typename vtraits<V>::mask M;
+    const S EPS = tolerance<S>(m.tol.dewpoint, 1000), epsF = tolerance<S>(m.tol.eFactor, 8);
+    const S tg = tgelo<S>();
+    const int NMAX = 100;
+
+    // vlog no aceita valores nulos ou negativos: estes elementos no so iterados
+    V Pv = x * Pk;
+    M invalido = vnot((M)(Pv > 0.0));
+    Pv = vselect(invalido, vset<V>(1000.0), Pv);
+    V lnPv = vlog(Pv);
+
+    V Dv = AshraeCorrelations::tws0(Pv);
+    // Ponto anterior: temperatura, resduo e derivada analtica (correo secante, ver Kernel::DEWPOINT)
+    V Da = Dv, ga = vset<V>(0.0), Ja = ga;
+    M active = vnot(invalido), nan = M(), primeiro = vnot(M()), fe = M();
+    for (int iter = 0; iter < NMAX && vany(active); ++iter){
+      SaturationLanes<V> sp = saturation(m, Dv);
+      M f;
+      V ef = m.eFactorLanes(sp, Pk, epsF, f);
+      fe = fe | (f & active);
+      V g = vlog(ef*sp.Pws) - lnPv;
+      V J = sp.dPws / sp.Pws;
+      M sec = vnot(primeiro) & vnot((M)(Dv < tg) ^ (M)(Da < tg));
+      V dD = -g / vselect(sec, (g - ga) / (Dv - Da) + (J - Ja) / 2, J);
+      Da = Dv; ga = g; Ja = J;
+      primeiro = M();
+      Dv = vselect(active, Dv + dD, Dv);
+      active = active & vnot((M)(vfabs(dD) < EPS) | (sec & (M)(dD*dD < EPS)));
+      nan = nan | (active & vnot((M)(Dv > 0.0)));
+      active = active & vnot(nan);
+    }
+    fail = active | invalido | nan | fe | (M)(vfabs(Dv - tg) < S(0.05));
+    return Dv;
+  }
+
+  /*! Temperatura de bulbo mido (ver Ashrae::WETBULBBatch)
+  \param H1 Entalpia da entrada do saturador J/kg de ar seco
+  \param fail Recebe a mscara dos elementos que devem ser calculados em double
+  */
+  template<class V>
+  static V WETBULB(const Model &m, const V &Tk, const V &Pk, const V &wk, const V &H1,
+		   typename vscalar<V>::type beta0, typename vtraits<V>::mask &fail){
+    typedef typename vscalar<V>::type S;
+    typedef typename vtraits<V>::mask M;
+    const S EPS = tolerance<S>(m.tol.wetbulb, 1000);
+    const S epsF = tolerance<S>(m.tol.eFactor, 8), epsV = tolerance<S>(m.tol.volume, 8);
+    const S tg = tgelo<S>();
+    const int NMAX = 400;
+
+    V Bv = Tk - 1.0;
+    if (m.perfectGasSeed){
+      // Valor inicial: bulbo mido do gs perfeito, se estiver do mesmo lado de 273.15 que T - 1 (ver Ashrae::WETBULBBatch)
+      M fg;
+      V Bg = GasPerfeitoCorrelations::wetbulbLanes(Tk, Pk, wk, tolerance<S>(m.seedModel().tol.wetbulb, 1000), fg);
+      M usa = vnot(fg) & (M)(Bg <= Tk) & vnot((M)(Bg < tg) ^ (M)(Bv < tg));
+      Bv = vselect(usa, Bg, Bv);
+    }
+    // Ponto anterior: temperatura, resduo e derivada analtica (correo secante, ver Kernel::WETBULB)
+    V Ba = Bv, Fa = vset<V>(0.0), dFa = Fa;
+    M active = vnot(M()), nan = M(), primeiro = vnot(M()), fe = M();
+    for (int iter = 0; iter < NMAX && vany(active); ++iter){
+      SaturationLanes<V> sb = saturation(m, Bv);
+      M f, fz;
+      V ef = m.eFactorLanes(sb, Pk, epsF, f);
+      V xsv = ef * sb.Pws / Pk;
+      V w2 = S(Mv/Ma) * xsv / (1 - xsv);
+      V dw2 = S(Mv/Ma) * ef * sb.dPws / Pk / ((1 - xsv)*(1 - xsv));
+      V dhf;
+      V hf = AshraeCorrelations::hf(Bv, sb.Pws, sb.dPws, sb.vc / S(Mv), beta0, &dhf);
+      V dH2dw, dH2dT;
+      V H2 = hw(m, Bv, Pk, w2, sb.c, epsV, fz, &dH2dw, &dH2dT);
+      fe = fe | ((f | fz) & active);
+
+      V F = H1 + (w2 - wk) * hf - H2;
+      V dF = dw2 * hf + (w2 - wk) * dhf - dH2dT - dH2dw * dw2;
+      M sec = vnot(primeiro) & vnot((M)(Bv < tg) ^ (M)(Ba < tg));
+      V dB = -F / vselect(sec, (F - Fa) / (Bv - Ba) + (dF - dFa) / 2, dF);
+      Ba = Bv; Fa = F; dFa = dF;
+      primeiro = M();
+      V Bn = Bv + dB;
+      // Um passo que atravessa 273.15 no indica convergncia: a entalpia da fase condensada  descontnua
+      M cruza = (M)(Bn < tg) ^ (M)(Bv < tg);
+      Bv = vselect(active, Bn, Bv);
+      active = active & vnot(((M)(vfabs(dB) < EPS) | (sec & (M)(dB*dB < EPS))) & vnot(cruza));
+      nan = nan | (active & vnot((M)(Bv == Bv)));
+      active = active & vnot(nan);
+    }
+    // Um resultado acima de T  uma raiz espria (a iterao divergiu)
+    fail = active | nan | fe | vnot((M)(Bv <= Tk)) | (M)(vfabs(Bv - tg) < S(0.1)*(Tk - Bv) + S(0.05));
+    return Bv;
+  }
+
+  /*! Clculo em lote de n amostras com o vetor V de elementos float (ver Ashrae::batchFloat). Preenche as colunas no nulas de out; out.status no pode ser nulo e recebe o cdigo de 12 a 16 de state ou 0 (os cdigos de faixa so verificados por quem chama).
+  \param refine refine[i] recebe 1 se a amostra i deve ser calculada em double e 0 caso contrrio
+  */
+  template<class V>
+  static void batch(const Model &m, size_t n, char ch, const float *T, const float *umidade,
+		    const float *P, const MoistAirColumnsF &out, char *refine){
+    typedef typename vscalar<V>::type S;
+    typedef typename vtraits<V>::mask M;
+    const size_t L = vtraits<V>::L;
+    const S epsF = tolerance<S>(m.tol.eFactor, 8), epsV = tolerance<S>(m.tol.volume, 8);
+    const S beta0 = m.hlRef();
+    const int codigo = (ch == 'R') ? 12 : (ch == 'D') ? 13 : (ch == 'B') ? 14 : (ch == 'W') ? 15 : 16;
+    const bool props = out.density || out.volume || out.enthalpy || out.wetbulb;
+
+    for (size_t i = 0; i < n; i += L){
+      size_t k = (n - i < L) ? n - i : L;
+      V Tk = (k == L) ? vload<V>(T+i) : vload_tail<V>(T+i, k);
+      V u = (k == L) ? vload<V>(umidade+i) : vload_tail<V>(umidade+i, k);
+      V Pk = (k == L) ? vload<V>(P+i) : vload_tail<V>(P+i, k);
+
+      // Estado (ver Kernel::state). A saturao em T  utilizada pelo estado e pela umidade relativa
+      SaturationLanes<V> sT = SaturationLanes<V>();
+      V fT = vset<V>(0.0), xv, W;
+      M fail = M(), bad, f;
+      bool satT = ch == 'X' || ch == 'W' || ch == 'R' || out.relhum;
+      if (satT){
+	sT = saturation(m, Tk);
+	fT = m.eFactorLanes(sT, Pk, epsF, f);
+	fail = fail | f;
+      }
+      else AshraeCorrelations::virial(Tk, sT.c);
+
+      V XSV = fT * sT.Pws / Pk;
+      switch(ch){
+      case 'X':
+	xv = u;
+	bad = (M)(xv < 0.0) | (M)(xv > XSV);
+	W = S(Mv/Ma) * xv/(1.0 - xv);
+	break;
+      case 'W':
+	W = u;
+	xv = W / (S(Mv/Ma) + W);
+	bad = (M)(xv < 0.0) | (M)(xv > XSV);
+	break;
+      case 'R':
+	bad = (M)(u < 0.0);
+	xv = vselect(bad, vset<V>(0.0), u) * fT * sT.Pws / Pk;
+	W = S(Mv/Ma) * xv/(1.0 - xv);
+	break;
+      case 'B':{
+	bad = (M)(u > Tk);
+	V Bk = vselect(bad, Tk, u);
+	W = CalcWfromB(m, Tk, Bk, Pk, sT.c, beta0, f);
+	fail = fail | f;
+	xv = W / (S(Mv/Ma) + W);
+	break;
+      }
+      default:{
+	bad = (M)(u > Tk);
+	V Dk = vselect(bad, Tk, u);
+	SaturationLanes<V> sD = saturation(m, Dk);
+	xv = m.eFactorLanes(sD, Pk, epsF, f) * sD.Pws / Pk;
+	fail = fail | f;
+	W = S(Mv/Ma) * xv/(1.0 - xv);
+	break;
+      }
+      }
+      // O cdigo 15 ou 16 de um estado na saturao depende do arredondamento
+      if (ch == 'W' || ch == 'X') fail = fail | (M)(vfabs(xv - XSV) < S(1e-5)*XSV);
+      // W = (Mv/Ma) xv/(1 - xv) amplifica o erro relativo de xv por 1/(1 - xv)
+      fail = fail | (M)(xv > S(0.5));
+
+      // Propriedades explcitas (ver Kernel::evaluate)
+      V Mm = (1.0 - xv)*S(Ma) + xv*S(Mv);
+      V Vm = vset<V>(0.0), hm = Vm;
+      if (props){
+	Vm = m.vMLanes(Tk, Pk, xv, sT.c, epsV, f);
+	fail = fail | f;
+	hm = AshraeCorrelations::hM(Tk, Pk, xv, sT.c, Vm, (V *) 0, (V *) 0);
+      }
+      V r[8];
+      r[0] = W;
+      r[1] = xv;
+      r[2] = 1.0/(Vm / Mm);
+      r[3] = Vm / Mm * (1.0 + W);
+      r[4] = hm / Mm * (1.0 + W);
+      r[5] = xv * Pk / (fT * sT.Pws);
+      r[6] = r[7] = vset<V>(0.0);
+      if (out.dewpoint){
+	r[6] = DEWPOINT(m, Pk, xv, f);
+	fail = fail | f;
+      }
+      if (out.wetbulb){
+	r[7] = WETBULB(m, Tk, Pk, W, (S(1.0/Ma) + W/S(Mv)) * hm, beta0, f);
+	fail = fail | f;
+      }
+
+      float *col[8] = {out.W, out.xv, out.density, out.volume, out.enthalpy, out.relhum,
+		       out.dewpoint, out.wetbulb};
+      for (int c = 0; c < 8; ++c){
+	if (!col[c]) continue;
+	fail = fail | vnot((M)(r[c] == r[c]));
+	if (k == L) vstore(col[c]+i, r[c]);
+	else vstore_tail(col[c]+i, r[c], k);
+      }
+      for (size_t j = 0; j < k; ++j){
+	out.status[i+j] = bad[j] ? codigo : 0;
+	refine[i+j] = fail[j] ? 1 : 0;
+      }
+    }
+  }
+};
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+
+#endif
@@ -0,0 +1,132 @@
+/*! \file batch.h
+
+\brief Clculo em lote das propriedades do ar mido
+
+Este arquivo implementa o lao utilizado pelas funes batch dos modelos. As entradas e sadas so colunas (vetores contguos, uma propriedade por vetor), o que facilita a vetorizao e a diviso do trabalho entre threads.
+*/
+
+
+#ifndef _batch_h
+#define _batch_h
+
+
+/*! Calcula as propriedades selecionadas em out da amostra i, cujo estado  s (ver Psychro::evaluate_all)
+ */
+template<class Model>
+inline void batch_outputs(const Model &m, const MoistAirState &s, const MoistAirColumns &out,
+			  size_t i){
+  unsigned mask = 0;
+  if (out.density) mask |= PROP_DENSITY;
+  if (out.volume) mask |= PROP_VOLUME;
+  if (out.enthalpy) mask |= PROP_ENTHALPY;
+  if (out.relhum) mask |= PROP_RELHUM;
+  if (out.dewpoint) mask |= PROP_DEWPOINT;
+  if (out.wetbulb) mask |= PROP_WETBULB;
+  MoistAirProperties r = m.evaluate_all(s, mask);
+
+  if (out.W) out.W[i] = s.W;
+  if (out.xv) out.xv[i] = s.xv;
+  if (out.density) out.density[i] = r.density;
+  if (out.volume) out.volume[i] = r.volume;
+  if (out.enthalpy) out.enthalpy[i] = r.enthalpy;
+  if (out.relhum) out.relhum[i] = r.relhum;
+  if (out.dewpoint) out.dewpoint[i] = r.dewpoint;
+  if (out.wetbulb) out.wetbulb[i] = r.wetbulb;
+  if (out.status) out.status[i] = r.status;
+}
+
+
+/*! Calcula as propriedades de n amostras utilizando o modelo m, amostra por amostra, com as funes state e evaluate_all do modelo. Estas chamadas so virtuais, de modo que o resultado  sempre o das funes escalares do tipo dinmico de m, mesmo que uma classe derivada as redefina.
+
+\param m Modelo utilizado
+\param n Nmero de amostras
+\param ch Tipo de umidade fornecida ('R', 'W', 'D', 'B' ou 'X', ver Psychro::set)
+\param T Temperaturas em K
+\param umidade Umidades
+\param P Presses em Pa
+\param out Colunas de sada. Apenas as colunas no nulas so calculadas
+*/
+template<class Model>
+void batch_eval(const Model &m, size_t n, char ch, const double *T,
+		const double *umidade, const double *P, const MoistAirColumns &out){
+
+  for (size_t i = 0; i < n; ++i)
+    batch_outputs(m, m.state(T[i], ch, umidade[i], P[i]), out, i);
+}
+
+
+/*! Malha de nP presses por nU umidades na temperatura T (ver Psychro::gridRow) calculada ponto a ponto, como batch_eval.
+\param m Modelo utilizado
+\param T Temperatura em K
+\param nP Nmero de presses
+\param P Presses em Pa
+\param ch Tipo de umidade ('R', 'W', 'D', 'B' ou 'X', ver Psychro::set)
+\param nU Nmero de umidades
+\param umidade Umidades
+\param out Colunas de sada com nP*nU elementos; o ponto (j, k)  o elemento j*nU + k
+*/
+template<class Model>
+void grid_row_eval(const Model &m, double T, size_t nP, const double *P, char ch, size_t nU,
+		   const double *umidade, const MoistAirColumns &out){
+  for (size_t j = 0; j < nP; ++j)
+    for (size_t k = 0; k < nU; ++k)
+      batch_outputs(m, m.state(T, ch, umidade[k], P[j]), out, j*nU + k);
+}
+
+
+/*! Calcula as propriedades de n amostras cujos estados j so conhecidos (ver Ashrae::stateBatch). O cdigo de erro de cada amostra parte de s[i].status.
+\param m Modelo utilizado
+\param n Nmero de amostras
+\param s Estados
+\param out Colunas de sada. Apenas as colunas no nulas so calculadas
+*/
+template<class Model>
+void batch_eval(const Model &m, size_t n, const MoistAirState *s, const MoistAirColumns &out){
+  for (size_t i = 0; i < n; ++i)
+    batch_outputs(m, s[i], out, i);
+}
+
+
+/*! Calcula em double as amostras de colunas em float (ver Psychro::batchFloat): as entradas so convertidas para double (converso exata), calculadas por m.batch em blocos e os resultados so arredondados para float.
+\param m Modelo utilizado
+\param n Nmero de amostras
+\param ch Tipo de umidade fornecida ('R', 'W', 'D', 'B' ou 'X', ver Psychro::set)
+\param T Temperaturas em K
+\param umidade Umidades
+\param P Presses em Pa
+\param out Colunas de sada. Apenas as colunas no nulas so calculadas
+\param sel Se no for nulo, apenas as amostras i com sel[i] no nulo so calculadas (as demais posies de out no so modificadas)
+*/
+template<class Model>
+void batch_float_eval(const Model &m, size_t n, char ch, const float *T, const float *umidade,
+		      const float *P, const MoistAirColumnsF &out, const char *sel=0){
+  const size_t NB = 256;
+  double t[NB], u[NB], p[NB], r[MoistAirColumns::NCOL][NB];
+  int st[NB];
+  size_t idx[NB];
+  MoistAirColumns o;
+  for (int c = 0; c < MoistAirColumns::NCOL; ++c)
+    if (out.*MoistAirColumnsF::column(c)) o.*MoistAirColumns::column(c) = r[c];
+  o.status = st;
+
+  for (size_t i = 0; i < n; ){
+    size_t k = 0;
+    for (; i < n && k < NB; ++i){
+      if (sel && !sel[i]) continue;
+      idx[k] = i;
+      t[k] = T[i];
+      u[k] = umidade[i];
+      p[k] = P[i];
+      ++k;
+    }
+    if (!k) break;
+    m.batch(k, ch, t, u, p, o);
+    for (int c = 0; c < MoistAirColumns::NCOL; ++c)
+      if (float *col = out.*MoistAirColumnsF::column(c))
+	for (size_t j = 0; j < k; ++j) col[idx[j]] = r[c][j];
+    if (out.status)
+      for (size_t j = 0; j < k; ++j) out.status[idx[j]] = st[j];
+  }
+}
+
+#endif
@@ -0,0 +1,120 @@
+/*! \file cache.h
+
+\brief Memria de resultados compartilhada entre threads
+
+Painis e reprocessamentos de lotes calculam muitas vezes os mesmos valores de sensores, j quantizados pela resoluo dos instrumentos (0,1 C, 0,1 %, 10 Pa). ResultCache guarda as propriedades de cada entrada (modelo e sua configurao, tipo de umidade, T, umidade, P) de modo que uma entrada repetida no  recalculada, o que  especialmente vantajoso com o bulbo mido como entrada (CalcWfromB  iterativo).
+*/
+
+#ifndef _cache_h
+#define _cache_h
+
+#include <mutex>
+#include <vector>
+#include <cstdint>
+
+
+/*! \brief Opes de ResultCache
+
+Passos de quantizao das entradas: as entradas so arredondadas para o mltiplo mais prximo do passo antes do clculo, e todas as entradas que arredondam para o mesmo valor compartilham o resultado. Um passo nulo desativa a quantizao (apenas entradas idnticas compartilham o resultado).
+*/
+struct ResultCacheOptions{
+  /// Passo da temperatura e das umidades dadas como temperatura ('B' e 'D') em K
+  double dT;
+  /// Passo da umidade relativa ('R')
+  double dR;
+  /// Passo do teor de umidade e da frao molar ('W' e 'X')
+  double dW;
+  /// Passo da presso em Pa
+  double dP;
+  /// Nmero mximo de resultados armazenados
+  size_t capacity;
+  /// Nmero de parties, cada uma com o seu prprio bloqueio
+  unsigned shards;
+
+  ResultCacheOptions(): dT(0), dR(0), dW(0), dP(0), capacity(65536), shards(16){}
+};
+
+
+/*! \brief Memria limitada das propriedades de estados j calculados
+
+Cada resultado  o conjunto completo de propriedades do estado, indexado pelo modelo, pela sua configurao, pelo tipo de umidade e pelas entradas quantizadas (ver ResultCacheOptions). O modelo  identificado por Psychro::id, e no pelo endereo, que pode ser reutilizado por outro modelo depois da destruio do primeiro; a configurao por Psychro::configHash (faixas, tolerncias, mtodo da equao virial, modo rpido, ...). Os resultados so sempre calculados por Psychro::batch, tanto em get quanto em batch, de modo que a mesma entrada tem o mesmo resultado qualquer que seja a funo que a calculou primeiro. A memria  dividida em parties, cada uma com o seu bloqueio: threads que consultam entradas diferentes raramente disputam o mesmo bloqueio, e o clculo de um resultado ausente  feito fora dele. Cada partio  uma tabela associativa por conjuntos de WAYS posies; quando o conjunto est cheio, o resultado utilizado h mais tempo  descartado. Portanto a memria nunca ultrapassa capacity resultados e no h alocaes depois da construo.
+
+Como os modelos no so modificados pelas funes reentrantes, a mesma memria pode ser utilizada simultaneamente por vrias threads e por vrios modelos. Um modelo no deve ser reconfigurado enquanto outra thread o utiliza. Depois de reconfigurar um modelo deve-se chamar clear: os resultados da configurao anterior no so mais devolvidos, mas continuariam ocupando a memria at serem descartados.
+*/
+class ResultCache{
+ public:
+  /// Posies de cada conjunto
+  static const int WAYS = 4;
+
+  /// Estatsticas de utilizao
+  struct Stats{
+    /// Consultas atendidas pela memria
+    unsigned long long hits;
+    /// Consultas calculadas
+    unsigned long long misses;
+    /// Resultados descartados para dar lugar a outros
+    unsigned long long evictions;
+    /// Resultados armazenados
+    size_t size;
+  };
+
+  ResultCache(const ResultCacheOptions &opt=ResultCacheOptions());
+
+  /// Propriedades do estado (T, ch, umidade, P) do modelo m
+  MoistAirProperties get(const Psychro &m, double T, char ch, double umidade, double P);
+  /// Clculo em lote atravs da memria (ver Psychro::batch)
+  void batch(const Psychro &m, size_t n, char ch, const double *T, const double *umidade,
+	     const double *P, const MoistAirColumns &out);
+  /// Estatsticas acumuladas desde a construo ou desde clear
+  Stats stats() const;
+  /// Descarta todos os resultados e zera as estatsticas
+  void clear();
+
+  /// Passos de quantizao
+  const ResultCacheOptions opt;
+
+ private:
+  /// Entrada quantizada
+  struct Key{
+    /// Psychro::id e Psychro::configHash do modelo
+    uint64_t model, config;
+    int64_t T, u, P;
+    char ch;
+    bool operator==(const Key &k) const{
+      return model == k.model && config == k.config && T == k.T && u == k.u && P == k.P &&
+	ch == k.ch;
+    }
+  };
+
+  struct Entry{
+    Key key;
+    /// ltima utilizao (0: posio vazia)
+    uint64_t stamp;
+    MoistAirProperties props;
+    Entry(): stamp(0), props(MoistAirState()){}
+  };
+
+  struct Shard{
+    mutable std::mutex lock;
+    std::vector<Entry> slots;
+    uint64_t clock;
+    unsigned long long hits, misses, evictions;
+    size_t size;
+    /// Evita que parties vizinhas compartilhem a mesma linha de cache
+    char pad[64];
+  };
+
+  std::vector<Shard> shards;
+  size_t nsets;
+
+  bool quantize(const Psychro &m, uint64_t config, double &T, char ch, double &umidade, double &P,
+		Key &k) const;
+  Shard &shard(const Key &k, size_t &set);
+  bool find(const Key &k, MoistAirProperties &r);
+  void insert(const Key &k, const MoistAirProperties &r);
+
+  ResultCache(const ResultCache &);
+  ResultCache &operator=(const ResultCache &);
+};
+
+#endif
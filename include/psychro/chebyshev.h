@@ -0,0 +1,67 @@
+/*! \file chebyshev.h
+
+\brief Aproximao de funes por polinmios de Chebyshev por partes
+
+Utilizada pelo modo rpido dos modelos (ver Ashrae::fastMode) para substituir funes caras (presso de vapor, temperatura de saturao e enhancement factor) por polinmios.
+*/
+
+#ifndef _chebyshev_h
+#define _chebyshev_h
+
+#include <vector>
+#include <functional>
+
+
+/*! \brief Tabela de polinmios de Chebyshev por partes em uma ou duas variveis
+
+O domnio \f$[x_0, x_1] \times [y_0, y_1]\f$  dividido em nx intervalos iguais em x e ny intervalos iguais em y. Em cada retngulo a funo  interpolada nos ns de Chebyshev por um produto tensorial de polinmios de grau mx em x e my em y. Para funes de uma varivel, my = 0 e ny = 1.
+
+A funo fit dobra o nmero de intervalos at que o maior erro relativo, verificado em uma malha de pontos intermedirios aos ns de interpolao (onde o erro de interpolao  mximo), seja inferior  tolerncia. Este erro  armazenado em maxerr.
+
+A localizao do intervalo  direta (sem busca) e o polinmio  avaliado pelo algoritmo de Clenshaw.
+*/
+class ChebyshevTable{
+ public:
+  /// Limites do domnio em x
+  double x0, x1;
+  /// Limites do domnio em y
+  double y0, y1;
+  /// Graus dos polinmios em x e y
+  int mx, my;
+  /// Nmero de intervalos em x e y
+  int nx, ny;
+  /// Inverso da largura dos intervalos
+  double hx, hy;
+  /// Coeficientes: (mx+1)*(my+1) por retngulo
+  std::vector<double> c;
+  /// Maior erro relativo verificado
+  double maxerr;
+
+  ChebyshevTable();
+
+  /// Ajusta uma funo de uma varivel. Retorna 0 se a tolerncia foi atingida
+  int fit(const std::function<double(double)> &f, double x0, double x1, int mx,
+	  double tol, int nmax=4096);
+  /// Ajusta uma funo de duas variveis. Retorna 0 se a tolerncia foi atingida
+  int fit(const std::function<double(double,double)> &f, double x0, double x1,
+	  double y0, double y1, int mx, int my, double tol, int nmax=1024);
+
+  /// A tabela foi ajustada?
+  bool empty() const { return c.empty(); }
+  /// O ponto x est no domnio?
+  bool contains(double x) const { return x >= x0 && x <= x1; }
+  /// O ponto (x, y) est no domnio?
+  bool contains(double x, double y) const { return x >= x0 && x <= x1 && y >= y0 && y <= y1; }
+
+  /// Valor da aproximao em x e, se dx no for nulo, sua derivada
+  double operator()(double x, double *dx=0) const;
+  /// Valor da aproximao em (x, y)
+  double operator()(double x, double y) const;
+
+ private:
+  void fitSegment(const std::function<double(double,double)> &f, int i, int j);
+  double check(const std::function<double(double,double)> &f) const;
+  int locate(double x, double a, double h, int n, double &t) const;
+};
+
+#endif
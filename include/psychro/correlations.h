@@ -0,0 +1,727 @@
+/*! \file correlations.h
+
+\brief Correlaes dos modelos GasPerfeito, Ashrae e Giacomo
+
+As correlaes explcitas dos modelos (as que no chamam outras funes do modelo) so funes estticas das estruturas deste arquivo. As funes virtuais das classes, as verses vetoriais das funes em lote e os modelos compostos estaticamente (ver models.h) utilizam as mesmas expresses. As que so templates do tipo V aceitam double, float ou um vetor de vecmath.h. As constantes so convertidas para o tipo S dos elementos de V (ver vscalar): em double a expresso  a mesma, e em float as operaes so feitas em preciso simples (ver Psychro::batchFloat).
+*/
+
+#ifndef _correlations_h
+#define _correlations_h
+
+#include <cmath>
+
+#include "psychro.h"
+#include "vecmath.h"
+
+#if defined(__GNUC__)
+// Funes que retornam vetores de vecmath.h (ver o aviso de mudana de ABI em vecmath.h)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+
+
+/*! Limite entre o gelo e a gua no tipo S: o menor valor de S que no  inferior a 273.15, de modo que T < tgelo<S>() equivale a (double) T < 273.15. Em float, 273.15  arredondado para 273.149994, que j pertence ao gelo.
+ */
+template<class S> inline S tgelo(){ return 273.15; }
+template<> inline float tgelo<float>(){ return 273.150024f; }
+
+
+/*! \brief Correlaes do modelo de gs perfeito (ver GasPerfeito)
+ */
+struct GasPerfeitoCorrelations{
+  /*! Faixas de temperatura e coeficientes da correlao de presso de vapor (Tabela 15 da ASHRAE):
+  \f[ \ln (P_{ws}/1000) = A T^2 + B T + C + D/T \f]
+  Cada linha contm Tmin, Tmax, A, B, C e D; vale a primeira faixa com \f$T_{min} \le T < T_{max}\f$. Como as faixas se sobrepem (o Tmin de uma  no mximo o Tmax da anterior), esta  a faixa de ndice igual ao nmero de Tmax menores ou iguais a T (ver coefPws).
+  */
+  alignas(64) static const double tabPws[6][6];
+
+  /*! Faixas de presso e coeficientes da correlao de temperatura de saturao (Tabela 16 da ASHRAE, ver Tws):
+  \f[ T = E \beta^4 + F \beta^3 + G \beta^2 + H \beta + K, \quad \beta = \ln P \f]
+  Cada linha contm Pmin, Pmax, E, F, G, H e K. As faixas so contguas.
+  */
+  alignas(64) static const double tabTws[6][7];
+
+  /*! Coeficientes da correlao de presso de vapor (ver tabPws) vlidos na temperatura T_k. O ndice da faixa  a soma das comparaes com os Tmax, sem desvios condicionais. Fora das faixas os coeficientes so os da faixa mais prxima.
+  \param T_k Temperatura em K
+  \return 0 ou 17 se T_k estiver fora da faixa da correlao
+  */
+  static int coefPws(double T_k, double &A, double &B, double &C, double &D){
+    int i = 0;
+    for (int k = 0; k < 5; ++k) i += (T_k >= tabPws[k][1]);
+    A = tabPws[i][2];
+    B = tabPws[i][3];
+    C = tabPws[i][4];
+    D = tabPws[i][5];
+    return ((T_k >= tabPws[0][0]) & (T_k < tabPws[5][1])) ? 0 : 17;
+  }
+
+  /*! Coeficientes da correlao de presso de vapor (ver tabPws) de cada elemento de Tk, selecionados por mscaras, percorrendo as faixas de tabPws da ltima para a primeira: fica a primeira faixa com \f$T < T_{max}\f$ que, como as faixas se sobrepem,  a mesma escolhida por coefPws. Fora das faixas A  NaN.
+  \param Tk Temperaturas em K
+  */
+  template<class V>
+  static void coefPwsLanes(const V &Tk, V &A, V &B, V &C, V &D){
+    typedef typename vtraits<V>::mask M;
+    A = vset<V>(NAN); B = A; C = A; D = A;
+    typedef typename vscalar<V>::type S;
+    for (int k = 5; k >= 0; --k){
+      M in = (M)(Tk < S(tabPws[k][1]));
+      A = vselect(in, vset<V>(tabPws[k][2]), A);
+      B = vselect(in, vset<V>(tabPws[k][3]), B);
+      C = vselect(in, vset<V>(tabPws[k][4]), C);
+      D = vselect(in, vset<V>(tabPws[k][5]), D);
+    }
+    A = vselect((M)(Tk >= S(tabPws[0][0])), A, vset<V>(NAN));
+  }
+
+  /*! Coeficientes da correlao de temperatura de saturao (ver tabTws) vlidos na presso P, com o ndice da faixa calculado sem desvios condicionais (ver coefPws)
+  \param P Presso em Pa
+  \return 0 ou 18 se P estiver fora da faixa da correlao
+  */
+  static int coefTws(double P, double &E, double &F, double &G, double &H, double &K){
+    int i = 0;
+    for (int k = 0; k < 5; ++k) i += (P >= tabTws[k][1]);
+    E = tabTws[i][2];
+    F = tabTws[i][3];
+    G = tabTws[i][4];
+    H = tabTws[i][5];
+    K = tabTws[i][6];
+    return ((P >= tabTws[0][0]) & (P < tabTws[5][1])) ? 0 : 18;
+  }
+
+  /// Presso de vapor saturado em Pa (ver GasPerfeito::Pws)
+  static double Pws(double T, int *err){
+    double A, B, C, D;
+    int e = coefPws(T, A, B, C, D);
+    if (e){
+      if (err) *err = e;
+      return NAN;
+    }
+    return 1000*exp(A*T*T + B*T + C + D/T);
+  }
+
+  /// Derivada da presso de vapor saturado em Pa/K (ver GasPerfeito::dPws)
+  static double dPws(double T){
+    double A, B, C, D;
+    if (coefPws(T, A, B, C, D)) return NAN;
+    return 1000*exp(A*T*T + B*T + C + D/T) * (2*A*T + B - D/(T*T));
+  }
+
+  /// Presso de vapor saturado e sua derivada (ver GasPerfeito::PwsdPws)
+  static double PwsdPws(double T, double &dP){
+    double A, B, C, D;
+    if (coefPws(T, A, B, C, D)){
+      dP = NAN;
+      return NAN;
+    }
+    double p = 1000*exp(A*T*T + B*T + C + D/T);
+    dP = p * (2*A*T + B - D/(T*T));
+    return p;
+  }
+
+  /// Temperatura de saturao em K (ver GasPerfeito::Tws)
+  static double Tws(double P, int *err){
+    double E, F, G, H, K;
+    int e = coefTws(P, E, F, G, H, K);
+    if (e){
+      if (err) *err = e;
+      return NAN;
+    }
+    double beta = log(P);
+    return E*beta*beta*beta*beta + F*beta*beta*beta + G*beta*beta + H*beta + K;
+  }
+
+  /// Entalpia do ar seco J/kg (ver GasPerfeito::h_a_)
+  template<class V>
+  static V h_a(const V &T){
+    typedef typename vscalar<V>::type S;
+    return 1006*(T - S(273.15));
+  }
+
+  /// Entalpia do vapor saturado J/kg (ver GasPerfeito::h_v_)
+  template<class V>
+  static V h_v(const V &T){
+    typedef typename vscalar<V>::type S;
+    return 1000.0 * (2501.0 + S(1.805)*(T - S(273.15)));
+  }
+
+  /// Entalpia do gelo J/kg (ver GasPerfeito::h_s_ e GasPerfeito::h_l_)
+  template<class V>
+  static V h_s(const V &T){
+    typedef typename vscalar<V>::type S;
+    return 1000.0 * (S(334.402) + S(1.95645)*(T - S(273.15)));
+  }
+
+  /// Entalpia da gua J/kg (ver GasPerfeito::h_l_)
+  template<class V>
+  static V h_w(const V &T){
+    typedef typename vscalar<V>::type S;
+    return 4186*(T - S(273.15));
+  }
+
+  /// Entalpia da fase condensada J/kg (ver GasPerfeito::h_f_)
+  static double h_f(double T){
+    if (T<273.15)
+      return h_s(T);  // Gelo
+    else
+      return h_w(T);	// gua
+  }
+
+  /// Derivada da entalpia da fase condensada J/(kg.K) (ver GasPerfeito::dh_f_)
+  static double dh_f(double T){
+    if (T<273.15)
+      return 1956.45;  // Gelo
+    else
+      return 4186.0;	// gua
+  }
+
+  /// Massa especfica da gua saturada \f$kg/m^3\f$ (ver GasPerfeito::r_l_)
+  template<class V>
+  static V r_l(const V &Tk){
+    typedef typename vscalar<V>::type S;
+    V termo1 = S(-0.2403360201e4) - S(0.140758895e1)*Tk + S(0.1068287657e0)*Tk*Tk -
+      S(0.2914492351e-3)*vipow(Tk,3) + S(0.373497936e-6)*vipow(Tk,4) -
+      S(0.21203787e-9)*vipow(Tk,5);
+
+    V termo2 =  S(-0.3424442728e1) + S(0.1619785e-1)*Tk;
+
+    return termo1 / termo2;
+  }
+
+  /// Volume especfico do gelo saturado \f$m^3/kg\f$ (ver GasPerfeito::v_s_)
+  template<class V>
+  static V v_s(const V &Tk){
+    typedef typename vscalar<V>::type S;
+    return S(0.1070003e-2) - S(0.249936e-7)*Tk + S(0.371611e-9)*Tk*Tk;
+  }
+
+  /// Volume especfico da fase condensada \f$m^3/kg\f$ (ver GasPerfeito::v_f_), com o gelo ou a gua selecionado elemento a elemento
+  template<class V>
+  static V v_f(const V &Tk){
+    typedef typename vscalar<V>::type S;
+    typedef typename vtraits<V>::mask M;
+    return vselect((M)(Tk < tgelo<S>()), v_s(Tk), 1.0/r_l(Tk));
+  }
+
+  /*! Temperatura de bulbo mido de vtraits<V>::L estados (ver GasPerfeito::WETBULBLanes): iterao de Newton-Raphson sobre o balano de energia do saturador adiabtico com as entalpias lineares e a presso de vapor de coefPwsLanes. O ramo do gelo ou da gua  selecionado elemento a elemento e os elementos que j convergiram ficam congelados.
+  \param Tk Temperaturas em K
+  \param Pk Presses em Pa
+  \param wk Teores de umidade kg de vapor / kg de ar seco
+  \param EPS Tolerncia em K
+  \param fail Recebe a mscara dos elementos em que a iterao no convergiu
+  */
+  template<class V>
+  static V wetbulbLanes(const V &Tk, const V &Pk, const V &wk, typename vscalar<V>::type EPS,
+			typename vtraits<V>::mask &fail){
+    typedef typename vscalar<V>::type S;
+    typedef typename vtraits<V>::mask M;
+    const int NMAX = 100;
+    // Entalpias do ar seco e do vapor na entrada do saturador
+    V haT = h_a(Tk);
+    V hvT = h_v(Tk);
+
+    V b = Tk - 1.0;
+    M active = vnot(M()), nan = M();
+    for (int iter = 0; iter < NMAX && vany(active); ++iter){
+      V A, Bc, C, D;
+      coefPwsLanes(b, A, Bc, C, D);
+      V p = 1000*vexp(A*b*b + Bc*b + C + D/b);
+      V dp = p * (2*A*b + Bc - D/(b*b));
+      V w2 = S(Psychro::Mv / Psychro::Ma) * p / (Pk - p);
+      V dw2 = S(Psychro::Mv / Psychro::Ma) * Pk * dp / ((Pk - p)*(Pk - p));
+      M gelo = (M)(b < tgelo<S>());
+      V hv = h_v(b);
+      V hf = vselect(gelo, h_s(b), h_w(b));
+      V cpf = vselect(gelo, vset<V>(1956.45), vset<V>(4186.0));
+
+      V F = -wk*(hvT - hf) + h_a(b) - haT + w2*(hv - hf);
+      V dF = wk*cpf + 1006.0 + dw2*(hv - hf) + w2*(1805.0 - cpf);
+      V db = -F / dF;
+      V bn = b + db;
+      // Um passo que atravessa 273.15 no indica convergncia (ver Kernel::WETBULB)
+      M cruza = (M)(bn < tgelo<S>()) ^ gelo;
+      b = vselect(active, bn, b);
+      // A derivada  exata e a convergncia  quadrtica (ver Tolerances)
+      active = active & vnot(((M)(vfabs(db) < EPS) | (M)(db*db < EPS)) & vnot(cruza));
+      // Um elemento que virou NaN no converge mais: sai da iterao como no convergido
+      nan = nan | (active & vnot((M)(b == b)));
+      active = active & vnot(nan);
+    }
+    fail = active | nan;
+    return b;
+  }
+};
+
+
+/*! \brief Correlaes do modelo da ASHRAE (ver Ashrae)
+ */
+struct AshraeCorrelations{
+  /// Coeficientes de kappa_l para Tc < 100
+  static const double kappa_l0[7];
+  /// Coeficientes de kappa_l para Tc >= 100
+  static const double kappa_l100[7];
+
+  /*! Coeficientes viriais e derivadas na temperatura Tk, na ordem dos campos de Ashrae::VirialSet. As potncias de 1/T e as exponenciais de \f$B'\f$, \f$C'\f$ e \f$C_{aww}\f$ so calculadas apenas uma vez. As expresses so as mesmas das funes individuais (Ashrae::Baa, Ashrae::dBaa, ...).
+   */
+  template<class V>
+  static void virial(const V &Tk, V c[14]){
+    typedef typename vscalar<V>::type S;
+    V u = 1.0/Tk;
+    V u2 = u*u;
+    V u3 = u2*u;
+    V u4 = u3*u;
+    V u5 = u4*u;
+    const S R = Psychro::R;
+    V RT = R*Tk;
+
+    // Coeficientes da gua pura B' e C' (1/Pa e 1/Pa^2)
+    V eB = vexp(S(1734.29)*u);
+    V eC = vexp(S(3645.09)*u);
+    V Bl = S(0.70e-8) - S(0.147184e-8) * eB;
+    V Cl = S(0.104e-14) - S(0.335297e-17) * eC;
+    V dBl = S(0.255260e-5) * u2 * eB;
+    V dCl = S(0.122219e-13) * u2 * eC;
+
+    V Caww = -vexp(S(-0.10728876e2) + S(0.347802e4)*u - S(0.383383e6)*u2 + S(0.33406e8)*u3);
+
+    c[0] = (S(0.349568e2) - S(0.668772e4)*u - S(0.210141e7)*u2 + S(0.924746e8)*u3) / 1e3;	// Baa
+    c[1] = RT * Bl;							// Bww
+    c[2] = (S(0.32366097e2) - S(0.141138e5)*u - S(0.1244535e7)*u2 - S(0.2348789e10)*u4) / 1e3; // Baw
+    c[3] = (S(0.125975e4) - S(0.190905e6)*u + S(0.632467e8)*u2) / 1e6;	// Caaa
+    c[4] = RT*RT * (Cl + Bl*Bl);						// Cwww
+    c[5] = (S(0.482737e3) + S(0.105678e6)*u - S(0.656394e8)*u2 + S(0.294442e11)*u3
+	    - S(0.319317e13)*u4) / 1e6;					// Caaw
+    c[6] = Caww;								// Caww
+
+    c[7] = (S(0.668772e4)*u2 + S(0.420282e7)*u3 - S(0.277424e9)*u4) / 1e3;	// dBaa
+    c[8] = R * (Tk * dBl + Bl);						// dBww
+    c[9] = (S(0.141138e5)*u2 + S(0.248907e7)*u3 + S(0.93951568e10)*u5) / 1e3;	// dBaw
+    c[10] = (S(0.190905e6)*u2 - S(0.126493e9)*u3) / 1e6;			// dCaaa
+    c[11] = RT*RT * (dCl + 2*Bl*dBl) + 2*R*RT * (Cl + Bl*Bl);		// dCwww
+    c[12] = (S(-0.105678e6)*u2 + S(1.312788e8)*u3 - S(8.83326e10)*u4 + S(1.277268e13)*u5) / 1e6; // dCaaw
+    c[13] = (S(-0.347802e4)*u2 + S(2*0.383383e6)*u3 - S(3*0.33406e8)*u4) * Caww;	// dCaww
+  }
+
+  /// Copia os coeficientes na ordem de virial para v
+  static void virialSet(const double c[14], Ashrae::VirialSet &v){
+    v.Baa = c[0]; v.Bww = c[1]; v.Baw = c[2];
+    v.Caaa = c[3]; v.Cwww = c[4]; v.Caaw = c[5]; v.Caww = c[6];
+    v.dBaa = c[7]; v.dBww = c[8]; v.dBaw = c[9];
+    v.dCaaa = c[10]; v.dCwww = c[11]; v.dCaaw = c[12]; v.dCaww = c[13];
+  }
+
+  /// Coeficientes viriais e derivadas na temperatura Tk (ver Ashrae::virial)
+  static Ashrae::VirialSet virialSet(double Tk){
+    Ashrae::VirialSet v;
+    double c[14];
+    virial(Tk, c);
+    virialSet(c, v);
+    return v;
+  }
+
+  /// Presso de vapor sobre a gua em Pa (ver Ashrae::Pws_l)
+  static double Pws_l(double Tk){
+    double lnP = -0.58002206e4/Tk + 0.13914993e1 + -0.48640239e-1*Tk + 0.41764768e-4*Tk*Tk +
+      -0.14452093e-7*Tk*Tk*Tk + 0.65459673e1*log(Tk);
+    return exp(lnP);
+  }
+
+  /// Presso de vapor sobre o gelo em Pa (ver Ashrae::Pws_s)
+  static double Pws_s(double Tk){
+    double lnP = -0.56745359e4/Tk + 0.63925247e1 + -0.96778430e-2*Tk + 0.62215701e-6*Tk*Tk +
+      0.20747825e-8*Tk*Tk*Tk + -0.94840240e-12*Tk*Tk*Tk*Tk + 0.41635019e1*log(Tk);
+    return exp(lnP);
+  }
+
+  /// Derivada de \f$\ln P_{ws}\f$ sobre o gelo 1/K
+  static double dlnPws_s(double Tk){
+    return 0.56745359e4/(Tk*Tk) + 0.41635019e1/Tk - 0.96778430e-2 +
+      0.12443140e-5*Tk + 0.62243475e-8 * Tk*Tk - 0.37936096e-11*Tk*Tk*Tk;
+  }
+
+  /// Derivada de \f$\ln P_{ws}\f$ sobre a gua 1/K
+  static double dlnPws_l(double Tk){
+    return 0.58002206e4/(Tk*Tk) + 0.65459673e1/Tk - 0.48640239e-1 +
+      0.83529536e-4*Tk -0.43356279e-7 * Tk*Tk;
+  }
+
+  /// Presso de vapor saturado e sua derivada, com um nico logaritmo e uma nica exponencial (ver Ashrae::PwsdPws)
+  static double PwsdPws(double Tk, double &dP){
+    double lnP, dlnP;
+    double lnT = log(Tk);
+
+    if (Tk < 273.15){
+      lnP = -0.56745359e4/Tk + 0.63925247e1 - 0.96778430e-2*Tk + 0.62215701e-6*Tk*Tk +
+	0.20747825e-8*Tk*Tk*Tk - 0.94840240e-12*Tk*Tk*Tk*Tk + 0.41635019e1*lnT;
+      dlnP = dlnPws_s(Tk);
+    }else{
+      lnP = -0.58002206e4/Tk + 0.13914993e1 - 0.48640239e-1*Tk + 0.41764768e-4*Tk*Tk -
+	0.14452093e-7*Tk*Tk*Tk + 0.65459673e1*lnT;
+      dlnP = dlnPws_l(Tk);
+    }
+
+    double P = exp(lnP);
+    dP = P * dlnP;
+    return P;
+  }
+
+  /*! \f$\ln P_{ws}\f$ (ver Ashrae::Pws) com as correlaes do gelo e da gua avaliadas em todos os elementos de Tk e selecionadas por mscara, na forma de Horner (ver Ashrae::PwsBatch)
+  \param dlnP Se no for nulo, recebe \f$d \ln P_{ws}/dT\f$ 1/K
+  */
+  template<class V>
+  static V lnPws(const V &Tk, V *dlnP=0){
+    typedef typename vscalar<V>::type S;
+    typedef typename vtraits<V>::mask M;
+    V lnT = vlog(Tk);
+    M gelo = (M)(Tk < tgelo<S>());
+    V lnPs = S(-0.56745359e4)/Tk + S(0.63925247e1) + Tk*(S(-0.96778430e-2) + Tk*(S(0.62215701e-6) +
+      Tk*(S(0.20747825e-8) - S(0.94840240e-12)*Tk))) + S(0.41635019e1)*lnT;
+    V lnPl = S(-0.58002206e4)/Tk + S(0.13914993e1) + Tk*(S(-0.48640239e-1) + Tk*(S(0.41764768e-4) -
+      S(0.14452093e-7)*Tk)) + S(0.65459673e1)*lnT;
+    if (dlnP){
+      V dlnPs = S(0.56745359e4)/(Tk*Tk) + S(0.41635019e1)/Tk - S(0.96778430e-2) +
+	Tk*(S(0.12443140e-5) + Tk*(S(0.62243475e-8) - S(0.37936096e-11)*Tk));
+      V dlnPl = S(0.58002206e4)/(Tk*Tk) + S(0.65459673e1)/Tk - S(0.48640239e-1) +
+	Tk*(S(0.83529536e-4) - S(0.43356279e-7)*Tk);
+      *dlnP = vselect(gelo, dlnPs, dlnPl);
+    }
+    return vselect(gelo, lnPs, lnPl);
+  }
+
+  /*! Constante de Henry de um gs [5] para \f$\tau = 1000/T\f$. \f$x = \log_{10} k\f$  a raiz de \f$\alpha x^2 + (\gamma\tau + \delta) x + \beta\tau^2 + \epsilon\tau - 1 = 0\f$.
+   */
+  template<class V>
+  static V henrykGas(const V &tau, typename vscalar<V>::type alfa, typename vscalar<V>::type beta,
+		     typename vscalar<V>::type gama, typename vscalar<V>::type delta,
+		     typename vscalar<V>::type eps){
+    V a1 = gama*tau + delta;
+    V a0 = beta*tau*tau + eps*tau - 1.0;
+    V raizes = (-a1 - vsqrt(a1*a1 - 4*alfa*a0)) / (2*alfa);
+    return vexp10(raizes);
+  }
+
+  /// Constante de Henry do oxignio 1/Pa (ver Ashrae::henryk_O2)
+  template<class V>
+  static V henryk_O2(const V &Tk){
+    return henrykGas(1000/Tk, -0.0005943, -0.1470, -0.05120, -0.1076, 0.8447);
+  }
+
+  /// Constante de Henry do nitrognio 1/Pa (ver Ashrae::henryk_N2)
+  template<class V>
+  static V henryk_N2(const V &Tk){
+    return henrykGas(1000/Tk, -0.1021, -0.1482, -0.019, -0.03741, 0.851);
+  }
+
+  /// Constante de Henry do ar a partir das do oxignio e do nitrognio (ver Ashrae::henryk)
+  template<class V>
+  static V henryk(const V &kO2, const V &kN2){
+    typedef typename vscalar<V>::type S;
+    V k = 1.0 / (S(0.22)/kO2 + S(0.78)/kN2);
+    return S(1e-4)/k * 1.0/101325.0;
+  }
+
+  /// Constante de Henry do ar 1/Pa, nula no gelo (ver Ashrae::saturation)
+  template<class V>
+  static V henrykSat(const V &Tk){
+    typedef typename vscalar<V>::type S;
+    typedef typename vtraits<V>::mask M;
+    return vselect((M)(Tk < tgelo<S>()), vset<V>(0.0), henryk(henryk_O2(Tk), henryk_N2(Tk)));
+  }
+
+  /// Compressibilidade isotrmica da gua [6] para Tc (oC), com os coeficientes c (kappa_l0 ou kappa_l100)
+  template<class V>
+  static V kappa_l(const V &Tc, const double *c){
+    typedef typename vscalar<V>::type S;
+    V k = (S(c[0]) + S(c[1])*Tc + S(c[2])*Tc*Tc + S(c[3])*Tc*Tc*Tc + S(c[4])*vipow(Tc,4) +
+	   S(c[5])*vipow(Tc,5)) / (1.0 + S(c[6])*Tc);
+    return k * S(1e-11);  // 1/Pa
+  }
+
+  /// Compressibilidade isotrmica da gua 1/Pa (ver Ashrae::kappa_l)
+  static double kappa_l(double Tk){
+    double Tc = Tk - 273.15;
+    return kappa_l(Tc, (Tc < 100.0) ? kappa_l0 : kappa_l100);
+  }
+
+  /// Compressibilidade isotrmica do gelo [2] 1/Pa (ver Ashrae::kappa_s)
+  template<class V>
+  static V kappa_s(const V &Tk){
+    typedef typename vscalar<V>::type S;
+    return (8.875 + S(0.0165) * Tk) * S(1e-11);
+  }
+
+  /// Compressibilidade isotrmica da fase condensada 1/Pa (ver Ashrae::kappa_f), com o gelo ou a gua selecionado elemento a elemento
+  template<class V>
+  static V kappa_f(const V &Tk){
+    typedef typename vscalar<V>::type S;
+    typedef typename vtraits<V>::mask M;
+    V Tc = Tk - S(273.15);
+    V kl = vselect((M)(Tc < 100.0), kappa_l(Tc, kappa_l0), kappa_l(Tc, kappa_l100));
+    return vselect((M)(Tk < tgelo<S>()), kappa_s(Tk), kl);
+  }
+
+  /// Expresso de ln f (ver Ashrae::lnf) para T, P e as grandezas de saturao
+  template<class V>
+  static V lnf(const V &T, const V &P, const V &xas, const V &p, const V &vc, const V &kk,
+	       const V &k, const V &Baa, const V &Bww, const V &Baw, const V &Caaa,
+	       const V &Cwww, const V &Caaw, const V &Caww){
+    const typename vscalar<V>::type R = Psychro::R;
+    V RT = R*T;
+
+    V t1 = vc/RT * ( (1 + kk*p)*(P-p) - .5 * kk * (P*P - p*p) );
+
+    V t2 = vlog(1.0 - k*xas*P) + (xas*xas*P/RT)*Baa - (2*xas*xas*P/RT)*Baw;
+
+    V t3 = -(P-p-xas*xas*P)/RT*Bww + xas*xas*xas*P*P/(RT*RT) * Caaa;
+
+    V t4 = 3*xas*xas*(1.0-2.0*xas)*P*P/(2*RT*RT) * Caaw -
+      (3*xas*xas*(1-xas)*P*P)/(RT*RT)*Caww;
+
+    V t5 = - ( (1.0+2.0*xas)*vipow(1.0-xas, 2) * P*P - p*p)/(2.0*RT*RT) * Cwww;
+
+    V t6 = -xas*xas*(1.0-3.0*xas)*(1.0-xas)*P*P/(RT*RT) * Baa * Bww -
+      2.0*xas*xas*xas*(2.0-3.0*xas)*P*P/(RT*RT) * Baa * Baw;
+
+    V t7 = 6.0*xas*xas*vipow(1.0-xas,2)*P*P/(RT*RT)*Bww*Baw -
+      3.0*vipow(xas,4)*P*P/(2.0*RT*RT)*Baa*Baa;
+
+    V t8 = -2.0*xas*xas*(1.0-xas)*(1.0-3.0*xas)*P*P/(RT*RT) * Baw*Baw -
+      ( p*p - (1.0+3.0*xas)*vipow(1.0-xas,3)*P*P) / (2*RT*RT) * Bww*Bww;
+
+    return t1+t2+t3+t4+t5+t6+t7+t8;
+  }
+
+  /// ln f a partir das grandezas de saturao sp (ver Ashrae::lnf)
+  static double lnf(const Ashrae::SaturationPoint &sp, double P, double xas){
+    const Ashrae::VirialSet &v = sp.v;
+    return lnf(sp.T, P, xas, sp.Pws, sp.vc, sp.kappa, sp.k,
+	       v.Baa, v.Bww, v.Baw, v.Caaa, v.Cwww, v.Caaw, v.Caww);
+  }
+
+  /// Estimativa explcita da temperatura de saturao de Paulo Jos Saiz Jabardo (ver Ashrae::Tws0)
+  template<class V>
+  static V tws0(const V &PP){
+    typedef typename vscalar<V>::type S;
+    const S g[]={S(2.127925e2),
+		 S(7.305398e0),
+		 S(1.969953e-1),
+		 S(1.103701e-2),
+		 S(1.849307e-3),
+		 S(5.145087e-6)};
+    V lnP = vlog(PP);
+
+    return g[0] + g[1]*lnP + g[2]*lnP*lnP + g[3]*lnP*lnP*lnP +
+      g[4]*lnP*lnP*lnP*lnP + g[5] * PP;
+  }
+
+  /// Entalpia do gelo saturado (ver Ashrae::h_s_) dada a presso de vapor p em Pa
+  static double hs(double Tk, double p){
+    return 1000.0 * (-0.647595E3 + 0.274292e0*Tk + 0.2910583e-2*Tk*Tk + 0.1083437e-5*Tk*Tk*Tk +
+		     0.107e-5*p);
+  }
+
+  /// Derivada de hs dada a derivada dp da presso de vapor em Pa/K
+  static double dhs(double Tk, double dp){
+    return 1000.0 * (0.274292e0 + 2*0.2910583e-2*Tk + 3*0.1083437e-5*Tk*Tk + 0.107e-5*dp);
+  }
+
+  /*! Parcela \f$\alpha\f$ da entalpia da gua saturada (ver Ashrae::h_l_) em kJ/kg
+  \param Tk Temperatura em K
+  \param dalfa Se no for nulo, recebe \f$d\alpha/dT\f$ kJ/(kg.K)
+  */
+  static double hlAlpha(double Tk, double *dalfa=0){
+    double L[] = {-0.11411380e4,
+		  0.41930463e1,
+		  -0.8134865e-4,
+		  0.1451133e-6,
+		  -0.1005230e-9,
+		  -0.563473,
+		  -0.036};
+
+    double M[] = {-0.1141837121e4,
+		  0.4194325677e1,
+		  -0.6908894163e-4,
+		  0.105555302e-6,
+		  -0.7111382234e-10,
+		  0.6059e-6};
+
+    double alfa;
+    if (Tk < 373.125){
+      double e = pow(10,L[6] * (Tk- 273.15));
+      alfa = L[0] + L[1]*Tk + L[2]*Tk*Tk + L[3]*Tk*Tk*Tk + L[4]*Tk*Tk*Tk*Tk + L[5] * e;
+      if (dalfa)
+	*dalfa = L[1] + 2*L[2]*Tk + 3*L[3]*Tk*Tk + 4*L[4]*Tk*Tk*Tk + L[5] * L[6] * log(10.0) * e;
+    }else if (373.125 < Tk && Tk <= 403.128){
+      alfa = M[0] + M[1]*Tk + M[2]*Tk*Tk + M[3]*Tk*Tk*Tk + M[4]*Tk*Tk*Tk*Tk;
+      if (dalfa) *dalfa = M[1] + 2*M[2]*Tk + 3*M[3]*Tk*Tk + 4*M[4]*Tk*Tk*Tk;
+    }else{
+      alfa = M[0] + M[1]*Tk + M[2]*Tk*Tk + M[3]*Tk*Tk*Tk +
+	M[4]*Tk*Tk*Tk*Tk - M[5]*pow(Tk - 403.128, 3.1);
+      if (dalfa)
+	*dalfa = M[1] + 2*M[2]*Tk + 3*M[3]*Tk*Tk + 4*M[4]*Tk*Tk*Tk -
+	  3.1*M[5]*pow(Tk - 403.128, 2.1);
+    }
+    return alfa;
+  }
+
+  /// Entalpia da fase condensada e sua derivada a partir das grandezas de saturao (ver Ashrae::hfSat)
+  static double hfSat(const Ashrae::SaturationPoint &sp, double ref, double *dh){
+    double Tk = sp.T;
+    if (Tk < 273.15){
+      if (dh) *dh = dhs(Tk, sp.dPws);
+      return hs(Tk, sp.Pws);
+    }
+    double dalfa;
+    double alfa = hlAlpha(Tk, dh ? &dalfa : 0);
+    if (dh) *dh = 1000.0 * dalfa;
+    return 1000.0 * alfa + Tk * (sp.vc / Psychro::Mv * sp.dPws - ref);
+  }
+
+  /*! Entalpia da fase condensada J/kg (ver Ashrae::h_f_) com os ramos do gelo (hs) e da gua (hlAlpha) avaliados em todos os elementos de Tk e selecionados por mscara
+  \param P Presso de vapor em Pa
+  \param dP Derivada da presso de vapor em Pa/K
+  \param vl Volume especfico da fase condensada \f$m^3/kg\f$ (ver GasPerfeito::v_f_)
+  \param beta0 Termo de referncia de h_l_ (ver Ashrae::hlRef)
+  \param dh Se no for nulo, recebe \f$dh_f/dT\f$ J/(kg.K)
+  */
+  template<class V>
+  static V hf(const V &Tk, const V &P, const V &dP, const V &vl, typename vscalar<V>::type beta0,
+	      V *dh){
+    typedef typename vscalar<V>::type S;
+    typedef typename vtraits<V>::mask M;
+
+    // Gelo (h_s_)
+    V hs = 1000.0 * (S(-0.647595E3) + Tk*(S(0.274292e0) + Tk*(S(0.2910583e-2) + S(0.1083437e-5)*Tk)) +
+			   S(0.107e-5)*P);
+    V dhs = 1000.0 * (S(0.274292e0) + Tk*(S(2*0.2910583e-2) + S(3*0.1083437e-5)*Tk) + S(0.107e-5)*dP);
+
+    // gua lquida (h_l_): L para T < 373.125, M at 403.128 e M com o termo em (T - 403.128)^3.1 acima
+    V e = vexp10(S(-0.036) * (Tk - S(273.15)));
+    V aL = S(-0.11411380e4) + Tk*(S(0.41930463e1) + Tk*(S(-0.8134865e-4) + Tk*(S(0.1451133e-6) -
+      S(0.1005230e-9)*Tk))) - S(0.563473)*e;
+    V daL = S(0.41930463e1) + Tk*(S(2*-0.8134865e-4) + Tk*(S(3*0.1451133e-6) - S(4*0.1005230e-9)*Tk)) +
+      S(-0.563473 * -0.036 * 2.302585092994046)*e;
+    V aM = S(-0.1141837121e4) + Tk*(S(0.4194325677e1) + Tk*(S(-0.6908894163e-4) +
+      Tk*(S(0.105555302e-6) - S(0.7111382234e-10)*Tk)));
+    V daM = S(0.4194325677e1) + Tk*(S(2*-0.6908894163e-4) + Tk*(S(3*0.105555302e-6) -
+      S(4*0.7111382234e-10)*Tk));
+    V x = Tk - S(403.128);
+    M acima = (M)(x > 0.0);
+    V lnx = vlog(vselect(acima, x, vset<V>(1.0)));
+    V aM3 = aM - S(0.6059e-6)*vexp(S(3.1)*lnx);
+    V daM3 = daM - S(3.1*0.6059e-6)*vexp(S(2.1)*lnx);
+
+    M trecho1 = (M)(Tk < S(373.125));
+    M trecho2 = (M)(Tk > S(373.125)) & vnot(acima);
+    V alfa = vselect(trecho1, aL, vselect(trecho2, aM, aM3));
+    V hl = 1000.0 * alfa + (Tk * vl * dP - Tk * beta0);
+
+    M gelo = (M)(Tk < tgelo<S>());
+    if (dh){
+      V dalfa = vselect(trecho1, daL, vselect(trecho2, daM, daM3));
+      *dh = vselect(gelo, dhs, 1000.0 * dalfa);
+    }
+    return vselect(gelo, hs, hl);
+  }
+
+  /*! Entalpia molar J/kmol (ver Ashrae::hM_) a partir dos coeficientes viriais c (na ordem de virial) e do volume molar Vm
+  \param dhdx Se no for nulo, recebe \f$\partial h_m/\partial x_v\f$ J/kmol
+  \param dhdT Se no for nulo, recebe \f$\partial h_m/\partial T\f$ J/(kmol.K)
+  */
+  template<class V>
+  static V hM(const V &Tk, const V &P, const V &xv, const V c[14], const V &Vm, V *dhdx, V *dhdT){
+    typedef typename vscalar<V>::type S;
+    const S R = Psychro::R;
+    V xa = 1.0 - xv;
+
+    V B = xa*xa*c[0] + 2*xa*xv*c[2] + xv*xv*c[1];
+    V C = xa*xa*xa*c[3] + 3*xa*xa*xv*c[5] + 3*xa*xv*xv*c[6] + xv*xv*xv*c[4];
+    V dB = xa*xa*c[7] + 2*xa*xv*c[9] + xv*xv*c[8];
+    V dC = xa*xa*xa*c[10] + 3*xa*xa*xv*c[12] + 3*xa*xv*xv*c[13] + xv*xv*xv*c[11];
+
+    // Coeficientes a e d de hM_, com ha = -7914.1982 e hv = 35994.17 somados ao termo constante
+    V termo1 = S(0.63290874e1 - 7914.1982) + Tk*(S(0.28709015e2) + Tk*(S(0.26431805e-2) +
+      Tk*(S(-0.10405863e-4) + Tk*(S(0.18660410e-7) - S(0.9784331e-11)*Tk))));
+    V termo2 = S(-0.5008e-2 + 35994.17) + Tk*(S(0.32491829e2) + Tk*(S(0.65576345e-2) +
+      Tk*(S(-0.26442147e-4) + Tk*(S(0.51751789e-7) - S(0.31541624e-10)*Tk))));
+
+    V g1 = B - Tk*dB;
+    V g2 = C - 0.5*Tk*dC;
+    V termo3 = g1/Vm + g2/(Vm*Vm);
+
+    if (dhdx){
+      V Bx = 2*(-xa*c[0] + (xa - xv)*c[2] + xv*c[1]);
+      V dBx = 2*(-xa*c[7] + (xa - xv)*c[9] + xv*c[8]);
+      V Cx = 3*(-xa*xa*c[3] + (xa*xa - 2*xa*xv)*c[5] +
+		      (2*xa*xv - xv*xv)*c[6] + xv*xv*c[4]);
+      V dCx = 3*(-xa*xa*c[10] + (xa*xa - 2*xa*xv)*c[12] +
+		       (2*xa*xv - xv*xv)*c[13] + xv*xv*c[11]);
+      V aa = R*Tk/P;
+      V Vx = aa*(Bx*Vm + Cx) / (3*Vm*Vm - 2*aa*Vm - aa*B);
+      V dtermo3 = (Bx - Tk*dBx)/Vm + (Cx - 0.5*Tk*dCx)/(Vm*Vm) -
+	(g1/(Vm*Vm) + 2*g2/(Vm*Vm*Vm)) * Vx;
+      *dhdx = (termo2 - termo1) * 1000.0 + R*Tk*dtermo3;
+    }
+
+    if (dhdT){
+      V dtermo1 = S(0.28709015e2) + Tk*(S(2*0.26431805e-2) + Tk*(S(3*-0.10405863e-4) +
+	Tk*(S(4*0.18660410e-7) - S(5*0.9784331e-11)*Tk)));
+      V dtermo2 = S(0.32491829e2) + Tk*(S(2*0.65576345e-2) + Tk*(S(3*-0.26442147e-4) +
+	Tk*(S(4*0.51751789e-7) - S(5*0.31541624e-10)*Tk)));
+      *dhdT = xa * dtermo1 * 1000.0 + xv * dtermo2 * 1000.0 + R*termo3;
+    }
+
+    return xa * termo1 * 1000.0 + xv * termo2 * 1000.0 + R*Tk*termo3;
+  }
+};
+
+
+/*! \brief Correlaes de Giacomo (ver Giacomo)
+ */
+struct GiacomoCorrelations{
+  /// Presso de vapor de saturao em Pa (ver Giacomo::Pws)
+  template<class V>
+  static V Pws(const V &T){
+    typedef typename vscalar<V>::type S;
+    return vexp(S(1.2811805e-5)*T*T - S(1.9509874e-2)*T + S(34.04926034) - S(6.3536311e3)/T);
+  }
+
+  /// Derivada de \f$\ln P_{ws}\f$ 1/K
+  template<class V>
+  static V dlnPws(const V &T){
+    typedef typename vscalar<V>::type S;
+    return S(2*1.2811805e-5)*T - S(1.9509874e-2) + S(6.3536311e3)/(T*T);
+  }
+
+  /// Enhancement factor (ver Giacomo::eFactor)
+  template<class V>
+  static V eFactor(const V &T, const V &P){
+    typedef typename vscalar<V>::type S;
+    V t = T - S(273.15);
+    return S(1.00062) + S(3.14e-8)*P + S(5.6e-7)*t*t;
+  }
+
+  /// Fator de compressibilidade (ver Giacomo::Z)
+  template<class V>
+  static V Z(const V &T, const V &P, const V &xv){
+    typedef typename vscalar<V>::type S;
+    V t = T - S(273.15);
+    const S a0 = S(1.62419e-6);
+    const S a1 = S(-2.8969e-8);
+    const S a2 = S(1.0880e-10);
+    const S b0 = S(5.757e-6);
+    const S b1 = S(-2.589e-8);
+    const S c0 = S(1.9297e-4);
+    const S c1 = S(-2.285e-6);
+    const S d = S(1.73e-11);
+    const S e = S(-1.034e-8);
+
+    return 1.0 - P/T * (a0 + a1*t + a2*t*t + (b0 + b1*t)*xv +
+			(c0 + c1*t)*xv*xv) + P*P/(T*T)*(d + e*xv*xv);
+  }
+};
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+
+#endif
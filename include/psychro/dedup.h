@@ -0,0 +1,14 @@
+/*! \file dedup.h
+
+\brief Clculo em lote com amostras repetidas
+*/
+
+#ifndef _dedup_h
+#define _dedup_h
+
+
+/// Clculo em lote em que cada amostra distinta  calculada uma nica vez (ver Psychro::batch). Retorna o nmero de amostras distintas
+size_t dedup_batch(const Psychro &m, size_t n, char ch, const double *T,
+		   const double *umidade, const double *P, const MoistAirColumns &out);
+
+#endif
@@ -22,8 +22,15 @@ class GasPerfeito: public Psychro{
   GasPerfeito();
   /// Funes bsica de entrada de dados. Vai especificar a a mistura ar - vapor.
   virtual void set(double T, char ch, double umidade, double P);
+  /// Especifica a mistura ar-vapor sem modificar o modelo
+  virtual MoistAirState state(double T, char ch, double umidade, double P) const;
+  /// Especifica a mistura ar-vapor com partida a quente (ver SolverContext)
+  virtual MoistAirState state(double T, char ch, double umidade, double P, SolverContext &c) const;
   /// Funo para clculo da compressibilidade do ar mido
-  virtual double Z(double T, double P, double xv); // Compressibilidade
+  virtual double Z(double T, double P, double xv, int *err=0) const; // Compressibilidade
+  /// Compressibilidade de n estados (verso vetorial de Z)
+  virtual void ZBatch(size_t n, const double *T, const double *P, const double *xv,
+		      double *Z, int *err=0) const;
   
   
 
@@ -50,69 +57,140 @@ class GasPerfeito: public Psychro{
   virtual int ERROR();		// Cdigo de erro.
   
 
+  // Funes de sada reentrantes (no modificam o modelo)
+  /// Entalpia em J/kg de ar seco do estado s
+  virtual double ENTHALPY(const MoistAirState &s, int *err=0) const;
+  /// Volume especfico do ar mido em \f$m^3/kg\f$ de ar seco do estado s
+  virtual double VOLUME(const MoistAirState &s, int *err=0) const;
+  /// Massa especifica do ar mido em \f$kg/m^3\f$ do estado s
+  virtual double DENSITY(const MoistAirState &s, int *err=0) const;
+  /// Entropia do ar mido J/(kg.K) do estado s
+  virtual double ENTROPY(const MoistAirState &s, int *err=0) const;
+  /// Temperatura de bulbo mido em K do estado s
+  virtual double WETBULB(const MoistAirState &s, int *err=0) const;
+  /// Temperatura de bulbo mido em K do estado s com partida a quente (ver SolverContext)
+  virtual double WETBULB(const MoistAirState &s, SolverContext &c, int *err=0) const;
+  /// Temperatura de ponto de orvalho em K do estado s
+  virtual double DEWPOINT(const MoistAirState &s, int *err=0) const;
+  /// Temperatura de ponto de orvalho em K do estado s com partida a quente (ver SolverContext)
+  virtual double DEWPOINT(const MoistAirState &s, SolverContext &c, int *err=0) const;
+  /// Umidade relativa do estado s
+  virtual double RELHUM(const MoistAirState &s, int *err=0) const;
+  /// Propriedades do estado s selecionadas por mask (ver MoistAirProperty)
+  virtual MoistAirProperties evaluate_all(const MoistAirState &s, unsigned mask=PROP_ALL) const;
+  /// evaluate_all com a memria c (ver MoistAirCache)
+  virtual const MoistAirProperties &evaluate(MoistAirCache &c, const MoistAirState &s,
+					     unsigned mask=PROP_ALL) const;
+  /// Plano de temperatura T de uma malha (ver grid_eval)
+  virtual void gridRow(double T, size_t nP, const double *P, char ch, size_t nU,
+		       const double *umidade, const MoistAirColumns &out) const;
+  /// Clculo em lote (ver batch_eval)
+  virtual void batch(size_t n, char ch, const double *T, const double *umidade,
+		     const double *P, const MoistAirColumns &out) const;
+  /// Clculo em lote com colunas em float, calculado em double por batch
+  virtual void batchFloat(size_t n, char ch, const float *T, const float *umidade,
+			  const float *P, const MoistAirColumnsF &out) const;
+  /// As verses vetoriais das funes em lote reproduzem as correlaes do tipo dinmico? (ver nativeBatch em gas_perfeito.cpp)
+  virtual bool nativeBatch() const;
+  /// Temperatura de bulbo mido de n estados (verso vetorial de WETBULB)
+  virtual void WETBULBBatch(size_t n, const double *T, const double *P, const double *W,
+			    double *B, int *err=0) const;
+  
+
   // Funes auxiliares:
 
   /// Calcula o enhancement factor
-  virtual double eFactor(double T, double P);	// Enhancement factor
-  /// Calcula a presso de vapor em Pa do vapor saturado
-  virtual double Pws(double T);  	// Presso de saturao de vapor
-  /// Calcula a temperatura de saturao em K do vapor saturado
-  virtual double Tws(double P);         // Temperatura de saturao de vapor
+  virtual double eFactor(double T, double P) const;	// Enhancement factor
+  /// Enhancement factor de n estados (verso vetorial de eFactor)
+  virtual void eFactorBatch(size_t n, const double *T, const double *P, double *f,
+			    int *err=0) const;
+  /// Calcula a presso de vapor em Pa do vapor saturado (cdigo de erro 17 fora da faixa da correlao)
+  virtual double Pws(double T, int *err=0) const;  	// Presso de saturao de vapor
+  /// Calcula a temperatura de saturao em K do vapor saturado (cdigo de erro 18 fora da faixa da correlao)
+  virtual double Tws(double P, int *err=0) const;
+  /// Temperatura de saturao de n presses (verso vetorial de Tws)
+  virtual void TwsBatch(size_t n, const double *P, double *T, int *err=0) const;
+  /// Derivada da presso de vapor saturado Pa/K
+  virtual double dPws(double T) const;         // Temperatura de saturao de vapor
+  /// Presso de vapor saturado e sua derivada
+  virtual double PwsdPws(double T, double &dP) const;
+  /// Presso de vapor saturado de n temperaturas (verso vetorial de Pws)
+  virtual void PwsBatch(size_t n, const double *T, double *p) const;
 
 
   // Propriedades:
   // Entalpia:
   /// Entalpia do ar seco
-  virtual double h_a_(double T);
+  virtual double h_a_(double T) const;
   /// Entalpia do vapor saturado
-  virtual double h_v_(double T);
+  virtual double h_v_(double T, int *err=0) const;
   /// Entalpia da gua saturada
-  virtual double h_l_(double T);
+  virtual double h_l_(double T) const;
   /// Entalpia do gelo saturado
-  virtual double h_s_(double T);
+  virtual double h_s_(double T) const;
   /// Entalpia do gelo (T < 273.15K) ou gua (T >= 273.15)
-  virtual double h_f_(double T);
+  virtual double h_f_(double T) const;
+  /// Derivada da entalpia da fase condensada (calor especfico)
+  virtual double dh_f_(double T) const;
+  /// Derivada da entalpia do ar seco (calor especfico)
+  virtual double dh_a_(double T) const;
+  /// Derivada da entalpia do vapor saturado (calor especfico)
+  virtual double dh_v_(double T) const;
   /// Entalpia do ar mido
-  virtual double h_(double T, double xv);
+  virtual double h_(double T, double xv) const;
 
   // volume:
   /// Volume especfico do ar seco
-  virtual double v_a_(double T, double P);
+  virtual double v_a_(double T, double P, int *err=0) const;
   /// Volume especfico do vapor saturado
-  virtual double v_v_(double T);
+  virtual double v_v_(double T, int *err=0) const;
   /// Volume especifico da gua saturada
-  virtual double v_l_(double T);
+  virtual double v_l_(double T) const;
   /// Volume especifico do gelo saturado
-  virtual double v_s_(double T);
+  virtual double v_s_(double T) const;
   /// Volume especifico da fase lquida (T>=273.15) ou slida (T < 273.15) saturada
-  virtual double v_f_(double T);
+  virtual double v_f_(double T) const;
+  /// Volume especifico da fase condensada de n temperaturas (verso vetorial de v_f_)
+  virtual void vfBatch(size_t n, const double *T, double *v) const;
   /// Volume especifico do vapor saturado
-  virtual double v_(double T, double P, double xv);
+  virtual double v_(double T, double P, double xv, int *err=0) const;
   
 
   // Volume molar
   //
-  virtual double vM_a_(double T, double P);
-  virtual double vM_v_(double T);
-  virtual double vM_l_(double T);
-  virtual double vM_s_(double T);
-  virtual double vM_f_(double T);
-  virtual double vM_(double T, double P, double xv);
+  virtual double vM_a_(double T, double P, int *err=0) const;
+  virtual double vM_v_(double T, int *err=0) const;
+  virtual double vM_l_(double T) const;
+  virtual double vM_s_(double T) const;
+  virtual double vM_f_(double T) const;
+  virtual double vM_(double T, double P, double xv, int *err=0) const;
 
   // Densidade
   // volume:
-  virtual double r_a_(double T, double P);
-  virtual double r_v_(double T);
-  virtual double r_l_(double T);
-  virtual double r_s_(double T);
-  virtual double r_f_(double T);
-  virtual double r_(double T, double P, double xv);
+  virtual double r_a_(double T, double P, int *err=0) const;
+  virtual double r_v_(double T, int *err=0) const;
+  virtual double r_l_(double T) const;
+  virtual double r_s_(double T) const;
+  virtual double r_f_(double T) const;
+  virtual double r_(double T, double P, double xv, int *err=0) const;
   
   // Entropia...  (ainda no implementado)
 
 
   /// Funo auxiliar que faz o balano de energia em um saturador adiabtico. Ustilizado para calcular o TBU.
-  double BcalcW(double b, double P, double T);
+  double BcalcW(double b, double P, double T, double w, double *df=0) const;
+
+  /// Algoritmos das funes de sada para o modelo do tipo Model (ver gas_perfeito_kernel.h)
+  template<class Model> struct Kernel;
+
+  /// \name Verses vetoriais das funes em lote para o vetor V (ver PSYCHRO_SIMD_DISPATCH em vecmath.h)
+  ///@{
+  template<class V> void TwsLanes(size_t n, const double *P, double *T, int *err) const;
+  template<class V> void PwsLanes(size_t n, const double *T, double *p) const;
+  template<class V> void vfLanes(size_t n, const double *T, double *v) const;
+  template<class V> void WETBULBLanes(size_t n, const double *T, const double *P, const double *W,
+				      double *B, int *err) const;
+  ///@}
   
 
 };
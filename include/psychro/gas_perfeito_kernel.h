@@ -0,0 +1,264 @@
+/*! \file gas_perfeito_kernel.h
+
+\brief Algoritmos das funes de sada da classe GasPerfeito
+
+As funes de sada de GasPerfeito (state, DENSITY, WETBULB, ...) esto implementadas aqui como funes estticas da estrutura GasPerfeito::Kernel<Model>, onde Model  o tipo do modelo. As funes virtuais da classe chamam Kernel<GasPerfeito>, cujas chamadas internas (Pws, h_f_, ...) so virtuais, de modo que as classes derivadas que redefinem correlaes continuam funcionando, ou, se o tipo dinmico tem as correlaes da biblioteca, Kernel<GasPerfeitoModel>, em que so expandidas (ver models.h).
+*/
+
+#ifndef _gas_perfeito_kernel_h
+#define _gas_perfeito_kernel_h
+
+#include <cmath>
+
+#include "correlations.h"
+
+
+/*! \brief Algoritmos do modelo de gs perfeito para o modelo do tipo Model
+
+Ver a documentao das funes de mesmo nome da classe GasPerfeito.
+*/
+template<class Model>
+struct GasPerfeito::Kernel{
+
+  static MoistAirState state(const Model &m, double T, char ch, double umidade, double P,
+			     SolverContext *c=0){
+    double B, Rel, D;
+    int ep = 0;			// Erro da presso de vapor (ver Pws)
+    MoistAirState s;
+    s.T = T;
+    s.P = P;
+    s.xv = 0.0;
+    s.W = 0.0;
+
+    // Verificar faixa de temperatura e presso
+    s.status = m.FaixaT(T);
+    if (!s.status) s.status = m.FaixaP(P);
+
+
+    double XSV;
+    switch(ch){
+    case 'X':			// Frao molar de vapor
+      s.xv = umidade;
+      // Verificar a faixa de frao molar
+      XSV = m.eFactor(T, P) * m.Pws(T, &ep) / P;
+      if (s.xv < 0.0 || s.xv > XSV) {
+	s.status = 16;
+      }
+      s.W = Mv/Ma * s.xv/(1.0 - s.xv);
+      break;
+    case 'W':			// Teor de umidade
+      s.W = umidade;
+      s.xv = s.W / (Mv/Ma + s.W);
+      XSV = m.eFactor(T, P) * m.Pws(T, &ep) / P;
+      if (s.xv < 0.0 || s.xv > XSV) {
+	s.status = 15;
+      }
+
+      break;
+    case 'R':			// UMidade relativa
+      Rel = umidade;
+      if (Rel < 0.0){
+	s.status = 12; Rel = 0.0;
+      }
+      s.xv = Rel * m.Pws(T, &ep) / P;
+      s.W = Mv/Ma * s.xv/(1.0 - s.xv);
+      break;
+
+    case 'B':			// Temp. de bulbo mido
+      // A aproximao linear facilita mesmo estes clculos...
+      B = umidade;
+      double psat, w2, hs, hw;
+      if (B > T){
+	s.status = 14; B = T;
+      }
+      psat = m.Pws(B, &ep);
+      w2 = Mv/Ma * psat / (P - psat);
+      hs = m.h_a_(B) + w2 * m.h_v_(B);
+      hw = m.h_f_(B);
+      s.W = (hs - m.h_a_(T) - w2 * hw) / (m.h_v_(T) - hw);
+      s.xv = s.W / (Mv/Ma + s.W);
+
+      break;
+    case 'D':			// Ponto de orvalho
+      D = umidade;
+      if (D > T){
+	s.status = 13; D = T;
+      }
+      s.xv = m.Pws(D, &ep)/P;
+      s.W = Mv/Ma * s.xv/(1.0 - s.xv);
+      break;
+
+    };
+    // No encobre um erro de faixa ou de umidade
+    if (ep && !s.status) s.status = ep;
+
+    if (c) c->update(s);
+    return s;
+  }
+
+
+  /// \name Correlaes compostas (ver as funes de mesmo nome de GasPerfeito)
+  ///@{
+  static double h_(const Model &m, double T, double xv){
+    double xa = 1.0 - xv;
+    double M = xa * Ma + xv * Mv;
+
+    return (xa * m.h_a_(T) * Ma + xv * m.h_v_(T) * Mv) / M;
+  }
+
+  static double v_l_(const Model &m, double Tk){
+    return 1/m.r_l_(Tk);
+  }
+
+  static double v_f_(const Model &m, double Tk){
+    if (Tk < 273.15)
+      return m.v_s_(Tk);
+    else
+      return m.v_l_(Tk);
+  }
+  ///@}
+
+  static double VOLUME(const Model &m, const MoistAirState &s, int *err){
+    return (1.0+s.W) / m.DENSITY(s, err);
+  }
+
+  static double DENSITY(const Model &, const MoistAirState &s, int *){
+    // Calcula a massa especfica do ar mido
+    double Mm = s.xv * Mv + (1.0 - s.xv) * Ma;
+    return s.P * Mm / (R*s.T);
+  }
+
+  static double DEWPOINT(const Model &m, const MoistAirState &s, int *err, SolverContext *c=0){
+    // Explcito: o contexto apenas acompanha a srie
+    if (c) c->update(s);
+    return m.Tws(s.xv * s.P, err);
+  }
+
+  static double ENTHALPY(const Model &m, const MoistAirState &s, int *){
+    return m.h_(s.T, s.xv)*(1.0 + s.W);
+  }
+
+  static double RELHUM(const Model &m, const MoistAirState &s, int *err){
+    return s.xv*s.P/m.Pws(s.T, err);
+  }
+
+  static MoistAirProperties evaluate_all(const Model &m, const MoistAirState &s, unsigned mask){
+    MoistAirCache c;
+    return evaluate(m, c, s, mask);
+  }
+
+  static const MoistAirProperties &evaluate(const Model &m, MoistAirCache &c, const MoistAirState &s,
+					    unsigned mask){
+    c.update(s);
+    MoistAirProperties &r = c.props;
+    int *err = &r.status;
+    unsigned n = c.need(mask & PROP_ALL);
+
+    // O volume  obtido da massa especfica
+    if (n & (PROP_DENSITY | PROP_VOLUME)){
+      double rho = m.DENSITY(s, err);
+      if (n & PROP_DENSITY) r.density = rho;
+      if (n & PROP_VOLUME) r.volume = (1.0+s.W) / rho;
+    }
+    if (n & PROP_ENTHALPY) r.enthalpy = ENTHALPY(m, s, err);
+    if (n & PROP_RELHUM){
+      if (c.need(MoistAirCache::PWS)) c.Pws = m.Pws(s.T, err);
+      r.relhum = s.xv*s.P/c.Pws;
+    }
+    if (n & PROP_DEWPOINT) r.dewpoint = DEWPOINT(m, s, err);
+    if (n & PROP_WETBULB) r.wetbulb = WETBULB(m, s, err);
+    return r;
+  }
+
+  static void grid(const Model &m, double T, size_t nP, const double *P, char ch, size_t nU,
+		   const double *umidade, const MoistAirColumns &out){
+    unsigned mask = 0;
+    if (out.density) mask |= PROP_DENSITY;
+    if (out.volume) mask |= PROP_VOLUME;
+    if (out.enthalpy) mask |= PROP_ENTHALPY;
+    if (out.relhum) mask |= PROP_RELHUM;
+    if (out.dewpoint) mask |= PROP_DEWPOINT;
+    if (out.wetbulb) mask |= PROP_WETBULB;
+
+    // A presso de saturao depende apenas de T; fora da faixa da correlao  recalculada
+    // em cada ponto, para que o erro seja registrado
+    int ep = 0;
+    double pws = m.Pws(T, &ep);
+    MoistAirCache c;
+
+    for (size_t j = 0; j < nP; ++j)
+      for (size_t k = 0; k < nU; ++k){
+	size_t i = j*nU + k;
+	MoistAirState s = state(m, T, ch, umidade[k], P[j]);
+	c.update(s);
+	if (!ep){
+	  c.Pws = pws;
+	  c.valid |= MoistAirCache::PWS;
+	}
+	const MoistAirProperties &r = evaluate(m, c, s, mask);
+
+	if (out.W) out.W[i] = s.W;
+	if (out.xv) out.xv[i] = s.xv;
+	if (out.density) out.density[i] = r.density;
+	if (out.volume) out.volume[i] = r.volume;
+	if (out.enthalpy) out.enthalpy[i] = r.enthalpy;
+	if (out.relhum) out.relhum[i] = r.relhum;
+	if (out.dewpoint) out.dewpoint[i] = r.dewpoint;
+	if (out.wetbulb) out.wetbulb[i] = r.wetbulb;
+	if (out.status) out.status[i] = r.status;
+      }
+  }
+
+  static double WETBULB(const Model &m, const MoistAirState &s, int *err, SolverContext *c=0){
+    double T = s.T;
+    double P = s.P;
+
+    // Chute inicial: o bulbo mido da amostra anterior, se houver
+    double b = T - 1.0, db;
+    if (c){
+      c->update(s);
+      // Perto de 273.15 a equao tem uma raiz no gelo e outra na gua: a estimativa s 
+      // utilizada se estiver do mesmo lado que T - 1, para que a raiz encontrada seja a mesma
+      if (c->wetbulb && (c->wetbulb < 273.15) == (b < 273.15)) b = (c->wetbulb < T) ? c->wetbulb : T;
+      c->wetbulb = 0;
+    }
+    double f, df;
+    const double EPS=m.tol.wetbulb;
+    const int NMAX = 100;
+    for (int iter = 0; iter < NMAX; ++iter){
+      if (c) ++c->iterations;
+      f = BcalcW(m, b, P, T, s.W, &df);
+      db = - f / df;
+      b = b + db;
+      // Um passo que atravessa 273.15 no indica convergncia: a entalpia da fase condensada  descontnua.
+      // A derivada de BcalcW  exata e a convergncia  quadrtica (ver Tolerances)
+      if ((fabs(db) < EPS || db*db < EPS) && (b < 273.15) == (b - db < 273.15)){
+	if (c) c->wetbulb = b;
+	return b;
+      }
+    }
+
+    if (err) *err = 100;		// No convergiu no nmero de etapas certas, erro
+    return(b);
+  }
+
+  static double BcalcW(const Model &m, double b, double P, double T, double w, double *df){
+    // Calcular w2
+    double dp;
+    double p = m.PwsdPws(b, dp);
+    double w2 = Mv / Ma * p / (P - p);
+    double hv = m.h_v_(b);
+    double hf = m.h_f_(b);
+
+    if (df){
+      // Calores especficos do ar, vapor e fase condensada do modelo
+      double cpf = m.dh_f_(b);
+      double dw2 = Mv / Ma * P * dp / ((P - p)*(P - p));
+      *df = w*cpf + m.dh_a_(b) + dw2*(hv - hf) + w2*(m.dh_v_(b) - cpf);
+    }
+
+    return -w*(m.h_v_(T) - hf) + m.h_a_(b) - m.h_a_(T) + w2*(hv - hf);
+  }
+};
+
+#endif
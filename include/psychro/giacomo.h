@@ -32,9 +32,55 @@ A metodologia de Giacomo 
 class Giacomo: public Ashrae{
  public:
   
-  virtual double Z(double T, double P, double xv); // Compressibilidade
-  virtual double Pws(double T);  	// Presso de saturao de vapor
-  virtual double eFactor(double T, double P);	// Enhancement factor
+  virtual double Z(double T, double P, double xv, int *err=0) const; // Compressibilidade
+  virtual double vMfromVirial(const VirialSet &v, double T, double P, double xv, int *err=0) const;
+  virtual void ZBatch(size_t n, const double *T, const double *P, const double *xv,
+		      double *Z, int *err=0) const;
+  virtual double Pws(double T, int *err=0) const;  	// Presso de saturao de vapor
+  virtual double dPws(double T) const;  	// Derivada da presso de saturao de vapor
+  virtual double PwsdPws(double T, double &dP) const;
+  virtual void PwsBatch(size_t n, const double *T, double *p) const;
+  virtual void PwsdPwsBatch(size_t n, const double *T, double *p, double *dp) const;
+  virtual double eFactor(double T, double P) const;	// Enhancement factor
+  virtual double eFactor(const SaturationPoint &sp, double P, int *err=0) const;	// Enhancement factor
+  virtual double eFactor(const SaturationPoint &sp, double P, double f0, int *err=0) const;
+  virtual void eFactorBatch(size_t n, const double *T, const double *P, double *f,
+			    int *err=0) const;
+  virtual void batchFloat(size_t n, char ch, const float *T, const float *umidade,
+			  const float *P, const MoistAirColumnsF &out) const;
+  virtual bool nativeBatch() const;
+  virtual unsigned fastTables() const;
+
+  /// \name Funes de sada com o modelo esttico GiacomoStatic (ver models.h)
+  ///@{
+  using Ashrae::ENTHALPY;
+  using Ashrae::VOLUME;
+  using Ashrae::DENSITY;
+  using Ashrae::WETBULB;
+  using Ashrae::DEWPOINT;
+  using Ashrae::RELHUM;
+  virtual MoistAirState state(double T, char ch, double umidade, double P) const;
+  virtual MoistAirState state(double T, char ch, double umidade, double P, SolverContext &c) const;
+  virtual double ENTHALPY(const MoistAirState &s, int *err=0) const;
+  virtual double VOLUME(const MoistAirState &s, int *err=0) const;
+  virtual double DENSITY(const MoistAirState &s, int *err=0) const;
+  virtual double WETBULB(const MoistAirState &s, int *err=0) const;
+  virtual double WETBULB(const MoistAirState &s, SolverContext &c, int *err=0) const;
+  virtual double DEWPOINT(const MoistAirState &s, int *err=0) const;
+  virtual double DEWPOINT(const MoistAirState &s, SolverContext &c, int *err=0) const;
+  virtual double RELHUM(const MoistAirState &s, int *err=0) const;
+  virtual MoistAirProperties evaluate_all(const MoistAirState &s, unsigned mask=PROP_ALL) const;
+  virtual const MoistAirProperties &evaluate(MoistAirCache &c, const MoistAirState &s,
+					     unsigned mask=PROP_ALL) const;
+  virtual void gridRow(double T, size_t nP, const double *P, char ch, size_t nU,
+		       const double *umidade, const MoistAirColumns &out) const;
+  ///@}
+
+  /// \name Verses vetoriais das funes em lote para o vetor V (ver PSYCHRO_SIMD_DISPATCH em vecmath.h)
+  ///@{
+  template<class V> void PwsLanes(size_t n, const double *T, double *p) const;
+  template<class V> void PwsdPwsLanes(size_t n, const double *T, double *p, double *dp) const;
+  ///@}
   
 };  
   
@@ -0,0 +1,15 @@
+/*! \file grid.h
+
+\brief Clculo das propriedades numa malha T  P  umidade
+*/
+
+#ifndef _grid_h
+#define _grid_h
+
+
+/// Propriedades em todos os pontos da malha T  P  umidade, com os planos de temperatura divididos entre vrias threads. Retorna o nmero de threads utilizadas
+int grid_eval(const Psychro &m, size_t nT, const double *T, size_t nP, const double *P,
+	      char ch, size_t nU, const double *umidade, const MoistAirColumns &out,
+	      const ParallelOptions &opt=ParallelOptions());
+
+#endif
@@ -0,0 +1,46 @@
+/*! \file mixed.h
+
+\brief Clculo em lote com tipos de umidade diferentes em cada amostra
+*/
+
+#ifndef _mixed_h
+#define _mixed_h
+
+#include <vector>
+
+
+/*! \brief Permutao estvel que agrupa as amostras pelo tipo de umidade
+
+Depois de build, as amostras perm[start[k]], ..., perm[start[k+1]-1] so as do tipo kind[k], na ordem original. Os caracteres que no so tipos de umidade ('R', 'W', 'X', 'D' ou 'B') ficam no ltimo grupo: para Psychro::set todos eles so equivalentes.
+*/
+struct KindBuckets{
+  /// Nmero de grupos
+  static const int NKIND = 6;
+  /// Tipo de umidade de cada grupo
+  char kind[NKIND];
+  /// Incio de cada grupo em perm (start[NKIND]  o nmero de amostras)
+  size_t start[NKIND+1];
+  /// ndices das amostras agrupadas por tipo
+  std::vector<size_t> perm;
+
+  /// ndice do grupo do tipo de umidade ch
+  static int index(char ch){
+    switch(ch){
+    case 'R': return 0;
+    case 'W': return 1;
+    case 'X': return 2;
+    case 'D': return 3;
+    case 'B': return 4;
+    default: return 5;
+    }
+  }
+
+  void build(size_t n, const char *ch);
+};
+
+
+/// Clculo em lote com o tipo de umidade ch[i] na amostra i (ver Psychro::batch)
+void mixed_batch(const Psychro &m, size_t n, const char *ch, const double *T,
+		 const double *umidade, const double *P, const MoistAirColumns &out);
+
+#endif
@@ -0,0 +1,457 @@
+/*! \file models.h
+
+\brief Modelos compostos estaticamente
+
+Os modelos GasPerfeito, Ashrae e Giacomo como tipos sem funes virtuais. As correlaes (ver correlations.h) so funes membro inline e os algoritmos so os de GasPerfeito::Kernel e Ashrae::Kernel instanciados para o prprio tipo, de modo que o compilador pode expandir todas as chamadas internas das iteraes (WETBULB, DEWPOINT, CalcWfromB, eFactor, ...).
+
+As diferenas entre Ashrae e Giacomo (presso de vapor, enhancement factor e compressibilidade) so polticas, parmetros do template AshraeModel:
+
+- AshraePws e GiacomoPws: Pws, dPws e PwsdPws;
+- AshraeEFactor e GiacomoEFactor: eFactor;
+- AshraeZ e GiacomoZ: Z e vMfromVirial.
+
+Cada poltica tem tambm uma verso vetorial (PwsdPwsLanes, eFactorLanes e vMLanes), template do vetor V, utilizada pelo clculo em lote em float (ver Ashrae::LaneKernel em ashrae_lanes.h).
+
+As polticas so templates do tipo do modelo: as funes virtuais de Ashrae e Giacomo so as mesmas polticas instanciadas para a prpria classe (as chamadas internas continuam virtuais, e uma classe derivada que redefine uma correlao continua funcionando), e AshraeStatic e GiacomoStatic so as instncias estticas.
+
+Um modelo esttico  construdo a partir do objeto correspondente, do qual utiliza as tolerncias, as opes (perfectGasSeed e virialMethod) e as tabelas do modo rpido, e existe apenas durante uma chamada. As funes de sada de GasPerfeito, Ashrae e Giacomo o utilizam quando o tipo dinmico tem as correlaes da biblioteca (ver GasPerfeito::nativeBatch); os resultados so os mesmos das funes virtuais.
+*/
+
+#ifndef _models_h
+#define _models_h
+
+#include "psychro.h"
+#include "correlations.h"
+#include "gas_perfeito_kernel.h"
+#include "ashrae_kernel.h"
+#include "ashrae_lanes.h"
+
+#if defined(__GNUC__)
+// Funes que retornam vetores de vecmath.h (ver o aviso de mudana de ABI em vecmath.h)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+
+
+/*! \brief Modelo de gs perfeito composto estaticamente (ver GasPerfeito)
+ */
+class GasPerfeitoModel{
+  const GasPerfeito &g;
+ public:
+  typedef GasPerfeitoCorrelations C;
+  typedef GasPerfeito::Kernel<GasPerfeitoModel> K;
+
+  const Tolerances &tol;
+
+  explicit GasPerfeitoModel(const GasPerfeito &gp): g(gp), tol(gp.tol) {}
+
+  int FaixaT(double T) const { return g.FaixaT(T); }
+  int FaixaP(double P) const { return g.FaixaP(P); }
+
+  double eFactor(double, double) const { return 1.0; }
+  double Pws(double T, int *err=0) const { return C::Pws(T, err); }
+  double dPws(double T) const { return C::dPws(T); }
+  double PwsdPws(double T, double &dP) const { return C::PwsdPws(T, dP); }
+  double Tws(double P, int *err=0) const { return C::Tws(P, err); }
+
+  double h_a_(double T) const { return C::h_a(T); }
+  double h_v_(double T, int * =0) const { return C::h_v(T); }
+  double h_f_(double T) const { return C::h_f(T); }
+  double dh_f_(double T) const { return C::dh_f(T); }
+  double dh_a_(double) const { return 1006.0; }
+  double dh_v_(double) const { return 1805.0; }
+  double h_(double T, double xv) const { return K::h_(*this, T, xv); }
+
+  MoistAirState state(double T, char ch, double umidade, double P) const{
+    return K::state(*this, T, ch, umidade, P);
+  }
+  MoistAirState state(double T, char ch, double umidade, double P, SolverContext &c) const{
+    return K::state(*this, T, ch, umidade, P, &c);
+  }
+  double ENTHALPY(const MoistAirState &s, int *err=0) const { return K::ENTHALPY(*this, s, err); }
+  double VOLUME(const MoistAirState &s, int *err=0) const { return K::VOLUME(*this, s, err); }
+  double DENSITY(const MoistAirState &s, int *err=0) const { return K::DENSITY(*this, s, err); }
+  double WETBULB(const MoistAirState &s, int *err=0) const { return K::WETBULB(*this, s, err); }
+  double WETBULB(const MoistAirState &s, SolverContext &c, int *err=0) const{
+    return K::WETBULB(*this, s, err, &c);
+  }
+  double DEWPOINT(const MoistAirState &s, int *err=0) const { return K::DEWPOINT(*this, s, err); }
+  double DEWPOINT(const MoistAirState &s, SolverContext &c, int *err=0) const{
+    return K::DEWPOINT(*this, s, err, &c);
+  }
+  double RELHUM(const MoistAirState &s, int *err=0) const { return K::RELHUM(*this, s, err); }
+  MoistAirProperties evaluate_all(const MoistAirState &s, unsigned mask=PROP_ALL) const{
+    return K::evaluate_all(*this, s, mask);
+  }
+  const MoistAirProperties &evaluate(MoistAirCache &c, const MoistAirState &s,
+				     unsigned mask=PROP_ALL) const{
+    return K::evaluate(*this, c, s, mask);
+  }
+  void gridRow(double T, size_t nP, const double *P, char ch, size_t nU,
+	       const double *umidade, const MoistAirColumns &out) const{
+    K::grid(*this, T, nP, P, ch, nU, umidade, out);
+  }
+};
+
+
+/*! \brief Presso de vapor da ASHRAE (ver Ashrae::Pws): gelo abaixo de 273.15, gua acima, com as tabelas do modo rpido
+ */
+struct AshraePws{
+  template<class Model>
+  static double Pws(const Model &m, double Tk){
+    double p;
+    if (m.fast && m.fast->Pws(Tk, p)) return p;
+
+    if (Tk < 273.15) return m.Pws_s(Tk);
+
+    return m.Pws_l(Tk);
+  }
+
+  template<class Model>
+  static double dPws(const Model &m, double Tk){
+    if (Tk < 273.15) return m.dPws_s(Tk);
+
+    return m.dPws_l(Tk);
+  }
+
+  template<class Model>
+  static double PwsdPws(const Model &m, double Tk, double &dP){
+    double p;
+    if (m.fast && m.fast->Pws(Tk, p, &dP)) return p;
+
+    return AshraeCorrelations::PwsdPws(Tk, dP);
+  }
+
+  /// PwsdPws de vtraits<V>::L temperaturas, sem as tabelas do modo rpido (ver Ashrae::PwsdPwsBatch)
+  template<class Model, class V>
+  static V PwsdPwsLanes(const Model &, const V &Tk, V &dP){
+    V dlnP;
+    V P = vexp(AshraeCorrelations::lnPws(Tk, &dlnP));
+    dP = P * dlnP;
+    return P;
+  }
+};
+
+/*! \brief Presso de vapor de Giacomo (ver Giacomo::Pws)
+ */
+struct GiacomoPws{
+  template<class Model>
+  static double Pws(const Model &, double T){
+    return GiacomoCorrelations::Pws(T);
+  }
+
+  template<class Model>
+  static double dPws(const Model &m, double T){
+    return m.Pws(T) * GiacomoCorrelations::dlnPws(T);
+  }
+
+  template<class Model>
+  static double PwsdPws(const Model &m, double T, double &dP){
+    double P = m.Pws(T);
+    dP = P * GiacomoCorrelations::dlnPws(T);
+    return P;
+  }
+
+  /// PwsdPws de vtraits<V>::L temperaturas (ver Giacomo::PwsdPwsBatch)
+  template<class Model, class V>
+  static V PwsdPwsLanes(const Model &, const V &T, V &dP){
+    V P = GiacomoCorrelations::Pws(T);
+    dP = P * GiacomoCorrelations::dlnPws(T);
+    return P;
+  }
+};
+
+
+/*! \brief Enhancement factor da ASHRAE (ver Ashrae::eFactor): substituies sucessivas de ln f
+ */
+struct AshraeEFactor{
+  template<class Model>
+  static double eFactor(const Model &m, double Tk, double P){
+    double f;
+    if (m.fast && m.fast->eFactor(Tk, P, f)) return f;
+    return m.eFactor(m.saturation(Tk), P);
+  }
+
+  template<class Model>
+  static double eFactor(const Model &m, const Ashrae::SaturationPoint &sp, double P, double f0,
+			int *err){
+    double f;
+    if (m.fast && m.fast->eFactor(sp.T, P, f)) return f;
+
+    f = f0;
+    const double EPS = m.tol.eFactor;
+    const int NMAX = 50;
+    double xas;
+    double fnovo;
+
+    for(int iter=0; iter < NMAX; ++iter){
+      xas = (P-f*sp.Pws)/P;
+      fnovo = exp(m.lnf(sp, P, xas));
+
+      if (fabs(fnovo - f) < EPS) {
+	if (fnovo < 1.0) fnovo = 1.0;
+	return(fnovo);
+      }
+
+      f = fnovo;
+    }
+
+    if (err) *err = 109;
+    if (fnovo < 1.0) fnovo = 1.0;
+    return fnovo;
+  }
+
+  /*! Enhancement factor de vtraits<V>::L estados a partir das grandezas de saturao sp, sem as tabelas do modo rpido (ver Ashrae::eFactorBatch)
+  \param EPS Tolerncia
+  \param fail Recebe a mscara dos elementos que no convergiram
+  */
+  template<class Model, class V>
+  static V eFactorLanes(const Model &, const SaturationLanes<V> &sp, const V &P,
+			typename vscalar<V>::type EPS, typename vtraits<V>::mask &fail){
+    typedef typename vtraits<V>::mask M;
+    const int NMAX = 50;
+    V fv = vset<V>(1.0);
+    M active = vnot(M());
+    for (int iter = 0; iter < NMAX && vany(active); ++iter){
+      V xas = (P - fv*sp.Pws)/P;
+      V fnovo = vexp(AshraeCorrelations::lnf(sp.T, P, xas, sp.Pws, sp.vc, sp.kappa, sp.k,
+					     sp.c[0], sp.c[1], sp.c[2], sp.c[3], sp.c[4], sp.c[5],
+					     sp.c[6]));
+      M conv = (M)(vfabs(fnovo - fv) < EPS);
+      fv = vselect(active, fnovo, fv);
+      active = active & vnot(conv);
+    }
+    fail = active;
+    return vselect((M)(fv < 1.0), vset<V>(1.0), fv);
+  }
+};
+
+/*! \brief Enhancement factor de Giacomo (ver Giacomo::eFactor): explcito, apenas a temperatura de sp  utilizada
+ */
+struct GiacomoEFactor{
+  template<class Model>
+  static double eFactor(const Model &, double T, double P){
+    return GiacomoCorrelations::eFactor(T, P);
+  }
+
+  template<class Model>
+  static double eFactor(const Model &m, const Ashrae::SaturationPoint &sp, double P, double,
+			int *){
+    return m.eFactor(sp.T, P);
+  }
+
+  /// Enhancement factor de vtraits<V>::L estados: explcito, fail  sempre falsa
+  template<class Model, class V>
+  static V eFactorLanes(const Model &, const SaturationLanes<V> &sp, const V &P,
+			typename vscalar<V>::type, typename vtraits<V>::mask &fail){
+    fail = typename vtraits<V>::mask();
+    return GiacomoCorrelations::eFactor(sp.T, P);
+  }
+};
+
+
+/*! \brief Compressibilidade da ASHRAE (ver Ashrae::Z): soluo da equao virial
+ */
+struct AshraeZ{
+  template<class Model>
+  static double Z(const Model &m, double Tk, double P, double xv, int *err){
+    Ashrae::VirialSet v = m.virial(Tk);
+
+    double vmi =  Psychro::R*Tk/P;
+    double vm = Ashrae::Kernel<Model>::vMvirial(m, Tk, P, v.Bm(xv), v.Cm(xv), 100,
+						m.tol.volume, 107, err);
+    return(vm/vmi);
+  }
+
+  template<class Model>
+  static double vMfromVirial(const Model &m, const Ashrae::VirialSet &v, double Tk, double P,
+			     double xv, int *err){
+    const double R = Psychro::R;
+    double vmi = R*Tk/P;
+    double z = Ashrae::Kernel<Model>::vMvirial(m, Tk, P, v.Bm(xv), v.Cm(xv), 100,
+					       m.tol.volume, 107, err) / vmi;
+    return z * R*Tk/P;
+  }
+
+  /*! Volume molar de vtraits<V>::L estados com os coeficientes viriais c em Tk (ver Ashrae::ZBatch)
+  \param EPS Tolerncia relativa no volume molar
+  \param fail Recebe a mscara dos elementos em que a equao virial no convergiu
+  */
+  template<class Model, class V>
+  static V vMLanes(const Model &m, const V &Tk, const V &P, const V &xv, const V c[14],
+		   typename vscalar<V>::type EPS, typename vtraits<V>::mask &fail){
+    V xa = 1.0 - xv;
+    V B = xa*xa*c[0] + 2*xa*xv*c[2] + xv*xv*c[1];
+    V C = xa*xa*xa*c[3] + 3*xa*xa*xv*c[5] + 3*xa*xv*xv*c[6] + xv*xv*xv*c[4];
+    return vMvirialLanes(m.virialMethod, Tk, P, B, C, 100, EPS, fail);
+  }
+};
+
+/*! \brief Compressibilidade de Giacomo (ver Giacomo::Z): explcita, sem os coeficientes viriais
+ */
+struct GiacomoZ{
+  template<class Model>
+  static double Z(const Model &, double T, double P, double xv, int *){
+    return GiacomoCorrelations::Z(T, P, xv);
+  }
+
+  template<class Model>
+  static double vMfromVirial(const Model &m, const Ashrae::VirialSet &, double T, double P,
+			     double xv, int *err){
+    return m.vM_(T, P, xv, err);
+  }
+
+  /// Volume molar de vtraits<V>::L estados: explcito, fail  sempre falsa
+  template<class Model, class V>
+  static V vMLanes(const Model &, const V &T, const V &P, const V &xv, const V *,
+		   typename vscalar<V>::type, typename vtraits<V>::mask &fail){
+    const typename vscalar<V>::type R = Psychro::R;
+    fail = typename vtraits<V>::mask();
+    return GiacomoCorrelations::Z(T, P, xv) * (R*T/P);
+  }
+};
+
+
+/*! \brief Modelo da ASHRAE composto estaticamente (ver Ashrae)
+
+As correlaes de Ashrae so funes inline de AshraeCorrelations e GasPerfeitoCorrelations; a presso de vapor, o enhancement factor e a compressibilidade so as das polticas PwsP, EFactorP e ZP. Ver AshraeStatic e GiacomoStatic.
+*/
+template<class PwsP, class EFactorP, class ZP>
+class AshraeModel{
+  const Ashrae &a;
+ public:
+  typedef Ashrae::VirialSet VirialSet;
+  typedef Ashrae::SaturationPoint SaturationPoint;
+  typedef AshraeCorrelations C;
+  typedef GasPerfeitoCorrelations G;
+  typedef Ashrae::Kernel<AshraeModel> K;
+
+  const Tolerances &tol;
+  bool perfectGasSeed;
+  Ashrae::VirialMethod virialMethod;
+  /// Tabelas do modo rpido de a (nulo no modo exato)
+  const Ashrae::FastTables *fast;
+
+  explicit AshraeModel(const Ashrae &m): a(m), tol(m.tol), perfectGasSeed(m.perfectGasSeed),
+					 virialMethod(m.virialMethod), fast(m.fast.get()) {}
+
+  /// Modelo de gs perfeito dos valores iniciais (ver Ashrae::seedModel)
+  static const GasPerfeitoModel &seedModel(){
+    static const GasPerfeitoModel g(Ashrae::seedModel());
+    return g;
+  }
+
+  int FaixaT(double T) const { return a.FaixaT(T); }
+  int FaixaP(double P) const { return a.FaixaP(P); }
+
+  // Presso de vapor
+  double Pws_s(double T) const { return C::Pws_s(T); }
+  double Pws_l(double T) const { return C::Pws_l(T); }
+  double dPws_s(double T) const { return Pws_s(T) * C::dlnPws_s(T); }
+  double dPws_l(double T) const { return Pws_l(T) * C::dlnPws_l(T); }
+  double Pws(double T, int * =0) const { return PwsP::Pws(*this, T); }
+  double dPws(double T) const { return PwsP::dPws(*this, T); }
+  double PwsdPws(double T, double &dP) const { return PwsP::PwsdPws(*this, T, dP); }
+  double Tws0(double P) const { return K::Tws0(*this, P); }
+  double Tws(double P, int *err=0) const { return K::Tws(*this, P, err); }
+
+  // Fase condensada e solubilidade do ar
+  double r_l_(double T) const { return G::r_l(T); }
+  double v_l_(double T) const { return GasPerfeito::Kernel<AshraeModel>::v_l_(*this, T); }
+  double v_s_(double T) const { return G::v_s(T); }
+  double v_f_(double T) const { return GasPerfeito::Kernel<AshraeModel>::v_f_(*this, T); }
+  double kappa_s(double T) const { return C::kappa_s(T); }
+  double kappa_l(double T) const { return C::kappa_l(T); }
+  double kappa_f(double T) const { return K::kappa_f(*this, T); }
+  double henryk_O2(double T) const { return C::henryk_O2(T); }
+  double henryk_N2(double T) const { return C::henryk_N2(T); }
+  double henryk(double T) const { return K::henryk(*this, T); }
+
+  // Coeficientes viriais e enhancement factor
+  VirialSet virial(double T) const { return C::virialSet(T); }
+  SaturationPoint saturation(double T) const { return K::saturation(*this, T); }
+  double lnf(const SaturationPoint &sp, double P, double xas) const { return C::lnf(sp, P, xas); }
+  double eFactor(double T, double P) const { return EFactorP::eFactor(*this, T, P); }
+  double eFactor(const SaturationPoint &sp, double P, int *err=0) const{
+    return EFactorP::eFactor(*this, sp, P, 1.0, err);
+  }
+  double eFactor(const SaturationPoint &sp, double P, double f0, int *err=0) const{
+    return EFactorP::eFactor(*this, sp, P, f0, err);
+  }
+
+  // Volumes
+  double Z(double T, double P, double xv, int *err=0) const { return ZP::Z(*this, T, P, xv, err); }
+  double vMfromVirial(const VirialSet &v, double T, double P, double xv, int *err=0) const{
+    return ZP::vMfromVirial(*this, v, T, P, xv, err);
+  }
+  double vM_(double T, double P, double xv, int *err=0) const { return K::vM_(*this, T, P, xv, err); }
+  double v_(double T, double P, double xv, int *err=0) const { return K::v_(*this, T, P, xv, err); }
+  double r_(double T, double P, double xv, int *err=0) const { return K::r_(*this, T, P, xv, err); }
+  double vM_a_(double T, double P, int *err=0) const { return K::vM_a_(*this, T, P, err); }
+  double vM_v_(double T, int *err=0) const { return K::vM_v_(*this, T, err); }
+
+  // Entalpias
+  double h_a_(double T, double P=101325.0, int *err=0) const { return K::h_a_(*this, T, P, err); }
+  double h_v_(double T, int *err=0) const { return K::h_v_(*this, T, err); }
+  double h_s_(double T) const { return K::h_s_(*this, T); }
+  double h_l_(double T) const { return K::h_l_(*this, T); }
+  double hlRef() const { return K::hlRef(*this); }
+  double h_f_(double T) const { return K::h_f_(*this, T); }
+  double dh_f_(double T) const { return K::dh_f_(*this, T); }
+  double hfSat(const SaturationPoint &sp, double ref, double *dh=0) const{
+    return C::hfSat(sp, ref, dh);
+  }
+  double h_(double T, double P, double xv, int *err=0) const { return K::h_(*this, T, P, xv, err); }
+
+  // Funes de sada
+  MoistAirState state(double T, char ch, double umidade, double P) const{
+    return K::state(*this, T, ch, umidade, P);
+  }
+  MoistAirState state(double T, char ch, double umidade, double P, SolverContext &c) const{
+    return K::state(*this, T, ch, umidade, P, &c);
+  }
+  double ENTHALPY(const MoistAirState &s, int *err=0) const { return K::ENTHALPY(*this, s, err); }
+  double VOLUME(const MoistAirState &s, int *err=0) const { return K::VOLUME(*this, s, err); }
+  double DENSITY(const MoistAirState &s, int *err=0) const { return K::DENSITY(*this, s, err); }
+  double WETBULB(const MoistAirState &s, int *err=0) const { return K::WETBULB(*this, s, err); }
+  double WETBULB(const MoistAirState &s, SolverContext &c, int *err=0) const{
+    return K::WETBULB(*this, s, err, &c);
+  }
+  double DEWPOINT(const MoistAirState &s, int *err=0) const { return K::DEWPOINT(*this, s, err); }
+  double DEWPOINT(const MoistAirState &s, SolverContext &c, int *err=0) const{
+    return K::DEWPOINT(*this, s, err, &c);
+  }
+  double RELHUM(const MoistAirState &s, int *err=0) const { return K::RELHUM(*this, s, err); }
+  MoistAirProperties evaluate_all(const MoistAirState &s, unsigned mask=PROP_ALL) const{
+    return K::evaluate_all(*this, s, mask);
+  }
+  const MoistAirProperties &evaluate(MoistAirCache &c, const MoistAirState &s,
+				     unsigned mask=PROP_ALL) const{
+    return K::evaluate(*this, c, s, mask);
+  }
+
+  // Verses vetoriais das polticas (ver Ashrae::LaneKernel)
+  template<class V> V PwsdPwsLanes(const V &T, V &dP) const{
+    return PwsP::PwsdPwsLanes(*this, T, dP);
+  }
+  template<class V> V eFactorLanes(const SaturationLanes<V> &sp, const V &P,
+				   typename vscalar<V>::type EPS,
+				   typename vtraits<V>::mask &fail) const{
+    return EFactorP::eFactorLanes(*this, sp, P, EPS, fail);
+  }
+  template<class V> V vMLanes(const V &T, const V &P, const V &xv, const V c[14],
+			      typename vscalar<V>::type EPS, typename vtraits<V>::mask &fail) const{
+    return ZP::vMLanes(*this, T, P, xv, c, EPS, fail);
+  }
+};
+
+/// Modelo da ASHRAE composto estaticamente
+typedef AshraeModel<AshraePws, AshraeEFactor, AshraeZ> AshraeStatic;
+/// Modelo de Giacomo composto estaticamente (as demais correlaes so as da ASHRAE)
+typedef AshraeModel<GiacomoPws, GiacomoEFactor, GiacomoZ> GiacomoStatic;
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+
+#endif
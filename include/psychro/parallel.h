@@ -0,0 +1,34 @@
+/*! \file parallel.h
+
+\brief Clculo em lote utilizando vrias threads
+*/
+
+#ifndef _parallel_h
+#define _parallel_h
+
+
+/*! \brief Opes de parallel_batch
+ */
+struct ParallelOptions{
+  /// Nmero de threads (0: nmero de processadores disponveis)
+  unsigned threads;
+  /// Menor bloco de amostras distribudo de uma vez
+  size_t minChunk;
+  /// Fixa cada thread em um processador (apenas Linux)
+  bool affinity;
+
+  ParallelOptions(): threads(0), minChunk(64), affinity(false){}
+};
+
+
+/// Clculo em lote dividido entre vrias threads (ver Psychro::batch)
+int parallel_batch(const Psychro &m, size_t n, char ch, const double *T,
+		   const double *umidade, const double *P, const MoistAirColumns &out,
+		   const ParallelOptions &opt=ParallelOptions());
+
+/// Clculo em lote dividido entre vrias threads com o tipo de umidade ch[i] na amostra i (ver mixed_batch)
+int parallel_batch(const Psychro &m, size_t n, const char *ch, const double *T,
+		   const double *umidade, const double *P, const MoistAirColumns &out,
+		   const ParallelOptions &opt=ParallelOptions());
+
+#endif
@@ -16,6 +16,371 @@ Este arquivo fornece a classe base utilizada pela biblioteca de psicrometria.
 #ifndef _psychro_h
 #define _psychro_h
 
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <atomic>
+
+/*! \brief Estado de uma mistura ar-vapor
+
+Estrutura simples (valor) que especifica completamente o ar mido: temperatura, presso e composio.  produzida pela funo Psychro::state e consumida pelas funes de sada constantes (DENSITY, ENTHALPY, ...). Como o estado pertence a quem chama e os modelos no so modificados por estas funes, uma nica instncia de um modelo pode ser utilizada simultaneamente por vrias threads.
+*/
+struct MoistAirState{
+  /// Temperatura de bulbo seco (K)
+  double T;
+  /// Presso (Pa)
+  double P;
+  /// Frao molar de vapor
+  double xv;
+  /// Teor de umidade kg de vapor / kg de ar seco
+  double W;
+  /// Cdigo de erro (0 se no houve problemas)
+  int status;
+};
+
+
+/*! \brief Colunas de sada do clculo em lote (Psychro::batch)
+
+Cada ponteiro aponta para um vetor com n elementos que recebe a propriedade correspondente de cada amostra. Ponteiros nulos indicam que a propriedade no deve ser calculada. As unidades so as mesmas das funes de sada.
+*/
+struct MoistAirColumns{
+  /// Teor de umidade kg de vapor / kg de ar seco
+  double *W;
+  /// Frao molar de vapor
+  double *xv;
+  /// Massa especfica \f$kg/m^3\f$
+  double *density;
+  /// Volume especfico \f$m^3/kg\f$ de ar seco
+  double *volume;
+  /// Entalpia J/kg de ar seco
+  double *enthalpy;
+  /// Umidade relativa
+  double *relhum;
+  /// Temperatura de ponto de orvalho K
+  double *dewpoint;
+  /// Temperatura de bulbo mido K
+  double *wetbulb;
+  /// Cdigo de erro de cada amostra
+  int *status;
+
+  MoistAirColumns(): W(0), xv(0), density(0), volume(0), enthalpy(0),
+		     relhum(0), dewpoint(0), wetbulb(0), status(0){}
+
+  /// Colunas que comeam na amostra i (os ponteiros nulos continuam nulos)
+  MoistAirColumns shift(size_t i) const{
+    MoistAirColumns c;
+    if (W) c.W = W + i;
+    if (xv) c.xv = xv + i;
+    if (density) c.density = density + i;
+    if (volume) c.volume = volume + i;
+    if (enthalpy) c.enthalpy = enthalpy + i;
+    if (relhum) c.relhum = relhum + i;
+    if (dewpoint) c.dewpoint = dewpoint + i;
+    if (wetbulb) c.wetbulb = wetbulb + i;
+    if (status) c.status = status + i;
+    return c;
+  }
+
+  /// Nmero de colunas de propriedades (todas exceto status)
+  static const int NCOL = 8;
+
+  /// Coluna de propriedade k, 0 <= k < NCOL, na ordem dos campos (W, xv, ..., wetbulb)
+  static double *MoistAirColumns::*column(int k){
+    static double *MoistAirColumns::* const c[NCOL] = {
+      &MoistAirColumns::W, &MoistAirColumns::xv, &MoistAirColumns::density,
+      &MoistAirColumns::volume, &MoistAirColumns::enthalpy, &MoistAirColumns::relhum,
+      &MoistAirColumns::dewpoint, &MoistAirColumns::wetbulb
+    };
+    return c[k];
+  }
+};
+
+
+/*! \brief Colunas de sada do clculo em lote em preciso simples (Psychro::batchFloat)
+
+Como MoistAirColumns, com as propriedades em float.
+*/
+struct MoistAirColumnsF{
+  /// Teor de umidade kg de vapor / kg de ar seco
+  float *W;
+  /// Frao molar de vapor
+  float *xv;
+  /// Massa especfica \f$kg/m^3\f$
+  float *density;
+  /// Volume especfico \f$m^3/kg\f$ de ar seco
+  float *volume;
+  /// Entalpia J/kg de ar seco
+  float *enthalpy;
+  /// Umidade relativa
+  float *relhum;
+  /// Temperatura de ponto de orvalho K
+  float *dewpoint;
+  /// Temperatura de bulbo mido K
+  float *wetbulb;
+  /// Cdigo de erro de cada amostra
+  int *status;
+
+  MoistAirColumnsF(): W(0), xv(0), density(0), volume(0), enthalpy(0),
+		      relhum(0), dewpoint(0), wetbulb(0), status(0){}
+
+  /// Coluna de propriedade k, 0 <= k < MoistAirColumns::NCOL, na mesma ordem de MoistAirColumns::column
+  static float *MoistAirColumnsF::*column(int k){
+    static float *MoistAirColumnsF::* const c[MoistAirColumns::NCOL] = {
+      &MoistAirColumnsF::W, &MoistAirColumnsF::xv, &MoistAirColumnsF::density,
+      &MoistAirColumnsF::volume, &MoistAirColumnsF::enthalpy, &MoistAirColumnsF::relhum,
+      &MoistAirColumnsF::dewpoint, &MoistAirColumnsF::wetbulb
+    };
+    return c[k];
+  }
+
+  /// Colunas que comeam na amostra i (os ponteiros nulos continuam nulos)
+  MoistAirColumnsF shift(size_t i) const{
+    MoistAirColumnsF c;
+    if (W) c.W = W + i;
+    if (xv) c.xv = xv + i;
+    if (density) c.density = density + i;
+    if (volume) c.volume = volume + i;
+    if (enthalpy) c.enthalpy = enthalpy + i;
+    if (relhum) c.relhum = relhum + i;
+    if (dewpoint) c.dewpoint = dewpoint + i;
+    if (wetbulb) c.wetbulb = wetbulb + i;
+    if (status) c.status = status + i;
+    return c;
+  }
+};
+
+
+/// Propriedades calculadas por Psychro::evaluate_all (combinadas com |)
+enum MoistAirProperty{
+  PROP_DENSITY = 1,
+  PROP_VOLUME = 2,
+  PROP_ENTHALPY = 4,
+  PROP_RELHUM = 8,
+  PROP_DEWPOINT = 16,
+  PROP_WETBULB = 32,
+  /// Todas as anteriores
+  PROP_ALL = 63
+};
+
+
+/*! \brief Propriedades de um estado calculadas juntas (Psychro::evaluate_all)
+
+As propriedades que no foram pedidas valem NaN. As unidades so as mesmas das funes de sada.
+*/
+struct MoistAirProperties{
+  /// Teor de umidade kg de vapor / kg de ar seco
+  double W;
+  /// Frao molar de vapor
+  double xv;
+  /// Massa especfica \f$kg/m^3\f$
+  double density;
+  /// Volume especfico \f$m^3/kg\f$ de ar seco
+  double volume;
+  /// Entalpia J/kg de ar seco
+  double enthalpy;
+  /// Umidade relativa
+  double relhum;
+  /// Temperatura de ponto de orvalho K
+  double dewpoint;
+  /// Temperatura de bulbo mido K
+  double wetbulb;
+  /// Cdigo de erro (parte do cdigo de erro do estado)
+  int status;
+
+  MoistAirProperties(const MoistAirState &s): W(s.W), xv(s.xv), density(NAN), volume(NAN),
+					      enthalpy(NAN), relhum(NAN), dewpoint(NAN),
+					      wetbulb(NAN), status(s.status){}
+};
+
+
+/*! \brief Memria das propriedades de um estado (ver Psychro::evaluate)
+
+Guarda as propriedades j calculadas de um estado e os resultados intermedirios (presso de saturao, enhancement factor, volume e entalpia molares) que as propriedades compartilham. Uma propriedade pedida novamente, ou que depende de um intermedirio j calculado, no  recalculada. Quando o estado muda (temperatura, presso ou composio), tudo  descartado automaticamente.
+
+valid e reused indicam quais grandezas esto armazenadas e quais foram reutilizadas desde a ltima mudana de estado: bits de MoistAirProperty para as propriedades e PWS, EFACTOR, VOLM e HM para os intermedirios.
+
+Os valores dependem tambm da configurao do modelo (ver Psychro::configHash). Psychro::cached compara config com a configurao atual e descarta a memria quando ela muda; quem utiliza Psychro::evaluate diretamente deve chamar clear se modificar o modelo. Cada thread deve ter a sua memria.
+*/
+struct MoistAirCache{
+  /// Resultados intermedirios
+  enum{
+    /// Presso de saturao na temperatura do estado
+    PWS = 64,
+    /// Enhancement factor na temperatura e presso do estado
+    EFACTOR = 128,
+    /// Volume molar da mistura (e portanto Z)
+    VOLM = 256,
+    /// Entalpia molar da mistura
+    HM = 512
+  };
+
+  /// Estado
+  MoistAirState s;
+  /// Propriedades do estado
+  MoistAirProperties props;
+  /// Presso de saturao (Pa) e enhancement factor
+  double Pws, f;
+  /// Volume molar \f$m^3/kmol\f$ e entalpia molar J/kmol
+  double vM, hM;
+  /// Grandezas armazenadas
+  unsigned valid;
+  /// Grandezas reutilizadas desde a ltima mudana de estado
+  unsigned reused;
+  /// Nmero de grandezas reutilizadas e calculadas (acumulados, no so zerados pela mudana de estado)
+  long hits, misses;
+  /// Configurao do modelo com que as grandezas foram calculadas (ver Psychro::configHash)
+  uint64_t config;
+
+  MoistAirCache(): props(MoistAirState()), Pws(0), f(0), vM(0), hM(0), valid(0), reused(0),
+		   hits(0), misses(0), config(0){
+    s.T = s.P = s.xv = s.W = NAN;
+    s.status = 0;
+  }
+
+  /// Descarta as grandezas armazenadas
+  void clear(){
+    s.T = NAN;
+    valid = reused = 0;
+  }
+
+  /// Passa a guardar as grandezas do estado st. Retorna true se o estado mudou (e as grandezas foram descartadas)
+  bool update(const MoistAirState &st){
+    if (st.T == s.T && st.P == s.P && st.xv == s.xv && st.W == s.W && st.status == s.status)
+      return false;
+    s = st;
+    props = MoistAirProperties(st);
+    valid = reused = 0;
+    return true;
+  }
+
+  /// Das grandezas mask, retorna as que precisam ser calculadas e as marca como armazenadas; as demais so marcadas como reutilizadas
+  unsigned need(unsigned mask){
+    unsigned r = mask & valid, n = mask & ~valid;
+    reused |= r;
+    valid |= n;
+    for (; r; r &= r - 1) ++hits;
+    for (unsigned k = n; k; k &= k - 1) ++misses;
+    return n;
+  }
+};
+
+
+/// Hash FNV-1a dos n bytes em p, continuando de h (ver Psychro::configHash)
+inline uint64_t hash_bytes(const void *p, size_t n, uint64_t h=14695981039346656037ULL){
+  const unsigned char *c = static_cast<const unsigned char *>(p);
+  for (size_t i = 0; i < n; ++i){
+    h ^= c[i];
+    h *= 1099511628211ULL;
+  }
+  return h;
+}
+
+
+/*! \brief Identificador nico de um objeto (Psychro::id)
+
+Cada objeto recebe um nmero diferente na construo, inclusive as cpias, e os nmeros nunca so reutilizados, ao contrrio dos endereos: um modelo construdo no lugar de outro j destrudo tem outro identificador. A atribuio no modifica o identificador.
+*/
+struct ModelId{
+  uint64_t value;
+  ModelId(): value(next()){}
+  ModelId(const ModelId &): value(next()){}
+  ModelId &operator=(const ModelId &){ return *this; }
+ private:
+  static uint64_t next(){
+    static std::atomic<uint64_t> n(0);
+    return ++n;
+  }
+};
+
+
+/*! \brief Tolerncias dos mtodos iterativos (Psychro::tol)
+
+Cada mtodo iterativo termina quando o ltimo passo  menor que a tolerncia correspondente. Os valores padro so os da verso original da biblioteca, bem abaixo da preciso das correlaes; quem precisa de apenas alguns algarismos significativos pode relax-los com accuracy, que tambm ajusta as iteraes internas (enhancement factor, equao virial) para que no sejam resolvidas com mais preciso que a necessria para o resultado final.
+
+As tolerncias ficam no modelo, portanto valem para todas as funes e para o clculo em lote. Para tolerncias diferentes em chamadas diferentes utiliza-se uma cpia do modelo (as tabelas do modo rpido so compartilhadas entre as cpias).
+*/
+struct Tolerances{
+  /// Temperatura de bulbo mido (K)
+  double wetbulb;
+  /// Temperatura de ponto de orvalho (K)
+  double dewpoint;
+  /// Temperatura de saturao, Tws (K)
+  double Tws;
+  /// Teor de umidade dada a temperatura de bulbo mido, relativa ao teor de umidade de saturao
+  double W;
+  /// Enhancement factor
+  double eFactor;
+  /// Volume molar na equao virial, relativo ao prprio volume (apenas com Ashrae::VIRIAL_ITERATIVE, ou quando o mtodo de Halley falha); vale em qualquer presso, do ar a 5MPa ao vapor saturado a poucos Pa
+  double volume;
+
+  Tolerances(): wetbulb(1e-7), dewpoint(1e-9), Tws(1e-8), W(1e-8), eFactor(1e-7), volume(1e-10){}
+
+  /*! Tolerncias para um erro de no mximo dT nas temperaturas (bulbo mido, ponto de orvalho e Tws) e um erro relativo rel nas demais propriedades. As iteraes internas recebem um dcimo do erro que elas causariam no resultado: um erro \f$\delta f\f$ no enhancement factor desloca o ponto de orvalho de cerca de \f$15 \delta f\f$ K e a umidade de \f$\delta f\f$ (relativo); um erro no volume molar altera a densidade e a entalpia na mesma proporo.
+
+  Por exemplo, accuracy(0.01, 1e-5) garante o bulbo mido e o ponto de orvalho com 0.01K e a densidade com 5 algarismos significativos. Como o mtodo de Newton converge quadraticamente, o erro obtido  em geral bem menor que o pedido.
+
+  O bulbo mido e o ponto de orvalho param assim que o passo de Newton d satisfaz \f$|d| < \epsilon\f$ ou, a partir da segunda iterao, \f$d^2 < \epsilon\f$ (d e \f$\epsilon\f$ em K). A derivada analtica destas equaes  aproximada (omite os termos em T da equao virial, a variao do enhancement factor e, no ponto de orvalho, a da entalpia da gua), o que tornaria a convergncia apenas linear; a partir da segunda iterao a derivada  corrigida pela secante com o ponto anterior, \f$J = \Delta F/\Delta T + \Delta J_a/2\f$, que cancela esse erro constante e restabelece a convergncia quadrtica (a correo no  aplicada se os dois pontos esto em lados opostos de 273.15K). Com ela o erro depois do passo  de cerca de \f$K d^2\f$, com \f$K\f$ inferior a 0.1 K\f$^{-1}\f$, e no  necessrio um passo a mais s para confirmar a convergncia.
+  */
+  static Tolerances accuracy(double dT, double rel){
+    Tolerances t;
+    t.wetbulb = t.dewpoint = t.Tws = dT;
+    t.W = rel;
+    double ef = (rel < dT/15) ? rel : dT/15;
+    t.eFactor = ef / 10;
+    t.volume = rel / 10;
+    return t;
+  }
+};
+
+
+/*! \brief Partida a quente dos mtodos iterativos numa srie temporal
+
+Numa srie de medidas (um sensor amostrado a 1 Hz, por exemplo) o estado varia pouco de uma amostra para a outra. As funes que recebem um SolverContext (Psychro::state, Psychro::WETBULB e Psychro::DEWPOINT) partem dos valores convergidos na amostra anterior em vez das estimativas usuais (T - 1 no bulbo mido, a correlao explcita de Tws no ponto de orvalho, f = 1 no enhancement factor). Como o critrio de parada aceita um passo com \f$d^2 < \epsilon\f$ (ver Tolerances), uma partida prxima da soluo termina em duas iteraes: na srie de test/desempenho.cpp (sensor amostrado a 1 Hz), o ponto de orvalho passa de 2.23 (Ashrae) e 2.37 (Giacomo) para 2.00 iteraes por amostra, e o bulbo mido de Ashrae e Giacomo j parte do valor do gs perfeito (Ashrae::perfectGasSeed) e fica em 2.00 iteraes com ou sem contexto (no prprio GasPerfeito, de 3.64 para 1.98). Os resultados diferem dos das funes sem contexto apenas dentro das tolerncias (ver Tolerances).
+
+Se a amostra se afastar da anterior mais que maxdT, maxdP ou maxdW, os valores armazenados so descartados e as estimativas usuais voltam a ser utilizadas. O volume molar no  armazenado: o mtodo padro da equao virial (Ashrae::VIRIAL_HALLEY) no  iterativo.
+
+Cada srie deve ter o seu prprio contexto; o modelo continua podendo ser compartilhado entre threads.
+*/
+struct SolverContext{
+  /// Temperatura (K), presso (Pa) e teor de umidade da amostra anterior
+  double T, P, W;
+  /// Temperatura de bulbo mido da amostra anterior (0: no disponvel)
+  double wetbulb;
+  /// Temperatura de ponto de orvalho da amostra anterior (0: no disponvel)
+  double dewpoint;
+  /// Enhancement factor da amostra anterior (0: no disponvel)
+  double eFactor;
+  /// Maior variao de temperatura (K) para a qual os valores anteriores so utilizados
+  double maxdT;
+  /// Maior variao relativa da presso
+  double maxdP;
+  /// Maior variao do teor de umidade
+  double maxdW;
+  /// Nmero total de iteraes de Newton do bulbo mido e do ponto de orvalho
+  long iterations;
+
+  SolverContext(): T(0), P(0), W(0), maxdT(2.0), maxdP(0.02), maxdW(0.002), iterations(0){
+    reset();
+  }
+
+  /// Descarta os valores armazenados
+  void reset(){ wetbulb = dewpoint = eFactor = 0; }
+
+  /// A temperatura T e a presso P esto prximas das da amostra anterior?
+  bool near(double T, double P) const{
+    return std::fabs(T - this->T) <= maxdT && std::fabs(P - this->P) <= maxdP * this->P;
+  }
+
+  /// Passa a utilizar s como amostra anterior, descartando os valores armazenados se s estiver longe dela
+  void update(const MoistAirState &s){
+    if (!near(s.T, s.P) || std::fabs(s.W - W) > maxdW) reset();
+    T = s.T;
+    P = s.P;
+    W = s.W;
+  }
+};
+
+
 /*! \brief Classe base para todas as classes utilizadas no clculo de propriedades do ar
 
 A classe Psychro no possui nenhum cdigo executvel, apenas possui as interfaces de entrada e sada que qualuqer classe utilizada deve ter. Possui tambm as constantes bsicas do clculo psicromtrico. 
@@ -56,11 +421,21 @@ class Psychro{
   /// Varivel inteira que armazena o cdigo de erro
   int errorcode;
 
+  /// Tolerncias dos mtodos iterativos
+  Tolerances tol;
+
+  /// Identificador do modelo (ver ResultCache)
+  ModelId id;
+
 
   /// Funes bsica de entrada de dados. Vai especificar a a mistura ar - vapor.
   virtual void set(double T, char ch, double umidade, double P)=0; 
+  /// Especifica a mistura ar-vapor sem modificar o modelo. Mesmos argumentos de set.
+  virtual MoistAirState state(double T, char ch, double umidade, double P) const =0;
+  /// Como state, partindo dos valores da amostra anterior armazenados em c (ver SolverContext)
+  virtual MoistAirState state(double T, char ch, double umidade, double P, SolverContext &c) const =0;
   /// Funo para clculo da compressibilidade do ar mido
-  virtual double Z(double T, double P, double xv)=0; // Compressibilidade
+  virtual double Z(double T, double P, double xv, int *err=0) const =0; // Compressibilidade
   
   
 
@@ -88,23 +463,96 @@ class Psychro{
   virtual int ERROR()=0;		// Cdigo de erro.
   
 
+  // Funes de sada reentrantes. Calculam as propriedades do estado s e, caso
+  // err no seja nulo, armazenam nele o cdigo de erro.
+  /// Entalpia em J/kg de ar seco do estado s
+  virtual double ENTHALPY(const MoistAirState &s, int *err=0) const =0;
+  /// Volume especfico em \f$m^3/kg\f$ de ar seco do estado s
+  virtual double VOLUME(const MoistAirState &s, int *err=0) const =0;
+  /// Massa especfica em \f$kg/m^3\f$ do estado s
+  virtual double DENSITY(const MoistAirState &s, int *err=0) const =0;
+  /// Temperatura de bulbo mido em K do estado s
+  virtual double WETBULB(const MoistAirState &s, int *err=0) const =0;
+  /// Temperatura de bulbo mido em K do estado s, partindo do valor da amostra anterior (ver SolverContext)
+  virtual double WETBULB(const MoistAirState &s, SolverContext &c, int *err=0) const =0;
+  /// Temperatura de ponto de orvalho em K do estado s
+  virtual double DEWPOINT(const MoistAirState &s, int *err=0) const =0;
+  /// Temperatura de ponto de orvalho em K do estado s, partindo do valor da amostra anterior (ver SolverContext)
+  virtual double DEWPOINT(const MoistAirState &s, SolverContext &c, int *err=0) const =0;
+  /// Umidade relativa do estado s
+  virtual double RELHUM(const MoistAirState &s, int *err=0) const =0;
+  /// Propriedades do estado s selecionadas por mask (ver MoistAirProperty) numa s passagem, compartilhando os clculos intermedirios
+  virtual MoistAirProperties evaluate_all(const MoistAirState &s, unsigned mask=PROP_ALL) const =0;
+  /// Como evaluate_all, calculando apenas as propriedades e intermedirios que ainda no esto em c (ver MoistAirCache)
+  virtual const MoistAirProperties &evaluate(MoistAirCache &c, const MoistAirState &s,
+					     unsigned mask=PROP_ALL) const =0;
+
+  /// Clculo em lote: n amostras em colunas T, umidade (do tipo ch, ver set) e P. Preenche as colunas no nulas de out.
+  virtual void batch(size_t n, char ch, const double *T, const double *umidade,
+		     const double *P, const MoistAirColumns &out) const =0;
+  /// Clculo em lote com entradas e sadas em float, em preciso simples onde o modelo o permite (ver Ashrae::batchFloat)
+  virtual void batchFloat(size_t n, char ch, const float *T, const float *umidade,
+			  const float *P, const MoistAirColumnsF &out) const =0;
+  /// Malha de nP presses por nU umidades na temperatura T: o ponto (j, k)  o elemento j*nU + k das colunas de out (ver grid_eval)
+  virtual void gridRow(double T, size_t nP, const double *P, char ch, size_t nU,
+		       const double *umidade, const MoistAirColumns &out) const =0;
+  
+
   // Funes auxiliares:
   /// Calcula o enhancement factor
-  virtual double eFactor(double T, double P)=0;	// Enhancement factor
-  /// Calcula a presso de vapor em Pa do vapor saturado
-  virtual double Pws(double T)=0;	// Presso de saturao de vapor
+  virtual double eFactor(double T, double P) const =0;	// Enhancement factor
+  /// Calcula a presso de vapor em Pa do vapor saturado. Se err no for nulo, recebe o cdigo de erro do modelo quando T est fora da faixa da correlao
+  virtual double Pws(double T, int *err=0) const =0;	// Presso de saturao de vapor
   /// Calcula a temperatura de saturao em K do vapor saturado
-  virtual double Tws(double P)=0;	// Temperatura de saturao de vapor
+  virtual double Tws(double P, int *err=0) const =0;	// Temperatura de saturao de vapor
+
+  int FaixaT(double T) const { if (T < Tmin || T > Tmax) return 10; return 0;}
+  int FaixaP(double P) const { if (P < Pmin || P > Pmax) return 11; return 0;}
+
+  /// Estado correspondente  composio armazenada por set na temperatura T e presso P. Verifica as faixas e atualiza errorcode.
+  MoistAirState current(double T, double P){
+    MoistAirState s = {T, P, XV, W, FaixaT(T)};
+    if (!s.status) s.status = FaixaP(P);
+    if (s.status) errorcode = s.status;
+    return s;
+  }
 
-  int FaixaT(double T){ if (T < Tmin || T > Tmax) return 10; return 0;}
-  int FaixaP(double P){ if (P < Pmin || P > Pmax) return 11; return 0;}
+  /// Propriedades j calculadas do estado atual, utilizadas pelas funes de sada que no so reentrantes (ver cached)
+  MoistAirCache cache;
 
+  /*! Resumo da configurao do modelo que afeta os resultados: faixas de aplicao, tolerncias e, nas classes derivadas, as opes dos mtodos (ver Ashrae::configHash). As memrias de resultados (cached, ResultCache) guardam este valor junto com os resultados, de modo que modificar o modelo nunca devolve valores calculados com a configurao anterior.
+   */
+  virtual uint64_t configHash() const{
+    double faixa[] = {Tmin, Tmax, Pmin, Pmax};
+    return hash_bytes(&tol, sizeof(tol), hash_bytes(faixa, sizeof(faixa)));
+  }
+
+  /*! Propriedades mask do estado current(T, P). As funes de sada que no so reentrantes (DENSITY(T, P), WETBULB(T, P), ...) utilizam esta funo: vrias consultas ao mesmo estado, como o ponto de orvalho, a umidade relativa e o bulbo mido depois de set, calculam cada propriedade e cada intermedirio uma nica vez (ver MoistAirCache). A memria  descartada quando T, P ou a composio mudam, e tambm quando a configurao do modelo muda (tolerncias, faixas, mtodo da equao virial, ...; ver configHash). Atualiza errorcode com o cdigo de erro do estado e das propriedades j calculadas.
+   */
+  const MoistAirProperties &cached(double T, double P, unsigned mask){
+    uint64_t h = configHash();
+    if (h != cache.config){
+      cache.clear();
+      cache.config = h;
+    }
+    const MoistAirProperties &r = evaluate(cache, current(T, P), mask);
+    if (r.status) errorcode = r.status;
+    return r;
+  }
+  
   void ClearError(){errorcode = 0;}
 };
 
 #include "gas_perfeito.h"
 #include "ashrae.h"
 #include "giacomo.h"
+#include "batch.h"
+#include "simd.h"
+#include "parallel.h"
+#include "mixed.h"
+#include "dedup.h"
+#include "grid.h"
+#include "cache.h"
 
 #endif 
 
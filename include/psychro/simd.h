@@ -0,0 +1,42 @@
+/*! \file simd.h
+
+\brief Seleo do conjunto de instrues das funes em lote
+
+As verses vetoriais das funes em lote (PwsBatch, TwsBatch, ZBatch, eFactorBatch, DEWPOINTBatch, WETBULBBatch, CalcWfromBBatch, ...) so compiladas para vrios conjuntos de instrues e a verso utilizada  escolhida em tempo de execuo, uma nica vez, de acordo com o processador (ver PSYCHRO_SIMD_DISPATCH em vecmath.h). Assim um mesmo executvel utiliza AVX2 ou AVX-512 onde estiverem disponveis e continua funcionando em processadores mais antigos. A interface das funes em lote no muda.
+
+A varivel de ambiente PSYCHRO_SIMD fora um nvel (scalar, base, sse4.2, avx2 ou avx512; ver simd_name), o que  til em testes e medidas de desempenho. Um nvel que o processador no suporta  substitudo pelo maior nvel suportado abaixo dele.
+
+Os resultados dos diferentes nveis diferem apenas pelo arredondamento (o nvel AVX2 utiliza instrues FMA).
+*/
+
+#ifndef _simd_h
+#define _simd_h
+
+
+/// Conjuntos de instrues das verses vetoriais
+enum SimdLevel{
+  /// Um elemento de cada vez
+  SIMD_SCALAR,
+  /// PSYCHRO_LANES elementos, com as opes de compilao da biblioteca (SSE2 no x86-64, NEON no ARM)
+  SIMD_BASE,
+  /// 2 elementos, SSE4.2
+  SIMD_SSE42,
+  /// 4 elementos, AVX2 e FMA
+  SIMD_AVX2,
+  /// 8 elementos, AVX-512F
+  SIMD_AVX512
+};
+
+/// Nvel utilizado pelas funes em lote (escolhido na carga da biblioteca)
+SimdLevel simd_level();
+
+/// O processador e o compilador suportam o nvel?
+bool simd_supported(SimdLevel level);
+
+/// Nmero de elementos processados simultaneamente no nvel
+int simd_lanes(SimdLevel level);
+
+/// Nome do nvel, como em PSYCHRO_SIMD
+const char *simd_name(SimdLevel level);
+
+#endif
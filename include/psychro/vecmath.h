@@ -0,0 +1,485 @@
+/*! \file vecmath.h
+
+\brief Funes matemticas vetoriais (exp, log, pow)
+
+Camada porttil de funes elementares que operam sobre vrios valores em dupla ou simples preciso simultaneamente.  utilizada pelas verses em lote das correlaes (Pws, coeficientes viriais, ...). Utiliza as extenses vetoriais do GCC/Clang, que geram instrues SSE2/AVX/AVX-512 no x86 e NEON no ARM. As funes so templates do tipo vetorial V (vtypes<L>::d, com L elementos double, ou vftypes<L>::f, com L elementos float), de modo que o mesmo cdigo  compilado para vrios conjuntos de instrues e escolhido em tempo de execuo (ver PSYCHRO_SIMD_DISPATCH e simd.h). Um vetor float tem o dobro dos elementos do vetor double do mesmo tamanho (ver PSYCHRO_SIMD_DISPATCH_FLOAT). O nmero de elementos das opes de compilao da biblioteca, PSYCHRO_LANES (tipo vdouble),  escolhido de acordo com o conjunto de instrues disponvel e pode ser fixado definindo PSYCHRO_LANES:
+
+- AVX-512 (__AVX512F__): 8
+- AVX/AVX2 (__AVX__): 4
+- SSE2, NEON e outros: 2
+
+As funes no possuem desvios condicionais (os ramos so selecionados por mscaras), portanto o custo no depende dos valores. Preciso, medida contra o resultado em preciso qudrupla com \f$10^7\f$ argumentos aleatrios:
+
+- vexp: erro mximo de 1 ULP para \f$-708 \le x \le 709\f$ (fora desta faixa o argumento  limitado)
+- vexp10: erro mximo de 1.4 ULP para \f$-307 \le x \le 308\f$
+- vlog: erro mximo de 1.3 ULP para x positivo e normal (x <= 0, infinitos, NaN e nmeros subnormais no so tratados)
+- vpow: calculada como \f$e^{y \ln x}\f$; o erro de \f$\ln x\f$  amplificado e o erro relativo  de cerca de \f$1 + 1.5|y \ln x|\f$ ULP (34 ULP, ou \f$8 \times 10^{-15}\f$, para \f$T^{3.1}\f$ com T em K).
+
+As verses float tm polinmios de grau menor, com o mesmo esquema de reduo:
+
+- vexp: erro mximo de 1.1 ULP para \f$-87 \le x \le 88\f$
+- vexp10: erro mximo de 1.3 ULP para \f$-37 \le x \le 38\f$
+- vlog: erro mximo de 1 ULP para x positivo e normal
+
+Em compiladores sem extenses vetoriais, PSYCHRO_LANES vale 1 e as funes chamam a biblioteca padro.
+*/
+
+#ifndef _vecmath_h
+#define _vecmath_h
+
+#include <cmath>
+#include <cstring>
+#include <type_traits>
+
+#include "simd.h"
+
+
+#if defined(__GNUC__)
+
+#ifndef PSYCHRO_LANES
+#if defined(__AVX512F__)
+#define PSYCHRO_LANES 8
+#elif defined(__AVX__)
+#define PSYCHRO_LANES 4
+#else
+#define PSYCHRO_LANES 2
+#endif
+#endif
+
+// Os vetores de 4 e 8 elementos s so utilizados em funes compiladas para AVX2 e AVX-512 (ver PSYCHRO_SIMD_DISPATCH), onde so expandidos: o aviso de mudana de ABI no retorno destes vetores sem AVX no se aplica, e  desativado apenas neste arquivo. Os vetores e mscaras so passados por referncia, pois a nota sobre a passagem de parmetros alinhados em 64 bytes por valor no pode ser desativada por pragma
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+/// Tipos vetoriais com L elementos
+template<size_t L>
+struct vtypes{
+  /// L valores double
+  typedef double d __attribute__((vector_size(8*L)));
+  /// L inteiros de 64 bits (tambm utilizado como mscara: -1 verdadeiro, 0 falso)
+  typedef long long l __attribute__((vector_size(8*L)));
+  /// L inteiros de 64 bits sem sinal. O deslocamento  direita  lgico: o aritmtico de 64 bits s existe no AVX-512 e seria feito elemento a elemento
+  typedef unsigned long long u __attribute__((vector_size(8*L)));
+  /// 2L inteiros de 32 bits (ver vselect)
+  typedef int i __attribute__((vector_size(8*L)));
+};
+
+/// Tipos vetoriais em preciso simples com L elementos
+template<size_t L>
+struct vftypes{
+  /// L valores float
+  typedef float f __attribute__((vector_size(4*L)));
+  /// L inteiros de 32 bits (tambm utilizado como mscara)
+  typedef int i __attribute__((vector_size(4*L)));
+  /// L inteiros de 32 bits sem sinal
+  typedef unsigned u __attribute__((vector_size(4*L)));
+};
+
+/// Tipo dos elementos de V (o prprio V se for double ou float)
+template<class V>
+struct vscalar{
+  typedef typename std::decay<decltype(V()[0])>::type type;
+};
+template<> struct vscalar<double>{ typedef double type; };
+template<> struct vscalar<float>{ typedef float type; };
+
+/// Nmero de elementos e tipos inteiros do vetor V de elementos S
+template<class V, class S = typename vscalar<V>::type>
+struct vtraits{
+  static const size_t L = sizeof(V) / sizeof(double);
+  /// Tipo dos elementos
+  typedef double scalar;
+  /// Mscara de V
+  typedef typename vtypes<L>::l mask;
+  typedef typename vtypes<L>::u umask;
+  typedef typename vtypes<L>::i vint;
+  /// Somado a x, arredonda x para um inteiro (1.5*2^52), que fica nos bits menos significativos
+  static double magic(){ return 6755399441055744.0; }
+};
+
+/// Vetor float
+template<class V>
+struct vtraits<V, float>{
+  static const size_t L = sizeof(V) / sizeof(float);
+  typedef float scalar;
+  typedef typename vftypes<L>::i mask;
+  typedef typename vftypes<L>::u umask;
+  typedef typename vftypes<L>::i vint;
+  /// 1.5*2^23
+  static float magic(){ return 12582912.0f; }
+};
+
+/// V se os elementos de V forem do tipo S (seleciona as verses double e float das funes)
+template<class V, class S>
+struct vif: std::enable_if<std::is_same<typename vscalar<V>::type, S>::value, V>{};
+
+/// PSYCHRO_LANES valores double
+typedef vtypes<PSYCHRO_LANES>::d vdouble;
+/// PSYCHRO_LANES inteiros de 64 bits (tambm utilizado como mscara)
+typedef vtypes<PSYCHRO_LANES>::l vlong;
+/// PSYCHRO_LANES inteiros de 64 bits sem sinal
+typedef vtypes<PSYCHRO_LANES>::u vulong;
+/// 2*PSYCHRO_LANES valores float (o mesmo tamanho de vdouble)
+typedef vftypes<2*PSYCHRO_LANES>::f vfloat;
+
+/// Vetor com todos os elementos iguais a a
+template<class V = vdouble>
+inline V vset(double a){ return typename vtraits<V>::scalar(a) - V{}; }
+
+/// Atribui a ao elemento j de x
+template<class V>
+inline void vinsert(V &x, size_t j, double a){ x[j] = a; }
+
+/// Seleciona a onde m  verdadeiro e b onde  falso
+template<class V>
+inline V vselect(const typename vtraits<V>::mask &m, const V &a, const V &b){
+  // As operaes so feitas em inteiros de 32 bits: sem SSE4.1 no h comparao de inteiros de 64 bits e o GCC reconheceria a seleo em vlong, executando-a elemento a elemento
+  typedef typename vtraits<V>::vint vint;
+  return (V)(((vint)m & (vint)a) | (~(vint)m & (vint)b));
+}
+
+/// Valor absoluto
+template<class V>
+inline V vfabs(const V &x){
+  typedef typename vtraits<V>::mask M;
+  return (V)((M)x & ~(M)vset<V>(-0.0));
+}
+
+/// Negao da mscara m
+template<class M>
+inline M vnot(const M &m){ return ~m; }
+
+/// Algum elemento da mscara m  verdadeiro?
+template<class M>
+inline bool vany(const M &m){
+  for (size_t j = 0; j < sizeof(M)/sizeof(m[0]); ++j)
+    if (m[j]) return true;
+  return false;
+}
+
+/// Arredonda para o inteiro mais prximo (|x| < 2^51 em double, 2^22 em float)
+template<class V>
+inline V vround(const V &x){
+  const typename vtraits<V>::scalar magic = vtraits<V>::magic();
+  return (x + magic) - magic;
+}
+
+/*! \f$e^r 2^k\f$ para \f$|r| \le \ln 2/2\f$: srie de Taylor de grau 13 e multiplicao por \f$2^k\f$ montada diretamente no expoente. Utilizada por vexp e vexp10.
+ */
+template<class V>
+inline typename vif<V, double>::type vexp_reduced(const V &r, const typename vtraits<V>::mask &k){
+  typedef typename vtraits<V>::mask M;
+  typedef typename vtraits<V>::umask U;
+  // Esquema de Estrin: a cadeia de dependncias  bem mais curta que a de Horner, o que permite sobrepor vrias avaliaes independentes
+  V r2 = r*r, r4 = r2*r2, r8 = r4*r4;
+  V p = (0.5 + r*(1.0/6.0) + r2*(1.0/24.0 + r*(1.0/120.0)))
+    + r4*((1.0/720.0 + r*(1.0/5040.0)) + r2*(1.0/40320.0 + r*(1.0/362880.0)))
+    + r8*((1.0/3628800.0 + r*(1.0/39916800.0)) + r2*(1.0/479001600.0 + r*(1.0/6227020800.0)));
+  p = p*r2 + r + 1.0;
+
+  // 2^k: k  somado ao expoente em duas partes para no estourar em k = -1022..1023. k1 = floor(k/2), com deslocamento lgico de k + 2048 > 0
+  M k1 = (M)((U)(k + 2048) >> 1) - 1024;
+  V s1 = (V)((k1 + 1023) << 52);
+  V s2 = (V)((k - k1 + 1023) << 52);
+  return p * s1 * s2;
+}
+
+
+/*! Exponencial. Reduo \f$x = k \ln 2 + r\f$ com \f$|r| \le \ln 2/2\f$ (Cody-Waite, \f$\ln 2\f$ dividido em duas partes para que \f$k \ln 2\f$ seja exato).
+ */
+template<class V>
+inline typename vif<V, double>::type vexp(const V &x0){
+  typedef typename vtraits<V>::mask M;
+  const double magic = 6755399441055744.0;
+  V x = vselect((M)(x0 < -708.0), vset<V>(-708.0), x0);
+  x = vselect((M)(x > 709.0), vset<V>(709.0), x);
+
+  V kd = x * 1.4426950408889634 + magic; // k + magic
+  M k = (M)kd - (M)vset<V>(magic);       // k inteiro
+  kd = kd - magic;
+
+  V r = x - kd * 6.93147180369123816490e-01 - kd * 1.90821492927058770002e-10;
+  return vexp_reduced(r, k);
+}
+
+
+/*! Potncia de 10. A reduo  feita sobre o prprio x, \f$x = k \log_{10} 2 + r/\ln 10\f$, para que o erro de arredondamento de \f$x \ln 10\f$ no seja amplificado.
+ */
+template<class V>
+inline typename vif<V, double>::type vexp10(const V &x0){
+  typedef typename vtraits<V>::mask M;
+  const double magic = 6755399441055744.0;
+  V x = vselect((M)(x0 < -307.0), vset<V>(-307.0), x0);
+  x = vselect((M)(x > 308.0), vset<V>(308.0), x);
+
+  V kd = x * 3.321928094887362 + magic;
+  M k = (M)kd - (M)vset<V>(magic);
+  kd = kd - magic;
+
+  V r = ((x - kd * 0.30102992057800293) - kd * 7.508597826552624e-08) * 2.302585092994046;
+  return vexp_reduced(r, k);
+}
+
+
+/*! Logaritmo natural. \f$x = m 2^e\f$ com \f$\sqrt{2}/2 \le m < \sqrt{2}\f$ e \f$\ln m = 2\,\mathrm{atanh}(s)\f$, \f$s = (m-1)/(m+1)\f$, calculado pela srie de potncias (\f$|s| < 0.172\f$).
+ */
+template<class V>
+inline typename vif<V, double>::type vlog(const V &x){
+  typedef typename vtraits<V>::mask M;
+  typedef typename vtraits<V>::umask U;
+  const double magic = 6755399441055744.0;
+  M bits = (M)x;
+  M e = (M)(((U)bits >> 52) & 0x7ff) - 1023;
+  V m = (V)((bits & 0x000fffffffffffffLL) | 0x3ff0000000000000LL);
+
+  M big = (M)(m > 1.4142135623730951);
+  m = vselect(big, m*0.5, m);
+  e = e - big;
+  V ed = (V)(e + (M)vset<V>(magic)) - magic;
+
+  V f = m - 1.0;
+  V s = f / (m + 1.0);
+  V z = s*s;
+
+  V z2 = z*z, z4 = z2*z2, z8 = z4*z4;
+  V p = (1.0/3 + z*(1.0/5) + z2*(1.0/7 + z*(1.0/9)))
+    + z4*((1.0/11 + z*(1.0/13)) + z2*(1.0/15 + z*(1.0/17)))
+    + z8*((1.0/19 + z*(1.0/21)) + z2*(1.0/23 + z*(1.0/25)));
+  // ln m = f - s*f + s*z*p*2 reduz o erro de arredondamento do termo dominante
+  V lnm = f - s*(f - 2*z*p);
+
+  return ed * 6.93147180369123816490e-01 + (ed * 1.90821492927058770002e-10 + lnm);
+}
+
+
+/*! \f$e^r 2^k\f$ em float para \f$|r| \le \ln 2/2\f$: srie de Taylor de grau 7 (o erro de truncamento  inferior a \f$10^{-8}\f$) e \f$2^k\f$ montado no expoente, \f$-126 \le k \le 127\f$.
+ */
+template<class V>
+inline typename vif<V, float>::type vexp_reduced(const V &r, const typename vtraits<V>::mask &k){
+  V r2 = r*r, r4 = r2*r2;
+  V p = (0.5f + r*(1.0f/6) + r2*(1.0f/24 + r*(1.0f/120)))
+    + r4*(1.0f/720 + r*(1.0f/5040));
+  p = p*r2 + r + 1.0f;
+  return p * (V)((k + 127) << 23);
+}
+
+/// Exponencial em float. Reduo de Cody-Waite como na verso double; a parte alta de \f$\ln 2\f$ tem 15 bits, de modo que \f$k \ln 2\f$  exato
+template<class V>
+inline typename vif<V, float>::type vexp(const V &x0){
+  typedef typename vtraits<V>::mask M;
+  const float magic = 12582912.0f;
+  V x = vselect((M)(x0 < -87.0f), vset<V>(-87.0), x0);
+  x = vselect((M)(x > 88.0f), vset<V>(88.0), x);
+
+  V kd = x * 1.44269504f + magic;
+  M k = (M)kd - (M)vset<V>(magic);
+  kd = kd - magic;
+
+  V r = x - kd * 0.693145751953125f - kd * 1.42860677e-06f;
+  return vexp_reduced(r, k);
+}
+
+/// Potncia de 10 em float (ver a verso double); a parte alta de \f$\log_{10} 2\f$ tem 11 bits
+template<class V>
+inline typename vif<V, float>::type vexp10(const V &x0){
+  typedef typename vtraits<V>::mask M;
+  const float magic = 12582912.0f;
+  V x = vselect((M)(x0 < -37.0f), vset<V>(-37.0), x0);
+  x = vselect((M)(x > 38.0f), vset<V>(38.0), x);
+
+  V kd = x * 3.32192809f + magic;
+  M k = (M)kd - (M)vset<V>(magic);
+  kd = kd - magic;
+
+  V r = ((x - kd * 0.301025390625f) - kd * 4.60503898e-06f) * 2.30258509f;
+  return vexp_reduced(r, k);
+}
+
+/// Logaritmo natural em float (ver a verso double). Com \f$|s| < 0.172\f$ bastam os termos da srie at \f$s^{11}\f$
+template<class V>
+inline typename vif<V, float>::type vlog(const V &x){
+  typedef typename vtraits<V>::mask M;
+  typedef typename vtraits<V>::umask U;
+  const float magic = 12582912.0f;
+  M bits = (M)x;
+  M e = (M)(((U)bits >> 23) & 0xff) - 127;
+  V m = (V)((bits & 0x007fffff) | 0x3f800000);
+
+  M big = (M)(m > 1.41421356f);
+  m = vselect(big, m*0.5f, m);
+  e = e - big;
+  V ed = (V)(e + (M)vset<V>(magic)) - magic;
+
+  V f = m - 1.0f;
+  V s = f / (m + 1.0f);
+  V z = s*s;
+
+  V p = 1.0f/3 + z*(1.0f/5 + z*(1.0f/7 + z*(1.0f/9 + z*(1.0f/11))));
+  V lnm = f - s*(f - 2*z*p);
+
+  return ed * 0.693145751953125f + (ed * 1.42860677e-06f + lnm);
+}
+
+/// Potncia \f$x^y\f$ para x positivo
+template<class V>
+inline V vpow(const V &x, const V &y){ return vexp(y * vlog(x)); }
+
+/// Potncia inteira \f$x^n\f$, \f$n \ge 1\f$, por multiplicaes sucessivas
+template<class V>
+inline V vipow(const V &x, int n){
+  V y = x;
+  for (int i = 1; i < n; ++i) y *= x;
+  return y;
+}
+
+/// Raiz quadrada (elemento a elemento)
+template<class V>
+inline V vsqrt(const V &x){
+  V r = x;
+  for (size_t j = 0; j < vtraits<V>::L; ++j) r[j] = std::sqrt(r[j]);
+  return r;
+}
+
+#else
+
+#define PSYCHRO_LANES 1
+typedef double vdouble;
+typedef float vfloat;
+typedef long long vlong;
+
+template<class V> struct vscalar{ typedef V type; };
+
+template<class V>
+struct vtraits{
+  static const size_t L = 1;
+  typedef V scalar;
+  typedef long long mask;
+};
+
+template<class V = vdouble>
+inline V vset(double a){ return V(a); }
+inline void vinsert(vdouble &x, size_t, double a){ x = a; }
+inline vdouble vfabs(vdouble x){ return std::fabs(x); }
+inline vfloat vfabs(vfloat x){ return std::fabs(x); }
+inline vlong vnot(vlong m){ return !m; }
+inline bool vany(vlong m){ return m != 0; }
+inline vdouble vselect(bool m, vdouble a, vdouble b){ return m ? a : b; }
+inline vfloat vselect(bool m, vfloat a, vfloat b){ return m ? a : b; }
+
+#endif
+
+/*! \name Verses escalares
+
+Chamam a biblioteca padro. Com elas uma correlao pode ser escrita como um template vlido para double e vdouble (ver, por exemplo, virialTerms em ashrae.cpp): a verso escalar d exatamente o mesmo resultado que a expresso original com std::exp, std::pow, ...
+*/
+///@{
+inline double vexp(double x){ return std::exp(x); }
+inline double vexp10(double x){ return std::pow(10.0, x); }
+inline double vlog(double x){ return std::log(x); }
+inline double vpow(double x, double y){ return std::pow(x, y); }
+inline double vipow(double x, int n){ return std::pow(x, n); }
+inline double vsqrt(double x){ return std::sqrt(x); }
+inline float vexp(float x){ return std::exp(x); }
+inline float vexp10(float x){ return std::pow(10.0f, x); }
+inline float vlog(float x){ return std::log(x); }
+inline float vpow(float x, float y){ return std::pow(x, y); }
+inline float vipow(float x, int n){ return std::pow(x, n); }
+inline float vsqrt(float x){ return std::sqrt(x); }
+///@}
+
+/// Carrega os elementos de um vetor V a partir de p (sem exigncia de alinhamento). S  o tipo dos elementos de V, double ou float
+template<class V = vdouble, class S>
+inline V vload(const S *p){
+  V x;
+  memcpy(&x, p, sizeof(x));
+  return x;
+}
+
+/// Armazena os elementos de x em p
+template<class V, class S>
+inline void vstore(S *p, const V &x){
+  memcpy(p, &x, sizeof(x));
+}
+
+/*! Carrega os n elementos finais de um vetor, n menor que o nmero de elementos de V. Os elementos restantes recebem o ltimo valor, para que as funes vetoriais no recebam valores invlidos.
+ */
+template<class V = vdouble, class S>
+inline V vload_tail(const S *p, size_t n){
+  const size_t L = vtraits<V>::L;
+  S b[L];
+  for (size_t i = 0; i < L; ++i) b[i] = p[i < n ? i : n-1];
+  return vload<V>(b);
+}
+
+/// Armazena os n primeiros elementos de x
+template<class V, class S>
+inline void vstore_tail(S *p, const V &x, size_t n){
+  S b[vtraits<V>::L];
+  vstore(b, x);
+  for (size_t i = 0; i < n; ++i) p[i] = b[i];
+}
+
+
+/*! \brief Chama a funo template f<V>(...) com o vetor V do nvel selecionado por simd_level()
+
+f  em geral uma funo membro template da classe que chama (ver, por exemplo, Ashrae::PwsBatch e Ashrae::PwsLanes). No x86, as verses SSE4.2, AVX2 e AVX-512 so chamadas atravs de funes lambda com os atributos target e flatten: f e todas as funes que ela chama diretamente (vexp, vlog, ...) so expandidas no corpo da lambda e compiladas para aquele conjunto de instrues, mesmo que a biblioteca seja compilada para o x86-64 bsico. As funes virtuais chamadas por f (outras funes em lote) continuam sendo chamadas e fazem a sua prpria seleo; por isso as funes que contm a seleo so declaradas com PSYCHRO_NOINLINE, que impede que flatten expanda, atravs da devirtualizao especulativa, a seleo de uma delas (com as suas 5 verses) dentro de cada verso de outra.
+*/
+#define PSYCHRO_SIMD_DISPATCH(f, ...)					\
+  switch (simd_level()){						\
+  PSYCHRO_SIMD_X86_CASES(f, __VA_ARGS__)				\
+  case SIMD_SCALAR: PSYCHRO_SIMD_SCALAR_CALL(f, __VA_ARGS__); break;	\
+  default: f<vdouble>(__VA_ARGS__); break;				\
+  }
+
+/*! \brief Chama a funo template fn<V>(...) com o vetor float V do nvel selecionado por simd_level()
+
+Como PSYCHRO_SIMD_DISPATCH, com vetores float do mesmo tamanho: 16, 8 e 4 elementos no AVX-512, AVX2 e SSE4.2 e 2*PSYCHRO_LANES no nvel base (ver Psychro::batchFloat).
+*/
+#define PSYCHRO_SIMD_DISPATCH_FLOAT(fn, ...)				\
+  switch (simd_level()){						\
+  PSYCHRO_SIMD_X86_CASES_FLOAT(fn, __VA_ARGS__)				\
+  case SIMD_SCALAR: PSYCHRO_SIMD_SCALAR_CALL_FLOAT(fn, __VA_ARGS__); break; \
+  default: fn<vfloat>(__VA_ARGS__); break;				\
+  }
+
+#if defined(__GNUC__)
+/// Funo que contm PSYCHRO_SIMD_DISPATCH: nunca  expandida em quem a chama
+#define PSYCHRO_NOINLINE __attribute__((noinline))
+#define PSYCHRO_SIMD_SCALAR_CALL(f, ...) f<vtypes<1>::d>(__VA_ARGS__)
+#define PSYCHRO_SIMD_SCALAR_CALL_FLOAT(fn, ...) fn<vftypes<1>::f>(__VA_ARGS__)
+#else
+#define PSYCHRO_NOINLINE
+#define PSYCHRO_SIMD_SCALAR_CALL(f, ...) f<vdouble>(__VA_ARGS__)
+#define PSYCHRO_SIMD_SCALAR_CALL_FLOAT(fn, ...) fn<vfloat>(__VA_ARGS__)
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define PSYCHRO_SIMD_X86_CASES(f, ...)					\
+  case SIMD_AVX512:							\
+    [&]() __attribute__((target("avx512f"), flatten)) { f<vtypes<8>::d>(__VA_ARGS__); }(); \
+    break;								\
+  case SIMD_AVX2:							\
+    [&]() __attribute__((target("avx2,fma"), flatten)) { f<vtypes<4>::d>(__VA_ARGS__); }(); \
+    break;								\
+  case SIMD_SSE42:							\
+    [&]() __attribute__((target("sse4.2"), flatten)) { f<vtypes<2>::d>(__VA_ARGS__); }(); \
+    break;
+#define PSYCHRO_SIMD_X86_CASES_FLOAT(fn, ...)				\
+  case SIMD_AVX512:							\
+    [&]() __attribute__((target("avx512f"), flatten)) { fn<vftypes<16>::f>(__VA_ARGS__); }(); \
+    break;								\
+  case SIMD_AVX2:							\
+    [&]() __attribute__((target("avx2,fma"), flatten)) { fn<vftypes<8>::f>(__VA_ARGS__); }(); \
+    break;								\
+  case SIMD_SSE42:							\
+    [&]() __attribute__((target("sse4.2"), flatten)) { fn<vftypes<4>::f>(__VA_ARGS__); }(); \
+    break;
+#else
+#define PSYCHRO_SIMD_X86_CASES(f, ...)
+#define PSYCHRO_SIMD_X86_CASES_FLOAT(fn, ...)
+#endif
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+
+#endif
@@ -1,7 +1,14 @@
 #include <cmath>
 #include <iostream>
+#include <typeinfo>
 
 #include <psychro/psychro.h>
+#include <psychro/models.h>
+
+#if defined(__GNUC__)
+// As funes vetoriais deste arquivo retornam os vetores de 4 e 8 elementos (ver vecmath.h)
+#pragma GCC diagnostic ignored "-Wpsabi"
+#endif
 
 
 
@@ -15,6 +22,157 @@ Ashrae::Ashrae(){
   Tmax = 473.15;
   Pmin = 0.0;
   Pmax = 5e6;
+
+  virialMethod = VIRIAL_HALLEY;
+  perfectGasSeed = true;
+}
+
+
+/*! Modelo de gs perfeito que fornece os valores iniciais dos mtodos iterativos quando perfectGasSeed  verdadeiro. As suas funes so explcitas ou baratas (calores especficos constantes, sem equao virial); a tolerncia do bulbo mido  relaxada, pois o resultado  apenas um valor inicial.
+ */
+const GasPerfeito &Ashrae::seedModel(){
+  static const GasPerfeito m = [](){
+    GasPerfeito g;
+    g.tol = Tolerances::accuracy(1e-3, 1e-6);
+    return g;
+  }();
+  return m;
+}
+
+
+/*! Ativa o modo rpido: Pws, Tws (e PwsdPws) so substitudas por polinmios de Chebyshev por partes em toda a faixa [Tmin, Tmax] do modelo e o enhancement factor na faixa de operao [Tlo, Thi] x [Plo, Phi] fornecida. As tabelas so geradas a partir das funes exatas (virtuais, portanto valem para as classes derivadas) e o erro relativo mximo de cada uma, verificado entre os ns de interpolao,  inferior a tol. Fora dos domnios ajustados as funes exatas continuam sendo utilizadas.
+
+As tabelas s substituem as funes escalares. As verses vetoriais (PwsBatch, PwsdPwsBatch, TwsBatch, eFactorBatch e os mtodos em lote que as utilizam) continuam avaliando as funes exatas, vrios elementos de cada vez; seus resultados diferem dos escalares no mximo pela tolerncia tol.
+
+S so ajustadas as tabelas das funes indicadas por fastTables; em Giacomo, Pws e eFactor j so explcitas e s Tws  tabelada.
+
+Esta funo modifica o modelo e no deve ser chamada enquanto outras threads o utilizam. As tabelas so compartilhadas entre as cpias do modelo.
+
+\param Tlo Menor temperatura da faixa de operao em K
+\param Thi Maior temperatura da faixa de operao em K
+\param Plo Menor presso da faixa de operao em Pa (positiva)
+\param Phi Maior presso da faixa de operao em Pa
+\param tol Maior erro relativo admissvel
+\return 0 se o modo rpido foi ativado, 108 se a faixa  invlida ou se alguma tabela no atingiu a tolerncia (o modelo permanece no modo exato)
+*/
+int Ashrae::fastMode(double Tlo, double Thi, double Plo, double Phi, double tol){
+  exactMode();			// As tabelas so ajustadas s funes exatas
+  
+  if (!(Tlo < Thi) || Tlo < Tmin || Thi > Tmax || !(Plo < Phi) || Plo <= 0 || Phi > Pmax)
+    return 108;
+  
+  const double Tt = 273.15;
+  const double Ts = nextafter(Tt, 0.0); // Maior temperatura do ramo gelo
+  const int NX = 12;		// Grau dos polinmios de uma varivel
+  const int NE = 8;		// Grau em T e P do enhancement factor
+  
+  std::shared_ptr<FastTables> t(new FastTables);
+  const unsigned f = fastTables();
+  int e = 0;
+
+  if (Tmin < Tt){
+    double T1 = min(Tmax, Ts);
+    if (f & FAST_PWS)
+      e |= t->pws_s.fit([this, Ts](double T){ return Pws(min(T, Ts)); }, Tmin, T1, NX, tol);
+    double P1 = Pws(min(T1, Tt - 1e-6)); // Tws no converge exatamente no ponto triplo
+    if (f & FAST_TWS)
+      e |= t->tws_s.fit([this, P1](double u){ return Tws(min(exp(u), P1)); },
+			log(Pws(Tmin)), log(P1), NX, tol);
+  }
+  if (Tmax > Tt){
+    double T0 = max(Tmin, Tt);
+    double P0 = Pws(T0);
+    if (f & FAST_PWS)
+      e |= t->pws_l.fit([this](double T){ return Pws(T); }, T0, Tmax, NX, tol);
+    if (f & FAST_TWS)
+      e |= t->tws_l.fit([this, P0](double u){ return Tws(max(exp(u), P0)); },
+			log(P0), log(Pws(Tmax)), NX, tol);
+  }
+  if (f & FAST_EFACTOR){
+    if (Tlo < Tt)
+      e |= t->ef_s.fit([this, Ts](double T, double P){ return eFactor(min(T, Ts), P); },
+		       Tlo, min(Thi, Ts), Plo, Phi, NE, NE, tol, 64);
+    if (Thi > Tt)
+      e |= t->ef_l.fit([this](double T, double P){ return eFactor(T, P); },
+		       max(Tlo, Tt), Thi, Plo, Phi, NE, NE, tol, 64);
+  }
+
+  if (e) return 108;
+
+  fast = t;
+  cache.clear();
+  return 0;
+}
+
+
+/*! Resumo da configurao (ver Psychro::configHash): alm das faixas e das tolerncias, o mtodo da equao virial, perfectGasSeed e as tabelas do modo rpido (pelo seu identificador, pois tabelas novas podem ocupar o endereo de outras j descartadas).
+\return Hash da configurao
+*/
+uint64_t Ashrae::configHash() const{
+  uint64_t tabelas = fast ? fast->id.value : 0;
+  uint64_t h = Psychro::configHash();
+  h = hash_bytes(&virialMethod, sizeof(virialMethod), h);
+  h = hash_bytes(&perfectGasSeed, sizeof(perfectGasSeed), h);
+  return hash_bytes(&tabelas, sizeof(tabelas), h);
+}
+
+
+/*! Funes tabeladas por fastMode. As classes derivadas que substituem alguma destas funes por uma expresso explcita (que no consulta as tabelas) devem retir-la, para que fastMode no ajuste tabelas que nunca sero utilizadas.
+\return Combinao de FastFunction (todas em Ashrae)
+*/
+unsigned Ashrae::fastTables() const{
+  return FAST_PWS | FAST_TWS | FAST_EFACTOR;
+}
+
+
+/*! Desativa o modo rpido: todas as funes de saturao voltam a ser calculadas exatamente
+ */
+void Ashrae::exactMode(){
+  fast.reset();
+  cache.clear();
+}
+
+
+/*! Presso de vapor tabelada
+\param T Temperatura em K
+\param p Recebe a presso de vapor em Pa
+\param dp Se no for nulo, recebe dP/dT em Pa/K
+\return true se T est no domnio das tabelas
+*/
+bool Ashrae::FastTables::Pws(double T, double &p, double *dp) const{
+  const ChebyshevTable &t = (T < 273.15) ? pws_s : pws_l;
+  if (!t.contains(T)) return false;
+  p = t(T, dp);
+  return true;
+}
+
+
+/*! Temperatura de saturao tabelada
+\param P Presso de vapor em Pa
+\param T Recebe a temperatura de saturao em K
+\return true se P est no domnio das tabelas
+*/
+bool Ashrae::FastTables::Tws(double P, double &T) const{
+  if (!(P > 0)) return false;
+  double u = log(P);
+  if (tws_s.contains(u)) T = tws_s(u);
+  else if (tws_l.contains(u)) T = tws_l(u);
+  else return false;
+  return true;
+}
+
+
+/*! Enhancement factor tabelado
+\param T Temperatura em K
+\param P Presso em Pa
+\param f Recebe o enhancement factor
+\return true se (T, P) est no domnio das tabelas
+*/
+bool Ashrae::FastTables::eFactor(double T, double P, double &f) const{
+  const ChebyshevTable &t = (T < 273.15) ? ef_s : ef_l;
+  if (!t.contains(T, P)) return false;
+  f = t(T, P);
+  return true;
 }
 
   
@@ -23,7 +181,7 @@ Ashrae::Ashrae(){
 \param Tk Temperatura em k
 \return Coeficiente virial Baa em \f$m^3/kmol\f$
 */
-double Ashrae::Baa(double Tk){
+double Ashrae::Baa(double Tk) const{
   double B = 0.349568e2 - 0.668772e4/Tk - 0.210141e7/(Tk*Tk) + 0.924746e8/(Tk*Tk*Tk);
 
   return(B/1e3); //# m3/kmol
@@ -36,7 +194,7 @@ double Ashrae::Baa(double Tk){
 \param Tk Temperatura em k
 \return Coeficiente virial \f$B'\f$ em 1/Pa
 */
-double Ashrae::Blinha(double Tk){
+double Ashrae::Blinha(double Tk) const{
   double B = 0.70e-8 - 0.147184e-8 * exp(1734.29/Tk);// # Pa^(-1)
   return(B);
 }
@@ -46,7 +204,7 @@ double Ashrae::Blinha(double Tk){
 \param Tk Temperatura em k
 \return Terceiro coeficiente virial \f$C'\f$ em \f$1/Pa^2\f$
 */
-double Ashrae::Clinha(double Tk){
+double Ashrae::Clinha(double Tk) const{
   double C = 0.104e-14 - 0.335297e-17*exp(3645.09/Tk);// # Pa^(-2)
   return(C);
 
@@ -57,7 +215,7 @@ double Ashrae::Clinha(double Tk){
 \param Tk Temperatura em k
 \return derivada do coeficiente virial \f$dB'/dT\f$ em 1/(Pa.K)
 */
-double Ashrae::dBlinha(double Tk){
+double Ashrae::dBlinha(double Tk) const{
   double dB = 0.255260e-5/(Tk*Tk) * exp(1734.29/Tk);
   return(dB);
 
@@ -69,7 +227,7 @@ double Ashrae::dBlinha(double Tk){
 \param Tk Temperatura em k
 \return Derivada doerceiro coeficiente virial \f$dC'dT\f$ em \f$1/(Pa^2K)\f$
 */
-double Ashrae::dClinha(double Tk){
+double Ashrae::dClinha(double Tk) const{
   double dC = 0.122219e-13/(Tk*Tk) * exp(3645.09/Tk);
   return(dC);
 
@@ -81,7 +239,7 @@ double Ashrae::dClinha(double Tk){
 \param Tk Temperatura em k
 \return Coeficiente virial \f$B_{ww}\f$ em \f$m^3/kmol\f$
 */
-double Ashrae::Bww(double Tk){
+double Ashrae::Bww(double Tk) const{
   double B = R * Tk * Blinha(Tk);
   return(B);
 
@@ -93,7 +251,7 @@ double Ashrae::Bww(double Tk){
 \param Tk Temperatura em k
 \return Coeficiente virial \f$B_{aw}\f$ em \f$m^3/kmol\f$
 */
-double Ashrae::Baw(double Tk){
+double Ashrae::Baw(double Tk) const{
   double B = 0.32366097e2 - 0.141138e5/Tk - 0.1244535e7/(Tk*Tk) - 0.2348789e10/(Tk*Tk*Tk*Tk);
 
   return(B/1e3);
@@ -105,7 +263,7 @@ double Ashrae::Baw(double Tk){
 \param Tk Temperatura em k
 \return Derivada do coeficiente virial \f$dB_{aa}/dT\f$ em \f$m^3/(kmol\cdot K)\f$
 */
-double Ashrae::dBaa(double Tk){
+double Ashrae::dBaa(double Tk) const{
   double dB =  0.668772e4/(Tk*Tk) + 0.420282e7/(Tk*Tk*Tk) - 0.277424e9/(Tk*Tk*Tk*Tk);
 
   return(dB/1e3);// #m3/kmol.K
@@ -118,7 +276,7 @@ double Ashrae::dBaa(double Tk){
 \param Tk Temperatura em k
 \return Derivada do coeficiente virial \f$dB_{ww}/dT\f$ em \f$m^3/(kmol\cdot K)\f$
 */
-double Ashrae::dBww(double Tk){
+double Ashrae::dBww(double Tk) const{
   double dB = R * (Tk * dBlinha(Tk) + Blinha(Tk));
   return(dB);
 
@@ -130,7 +288,7 @@ double Ashrae::dBww(double Tk){
 \param Tk Temperatura em k
 \return Derivada do coeficiente virial \f$dB_{aw}/dT\f$ em \f$m^3/(kmol\cdot K)\f$
 */
-double Ashrae::dBaw(double Tk){
+double Ashrae::dBaw(double Tk) const{
   double dB = 0.141138e5/(Tk*Tk) + 0.248907e7/(Tk*Tk*Tk) + 0.93951568e10/pow(Tk, 5);
   return(dB / 1e3);
 
@@ -143,7 +301,7 @@ double Ashrae::dBaw(double Tk){
 \param Tk Temperatura em k
 \return Coeficiente virial \f$Caaa\f$ em \f$m^6/kmol^2\f$
 */
-double Ashrae::Caaa(double Tk){
+double Ashrae::Caaa(double Tk) const{
   double C = 0.125975e4 - 0.190905e6/Tk + 0.632467e8/(Tk*Tk);
   return(C/1e6);//  #m6/kmol2
 
@@ -156,7 +314,7 @@ double Ashrae::Caaa(double Tk){
 \param Tk Temperatura em k
 \return Coeficiente virial \f$Cwww\f$ em \f$m^6/kmol^2\f$
 */
-double Ashrae::Cwww(double Tk){
+double Ashrae::Cwww(double Tk) const{
   double C = R*Tk*R*Tk * (Clinha(Tk) + pow(Blinha(Tk), 2));
   return(C);
 
@@ -167,7 +325,7 @@ double Ashrae::Cwww(double Tk){
 \param Tk Temperatura em k
 \return Coeficiente virial \f$Caaw\f$ em \f$m^6/kmol^2\f$
 */
-double Ashrae::Caaw(double Tk){
+double Ashrae::Caaw(double Tk) const{
   double C = 0.482737e3 + 0.105678e6/Tk - 0.656394e8/(Tk*Tk) + 0.294442e11/(Tk*Tk*Tk)
     - 0.319317e13/(Tk*Tk*Tk*Tk);
   return(C/1e6);
@@ -179,7 +337,7 @@ double Ashrae::Caaw(double Tk){
 \param Tk Temperatura em k
 \return Coeficiente virial \f$Caww\f$ em \f$m^6/kmol^2\f$
 */
-double Ashrae::Caww(double Tk){
+double Ashrae::Caww(double Tk) const{
   double C =  -1e6* exp( -0.10728876e2 + 0.347802e4/Tk - 0.383383e6/(Tk*Tk)
 			 + 0.33406e8/(Tk*Tk*Tk));
   return(C/1e6);
@@ -193,7 +351,7 @@ double Ashrae::Caww(double Tk){
 \param Tk Temperatura em k
 \return Coeficiente virial \f$dC_{aaa}/dT\f$ em \f$m^6/(kmol^2\cdot K)\f$
 */
-double Ashrae::dCaaa(double Tk){
+double Ashrae::dCaaa(double Tk) const{
   double dC = 0.190905e6/(Tk*Tk) - 0.126493e9/(Tk*Tk*Tk);
   return(dC/1e6);//#m6/kmol2.K
 
@@ -206,7 +364,7 @@ double Ashrae::dCaaa(double Tk){
 \param Tk Temperatura em k
 \return Coeficiente virial \f$dC_{www}/dT\f$ em \f$m^6/(kmol^2\cdot K)\f$
 */
-double Ashrae::dCwww(double Tk){
+double Ashrae::dCwww(double Tk) const{
   double dC = R*Tk*R*Tk * (dClinha(Tk) + 2*Blinha(Tk) * dBlinha(Tk)) +
     (2*R*R*Tk) * (Clinha(Tk) + pow(Blinha(Tk),2));
   return(dC);
@@ -218,7 +376,7 @@ double Ashrae::dCwww(double Tk){
 \param Tk Temperatura em k
 \return Coeficiente virial \f$dC_{aaw}/dT\f$ em \f$m^6/(kmol^2\cdot K)\f$
 */
-double Ashrae::dCaaw(double Tk){
+double Ashrae::dCaaw(double Tk) const{
   double dC = -0.105678e6/(Tk*Tk) + 1.312788e8/(Tk*Tk*Tk) - 8.83326e10/pow(Tk,4)
     + 1.277268e13/pow(Tk,5);
   return(dC/1e6);
@@ -230,7 +388,7 @@ double Ashrae::dCaaw(double Tk){
 \param Tk Temperatura em k
 \return Coeficiente virial \f$dC_{aww}/dT\f$ em \f$m^6/(kmol^2\cdot K)\f$
 */
-double Ashrae::dCaww(double Tk){
+double Ashrae::dCaww(double Tk) const{
   double dC = -0.347802e4/(Tk*Tk) + 2*0.383383e6/(Tk*Tk*Tk) - 3*0.33406e8/pow(Tk,4);
 
   return(dC * Caww(Tk));
@@ -244,7 +402,7 @@ double Ashrae::dCaww(double Tk){
 \param xv Frao molar de vapor da mistura
 \return \f$B_m\f$ em \f$m^3/kmol\f$
 */
-double Ashrae::Bm(double Tk, double xv){
+double Ashrae::Bm(double Tk, double xv) const{
   double xa = 1.0-xv;
 
   return(xa*xa*Baa(Tk) + 2*xa*xv*Baw(Tk) + xv*xv*Bww(Tk));
@@ -258,7 +416,7 @@ double Ashrae::Bm(double Tk, double xv){
 \param xv Frao molar de vapor da mistura
 \return \f$C_m\f$ em \f$m^6/kmol^2\f$
 */
-double Ashrae::Cm(double Tk, double xv){
+double Ashrae::Cm(double Tk, double xv) const{
   double xa = 1.0-xv;
   return(xa*xa*xa*Caaa(Tk) + 3*xa*xa*xv*Caaw(Tk) +
          3*xa*xv*xv*Caww(Tk) + xv*xv*xv*Cwww(Tk));
@@ -269,74 +427,163 @@ double Ashrae::Cm(double Tk, double xv){
 
 
 
-/*! Presso do vapor saturado em equilbrio com a gua lquida. A equao  vlida para 273.15 < T < 473.15. Equao retirada de [3]
-\param Tk Temperatura em K, deve ser superior a 273.15
-\return Presso de vapor em Pa
+
+/// Coeficientes de kappa_l para Tc < 100 (ver AshraeCorrelations::kappa_l)
+const double AshraeCorrelations::kappa_l0[7] = {50.88496, 0.6163813, 1.459187e-3, 20.08438e-6,
+						-58.47727e-9, 410.4110e-12, 19.67348e-3};
+/// Coeficientes de kappa_l para Tc >= 100
+const double AshraeCorrelations::kappa_l100[7] = {50.884917, 0.62590623, 1.3848668e-3, 21.603427e-6,
+						  -72.087667e-9, 465.45054e-12, 19.859983e-3};
+
+
+/*! Calcula todos os coeficientes viriais (Baa, Bww, Baw, Caaa, Cwww, Caaw e Caww) e suas derivadas em relao  temperatura de uma s vez. As potncias de 1/T e as exponenciais de \f$B'\f$, \f$C'\f$ e \f$C_{aww}\f$ so calculadas apenas uma vez. As expresses so as mesmas das funes individuais (Baa, dBaa, ...).
+\param Tk Temperatura em K
+\return Coeficientes viriais e derivadas
 */
-double Ashrae::Pws_l(double Tk){
-  // Esta funo calcula a presso de saturao do vapor sobre gua:
+Ashrae::VirialSet Ashrae::virial(double Tk) const{
+  return AshraeCorrelations::virialSet(Tk);
+}
 
-  double g[] = {-0.58002206e4,
-          0.13914993e1,
-         -0.48640239e-1,
-          0.41764768e-4,
-         -0.14452093e-7,
-		0.65459673e1};
-  
 
-  double lnP = g[0]/Tk + g[1] + g[2]*Tk + g[3]*Tk*Tk + g[4]*Tk*Tk*Tk + g[5]* log(Tk);
+/*! Coeficientes viriais e derivadas de n temperaturas (ver virial). As expresses so avaliadas com vtraits<V>::L temperaturas de cada vez e as exponenciais por vexp (ver vecmath.h); o resultado difere de virial por poucos ULP. Se a verso vetorial no corresponder ao tipo dinmico (ver GasPerfeito::nativeBatch), cada temperatura  calculada por virial.
+\param n Nmero de temperaturas
+\param T Temperaturas em K
+\param v Recebe os coeficientes
+*/
+PSYCHRO_NOINLINE void Ashrae::virialBatch(size_t n, const double *T, VirialSet *v) const{
+  if (!nativeBatch()){
+    for (size_t i = 0; i < n; ++i) v[i] = virial(T[i]);
+    return;
+  }
 
-  return(exp(lnP));
+  PSYCHRO_SIMD_DISPATCH(virialLanes, n, T, v);
+}
 
+/// virialBatch com o vetor V (ver PSYCHRO_SIMD_DISPATCH)
+template<class V>
+void Ashrae::virialLanes(size_t n, const double *T, VirialSet *v) const{
+  const size_t L = vtraits<V>::L;
+  V c[14];
+  double b[14][L], cj[14];
+
+  for (size_t i = 0; i < n; i += L){
+    size_t m = (n - i < L) ? n - i : L;
+    AshraeCorrelations::virial((m == L) ? vload<V>(T+i) : vload_tail<V>(T+i, m), c);
+    for (int k = 0; k < 14; ++k) vstore(b[k], c[k]);
+    for (size_t j = 0; j < m; ++j){
+      for (int k = 0; k < 14; ++k) cj[k] = b[k][j];
+      AshraeCorrelations::virialSet(cj, v[i+j]);
+    }
+  }
+}
+
+
+
+
+/*! Presso do vapor saturado em equilbrio com a gua lquida. A equao  vlida para 273.15 < T < 473.15. Equao retirada de [3]
+\param Tk Temperatura em K, deve ser superior a 273.15
+\return Presso de vapor em Pa
+*/
+double Ashrae::Pws_l(double Tk) const{
+  return AshraeCorrelations::Pws_l(Tk);
 }
 
 /*! Presso do vapor saturado em equilbrio com o gelo. A equao  vlida para 173.15 < T < 273.15. Equao retirada de [3]
 \param Tk Temperatura em K, deve ser inferior a 273.15
 \return Presso de vapor em Pa
 */
-double Ashrae::Pws_s(double Tk){
-  // Esta funo calcula a presso de saturao do vapor sobre gelo:
-  double m[] = {-0.56745359e4,
-          0.63925247e1,
-         -0.96778430e-2,
-          0.62215701e-6,
-          0.20747825e-8,
-         -0.94840240e-12,
-		0.41635019e1};
-  
-  
-  double lnP = m[0]/Tk + m[1] + m[2]*Tk + m[3]*Tk*Tk + m[4]*Tk*Tk*Tk +
-    m[5]*Tk*Tk*Tk*Tk + m[6]* log(Tk);
-  return(exp(lnP));
-
+double Ashrae::Pws_s(double Tk) const{
+  return AshraeCorrelations::Pws_s(Tk);
 }
 
 /*! Presso de vapor saturado. Para temperaturas inferiores a 273.15, supe um equilbrio com o gelo. Para temperaturas superiores supe o equilbrio com a gua
 \param Tk Temperatura em K
 \return Presso de vapor em Pa
 */
-double Ashrae::Pws(double Tk){
-  // Esta funo calcula a presso de saturao da gua:
+double Ashrae::Pws(double Tk, int *) const{
+  return AshraePws::Pws(*this, Tk);
+}
+
+/*! Presso de vapor saturado e sua derivada calculadas juntas: o logaritmo e a exponencial so avaliados uma nica vez.
+\param Tk Temperatura K
+\param dP Recebe dP/dT Pa/K
+\return Presso de vapor em Pa
+*/
+double Ashrae::PwsdPws(double Tk, double &dP) const{
+  return AshraePws::PwsdPws(*this, Tk, dP);
+}
+
+
+/*! Presso de vapor saturado de n temperaturas (ver Pws). As duas correlaes (gelo e gua) so avaliadas com vtraits<V>::L temperaturas de cada vez e o ramo de cada temperatura  selecionado por mscara (ver vecmath.h). O erro relativo em relao a Pws  da ordem de \f$10^{-14}\f$, dominado pela amplificao do erro de \f$\ln T\f$. A verso vetorial no utiliza as tabelas do modo rpido (ver fastMode): as correlaes exatas avaliadas em paralelo custam menos que as tabelas avaliadas uma temperatura de cada vez. Se a verso vetorial no corresponder ao tipo dinmico (ver GasPerfeito::nativeBatch), cada temperatura  calculada por Pws.
+\param n Nmero de temperaturas
+\param T Temperaturas em K
+\param p Recebe as presses em Pa
+*/
+PSYCHRO_NOINLINE void Ashrae::PwsBatch(size_t n, const double *T, double *p) const{
+  if (!nativeBatch()){
+    for (size_t i = 0; i < n; ++i) p[i] = Pws(T[i]);
+    return;
+  }
 
-  if (Tk < 273.15) return Pws_s(Tk);
+  PSYCHRO_SIMD_DISPATCH(PwsLanes, n, T, p);
+}
 
-  return Pws_l(Tk);
+/// PwsBatch com o vetor V (ver PSYCHRO_SIMD_DISPATCH)
+template<class V>
+void Ashrae::PwsLanes(size_t n, const double *T, double *p) const{
+  const size_t L = vtraits<V>::L;
+  for (size_t i = 0; i < n; i += L){
+    size_t m = (n - i < L) ? n - i : L;
+    V Tk = (m == L) ? vload<V>(T+i) : vload_tail<V>(T+i, m);
+    V P = vexp(AshraeCorrelations::lnPws(Tk));
+    if (m == L) vstore(p+i, P);
+    else vstore_tail(p+i, P, m);
+  }
+}
 
 
+/*! Presso de vapor saturado e sua derivada de n temperaturas (ver PwsdPws e PwsBatch). Como em PwsBatch, as tabelas do modo rpido no so utilizadas. Se a verso vetorial no corresponder ao tipo dinmico, cada temperatura  calculada por PwsdPws.
+\param n Nmero de temperaturas
+\param T Temperaturas em K
+\param p Recebe as presses em Pa
+\param dp Recebe dP/dT em Pa/K
+*/
+PSYCHRO_NOINLINE void Ashrae::PwsdPwsBatch(size_t n, const double *T, double *p, double *dp) const{
+  if (!nativeBatch()){
+    for (size_t i = 0; i < n; ++i) p[i] = PwsdPws(T[i], dp[i]);
+    return;
+  }
+
+  PSYCHRO_SIMD_DISPATCH(PwsdPwsLanes, n, T, p, dp);
+}
 
+/// PwsdPwsBatch com o vetor V (ver PSYCHRO_SIMD_DISPATCH)
+template<class V>
+void Ashrae::PwsdPwsLanes(size_t n, const double *T, double *p, double *dp) const{
+  const size_t L = vtraits<V>::L;
+  for (size_t i = 0; i < n; i += L){
+    size_t m = (n - i < L) ? n - i : L;
+    V Tk = (m == L) ? vload<V>(T+i) : vload_tail<V>(T+i, m);
+    V dlnP;
+    V P = vexp(AshraeCorrelations::lnPws(Tk, &dlnP));
+    V dP = P * dlnP;
+    if (m == L){
+      vstore(p+i, P);
+      vstore(dp+i, dP);
+    }else{
+      vstore_tail(p+i, P, m);
+      vstore_tail(dp+i, dP, m);
+    }
+  }
 }
 
+
 /*! Derivada de Pws_s
 /param Tk Temperatura K
 /return dP/dT Pa/K
 */
-double Ashrae::dPws_s(double Tk){
-  double termo1 = Pws_s(Tk);
-  double termo2 = 0.56745359e4/(Tk*Tk) + 0.41635019e1/Tk - 0.96778430e-2 +
-    0.12443140e-5*Tk + 0.62243475e-8 * Tk*Tk - 0.37936096e-11*Tk*Tk*Tk;
-
-  return(termo1 * termo2);
-
+double Ashrae::dPws_s(double Tk) const{
+  return Pws_s(Tk) * AshraeCorrelations::dlnPws_s(Tk);
 }
 
 
@@ -344,13 +591,8 @@ double Ashrae::dPws_s(double Tk){
 /param Tk Temperatura K
 /return dP/dT Pa/K
 */
-double Ashrae::dPws_l(double Tk){
-  double termo1 = Pws_l(Tk);
-  double termo2 = 0.58002206e4/(Tk*Tk) + 0.65459673e1/Tk - 0.48640239e-1 +
-    0.83529536e-4*Tk -0.43356279e-7 * Tk*Tk;
-
-  return(termo1 * termo2);
-
+double Ashrae::dPws_l(double Tk) const{
+  return Pws_l(Tk) * AshraeCorrelations::dlnPws_l(Tk);
 }
 
 
@@ -358,17 +600,37 @@ double Ashrae::dPws_l(double Tk){
 /param Tk Temperatura K
 /return dP/dT Pa/K
 */
-double Ashrae::dPws(double Tk){
-  // Esta funo calcula a presso de saturao da gua:
+double Ashrae::dPws(double Tk) const{
+  return AshraePws::dPws(*this, Tk);
+}
 
-  if (Tk < 273.15) return dPws_s(Tk);
 
-  return dPws_l(Tk);
 
-}
 
 
+/*! Estimativa explcita da temperatura de saturao, utilizada como valor inicial por Tws e DEWPOINT. Com perfectGasSeed  a correlao por trechos do gs perfeito, GasPerfeito::Tws (erro inferior a 0,02K em relao a Tws). Fora da faixa desta correlao, ou sem perfectGasSeed, utiliza-se a correlao desenvolvida por Paulo Jos Saiz Jabardo (erro inferior a 0,6K):
+\f[ T = g_0 + g_1 \ln P + g_2 (\ln P)^2 + g_3 (\ln P)^3 + g_4 (\ln P)^4 + g_5 P \f]
+\param PP Presso em Pa
+\return Temperatura de saturao aproximada em K
+*/
+double Ashrae::Tws0(double PP) const{
+  return Kernel<Ashrae>::Tws0(*this, PP);
+}
 
+/// Tws0 de vtraits<V>::L presses
+template<class V>
+V Ashrae::Tws0Lanes(const V &PP) const{
+  typedef typename vtraits<V>::mask M;
+  const size_t L = vtraits<V>::L;
+  V T0 = AshraeCorrelations::tws0(PP);
+  if (!perfectGasSeed) return T0;
+
+  double p[L], t[L];
+  vstore(p, PP);
+  seedModel().TwsBatch(L, p, t);
+  V Tg = vload<V>(t);
+  return vselect((M)(Tg == Tg), Tg, T0);
+}
 
 
 /*! Esta funo  a inversa de Pws. Ela  calculada utilizando o mtodo de Newton-Raphson. Para garantir uma boa convergncia, um valor inicial bom  adotado: Foi desenvolvida por Paulo Jos Saiz Jabardo uma correlao da forma:
@@ -377,41 +639,59 @@ Esta correla
 \param PP Presso em Pa
 \return Temperatura de saturao do vapor em K
 */
-double Ashrae::Tws(double PP){
-  // Esta funo retorna a presso de saturao do vapor. Inicialmente, ser utilizada uma
-  // aproximao construda a partir de um ajuste de curva dos dados obtidos de Pws. Este
-  // valor ser utilizado como chute inicial (muito prximo para uma iterao de Newton-Raphson
-
-  double g[]={2.127925e2,
-	      7.305398e0,
-	      1.969953e-1,
-	      1.103701e-2,
-	      1.849307e-3,
-	      5.145087e-6};
-  double lnP = log(PP);
-
-  double T = g[0] + g[1]*lnP + g[2]*lnP*lnP + g[3]*lnP*lnP*lnP +
-    g[4]*lnP*lnP*lnP*lnP + g[5] * PP;
+double Ashrae::Tws(double PP, int *err) const{
+  return Kernel<Ashrae>::Tws(*this, PP, err);
+}
 
-  const double NMAX=100;
-  const double EPS=1e-8;
 
-  double f, df, dT;
-  double Tnovo;
-  
-  for(int iter=0; iter < NMAX; ++iter){
-    f = PP-Pws(T);
-    df = - dPws(T);
-    dT = - f/df;
+/*! Temperatura de saturao de n presses (ver Tws). As iteraes de Newton-Raphson de vtraits<V>::L presses so feitas simultaneamente, com PwsdPwsBatch, congelando os elementos que j convergiram. As tabelas do modo rpido no so utilizadas; o resultado difere do de Tws no modo rpido no mximo pela tolerncia das tabelas. Se a verso vetorial no corresponder ao tipo dinmico, cada presso  calculada por Tws.
+\param n Nmero de presses
+\param P Presses em Pa
+\param T Recebe as temperaturas de saturao em K
+\param err Se no for nulo, err[i] recebe 106 se a iterao do elemento i no convergiu ou se P[i] no  positiva (T[i] recebe NaN); os demais elementos no so modificados
+*/
+PSYCHRO_NOINLINE void Ashrae::TwsBatch(size_t n, const double *P, double *T, int *err) const{
+  if (!nativeBatch()){
+    for (size_t i = 0; i < n; ++i) T[i] = Tws(P[i], err ? err+i : 0);
+    return;
+  }
 
-    T += dT;
+  PSYCHRO_SIMD_DISPATCH(TwsLanes, n, P, T, err);
+}
 
-    if (fabs(dT) < EPS) return T;
-    
+/// TwsBatch com o vetor V (ver PSYCHRO_SIMD_DISPATCH)
+template<class V>
+void Ashrae::TwsLanes(size_t n, const double *P, double *T, int *err) const{
+  typedef typename vtraits<V>::mask M;
+  const size_t L = vtraits<V>::L;
+  const int NMAX = 100;
+  const double EPS = tol.Tws;
+  double t[L], p[L], dp[L];
+
+  for (size_t i = 0; i < n; i += L){
+    size_t m = (n - i < L) ? n - i : L;
+    V Pk = (m == L) ? vload<V>(P+i) : vload_tail<V>(P+i, m);
+    M invalido = vnot((M)(Pk > 0.0));
+    Pk = vselect(invalido, vset<V>(1000.0), Pk);
+
+    V Tk = Tws0Lanes(Pk);
+    M active = vnot(invalido);
+    for (int iter = 0; iter < NMAX && vany(active); ++iter){
+      vstore(t, Tk);
+      PwsdPwsBatch(L, t, p, dp);
+      V dT = (Pk - vload<V>(p)) / vload<V>(dp);
+      Tk = vselect(active, Tk + dT, Tk);
+      active = active & vnot((M)(vfabs(dT) < EPS));
+    }
+    Tk = vselect(invalido, vset<V>(NAN), Tk);
+    active = active | invalido;
+
+    if (m == L) vstore(T+i, Tk);
+    else vstore_tail(T+i, Tk, m);
+    if (err)
+      for (size_t j = 0; j < m; ++j)
+	if (active[j]) err[i+j] = 106;
   }
-  errorcode = 106;
-  
-  return T;
 }
 
 
@@ -423,10 +703,20 @@ double Ashrae::Tws(double PP){
 \param xv Frao molar de vapor
 \return Volume molar da mistura ar-vapor em \f$m^3/kmol\f$
 */
-double Ashrae::vM_(double Tk, double P, double xv){
+double Ashrae::vM_(double Tk, double P, double xv, int *err) const{
+  return Kernel<Ashrae>::vM_(*this, Tk, P, xv, err);
+}
 
-  return Z(Tk, P, xv) * R*Tk/P;
-  
+
+/*! Volume molar da mistura a partir dos coeficientes viriais v j calculados na temperatura Tk (ver SaturationPoint). O resultado  o mesmo de vM_, que recalcula os coeficientes.
+\param v Coeficientes viriais em Tk
+\param Tk Temperatura em K
+\param P Presso em Pa
+\param xv Frao molar de vapor
+\return Volume molar da mistura ar-vapor em \f$m^3/kmol\f$
+*/
+double Ashrae::vMfromVirial(const VirialSet &v, double Tk, double P, double xv, int *err) const{
+  return AshraeZ::vMfromVirial(*this, v, Tk, P, xv, err);
 }
 
 
@@ -434,8 +724,8 @@ double Ashrae::vM_(double Tk, double P, double xv){
 \param Tk Temperatura em K
 \return v em \f$m^3/kg\f$
 */
-double Ashrae::v_v_(double Tk){
-  return(vM_v_(Tk)/Mv);
+double Ashrae::v_v_(double Tk, int *err) const{
+  return(vM_v_(Tk, err)/Mv);
   
 }
 
@@ -443,8 +733,8 @@ double Ashrae::v_v_(double Tk){
 \param Tk Temperatura em K
 \return \f$\rho\f$ em \f$kg/m^3\f$
 */
-double Ashrae::r_v_(double T){
-  return 1.0/v_v_(T);
+double Ashrae::r_v_(double T, int *err) const{
+  return 1.0/v_v_(T, err);
 }
 
 
@@ -460,28 +750,80 @@ Nesta equa
 \param xv Frao molar de vapor
 \return Z
 */
-double Ashrae::Z(double Tk, double P, double xv){
-  double xa = 1.0-xv;
+double Ashrae::Z(double Tk, double P, double xv, int *err) const{
+  return AshraeZ::Z(*this, Tk, P, xv, err);
+}
 
-  double vmi =  R*Tk/P;
-  double vm  = vmi;
-  double vmn;
-  double b = Bm(Tk, xv);
-  double c = Cm(Tk, xv);
-  const double NMAX = 100;
-  const double EPS=1e-8;
-  double erro;
-  for (int iter = 0; iter < NMAX; ++iter){
-    vmn = R*Tk/P * (1 + b/vm + c/(vm*vm));
-    erro = fabs(vmn - vm);
-    vm = vmn;
-
-    if (erro < EPS) return vm/vmi;
+
+/*! Compressibilidade de n estados (ver Z). Os estados so resolvidos vrios de cada vez: coeficientes viriais vetoriais (ver virialBatch) e equao virial com uma mscara de convergncia por elemento. Com VIRIAL_HALLEY o resultado  o mesmo de Z a menos do arredondamento dos coeficientes viriais. Se a verso vetorial no corresponder ao tipo dinmico (ver GasPerfeito::nativeBatch), cada estado  calculado por Z.
+\param n Nmero de estados
+\param T Temperaturas em K
+\param P Presses em Pa
+\param xv Fraes molares de vapor
+\param Z Recebe as compressibilidades
+\param err Se no for nulo, err[i] recebe 107 se a equao virial do estado i no convergiu (os demais elementos no so modificados)
+*/
+PSYCHRO_NOINLINE void Ashrae::ZBatch(size_t n, const double *T, const double *P, const double *xv,
+		    double *Z, int *err) const{
+  if (!nativeBatch()){
+    for (size_t i = 0; i < n; ++i) Z[i] = this->Z(T[i], P[i], xv[i], err ? err+i : 0);
+    return;
   }
-  errorcode = 107;
-  return(vm/vmi);
 
+  PSYCHRO_SIMD_DISPATCH(ZLanes, n, T, P, xv, Z, err);
+}
 
+/// ZBatch com o vetor V (ver PSYCHRO_SIMD_DISPATCH)
+template<class V>
+void Ashrae::ZLanes(size_t n, const double *T, const double *P, const double *xv,
+		    double *Z, int *err) const{
+  typedef typename vtraits<V>::mask M;
+  const size_t L = vtraits<V>::L;
+  V c[14];
+
+  for (size_t i = 0; i < n; i += L){
+    size_t m = (n - i < L) ? n - i : L;
+    V Tk = (m == L) ? vload<V>(T+i) : vload_tail<V>(T+i, m);
+    V Pk = (m == L) ? vload<V>(P+i) : vload_tail<V>(P+i, m);
+    V x = (m == L) ? vload<V>(xv+i) : vload_tail<V>(xv+i, m);
+
+    AshraeCorrelations::virial(Tk, c);
+    V xa = 1.0 - x;
+    V B = xa*xa*c[0] + 2*xa*x*c[2] + x*x*c[1];
+    V C = xa*xa*xa*c[3] + 3*xa*xa*x*c[5] + 3*xa*x*x*c[6] + x*x*x*c[4];
+
+    M fail;
+    V z = vMvirialLanes(virialMethod, Tk, Pk, B, C, 100, tol.volume, fail) / (R*Tk/Pk);
+
+    if (m == L) vstore(Z+i, z);
+    else vstore_tail(Z+i, z, m);
+    if (err)
+      for (size_t j = 0; j < m; ++j)
+	if (fail[j]) err[i+j] = 107;
+  }
+}
+
+
+/*! Soluo da equao virial 
+\f[ \frac{P v_m}{RT} = 1 + \frac{B}{v_m} + \frac{C}{v_m^2} \f]
+Utilizada por Z, vM_a_ e vM_v_. O mtodo depende de virialMethod:
+
+- VIRIAL_ITERATIVE: substituies sucessivas a partir do volume do gs perfeito at que a variao relativa seja menor que EPS.
+- VIRIAL_HALLEY: a equao  escrita como a cbica \f$ f(v) = v^3 - a v^2 - aB v - aC = 0\f$ com \f$a = RT/P\f$. Partindo de \f$v_0 = a + B\f$ (equao virial truncada no segundo coeficiente) so dados exatamente dois passos de Halley. No h teste de convergncia, o que torna o clculo previsvel. Comparado com a soluo exata, o erro relativo no volume molar  inferior a \f$2\times 10^{-13}\f$ em toda a faixa do modelo (173.15K a 473.15K, at 5MPa, qualquer frao molar at a saturao), menor que o erro da soluo iterativa (EPS=1e-10). Caso o resultado no seja positivo, utiliza-se a iterao.
+
+\param Tk Temperatura em K
+\param P Presso em Pa
+\param B Segundo coeficiente virial \f$m^3/kmol\f$
+\param C Terceiro coeficiente virial \f$m^6/kmol^2\f$
+\param NMAX Nmero mximo de iteraes
+\param EPS Tolerncia relativa no volume molar
+\param codigo Cdigo de erro caso no haja convergncia
+\param err Se no for nulo, recebe o cdigo de erro
+\return Volume molar \f$m^3/kmol\f$
+*/
+double Ashrae::vMvirial(double Tk, double P, double B, double C, int NMAX, double EPS,
+			int codigo, int *err) const{
+  return Kernel<Ashrae>::vMvirial(*this, Tk, P, B, C, NMAX, EPS, codigo, err);
 }
 
 
@@ -491,36 +833,105 @@ double Ashrae::Z(double Tk, double P, double xv){
 \f[ x_{sv} = f(T,P) \frac{P_{ws}(T)}{P} \f]
 Este fator  uma expresso grande est apresentada em [2]. Cuidado com a referncia [1] pois h um pequeno erro na expresso apresentada. Outro ponto  que a expresso para f(T,P) no  explcita e portanto  necessrio iterar. Nesta implementao, a iterao utiliza a funo auxiliar lnf.  interessante notar que em alguns casos o problema no converge ou converge para um valor estranho. Nestes casos, adotou-se o critrio f=1 (quando estes problemas ocorrem, isto  bem prximo da realidade)
 
+Para obter o cdigo de erro da iterao utiliza-se eFactor(saturation(Tk), P, &err).
 \param Tk Temperatura em K
 \param P Presso em Pa
 \return Enhancement Factor
 */
-double Ashrae::eFactor(double Tk, double P){
-  // Chute inicial para f: 1
-  double f = 1.0;
-  const double EPS = 1e-7;
-  const int NMAX = 50;
-  double xas;
-  double fnovo, m1;
+double Ashrae::eFactor(double Tk, double P) const{
+  return AshraeEFactor::eFactor(*this, Tk, P);
+}
 
-  for(int iter=0; iter < NMAX; ++iter){
-    
-    xas = (P-f*Pws(Tk))/P;
-    fnovo = exp(lnf(Tk, P, xas));
 
-    if (fabs(fnovo - f) < EPS) {
-      if (fnovo < 1.0) fnovo = 1.0;
-    
-      return(fnovo);
-    }
-    
+/*! Grandezas de saturao que s dependem da temperatura. Todas as funes de temperatura utilizadas no clculo do enhancement factor (Pws, v_f_, kappa_f, henryk e os coeficientes viriais) so calculadas uma nica vez. A presso de vapor e sua derivada vm de PwsdPws, de modo que uma classe derivada que redefine Pws deve redefinir tambm PwsdPws (como Giacomo).
+\param Tk Temperatura em K
+\return Grandezas de saturao
+*/
+Ashrae::SaturationPoint Ashrae::saturation(double Tk) const{
+  return Kernel<Ashrae>::saturation(*this, Tk);
+}
 
-    f = fnovo;
+/*! Enhancement factor calculado a partir das grandezas de saturao sp. Apenas os termos que dependem da frao molar de ar na saturao so recalculados a cada iterao.
+\param sp Grandezas de saturao (ver saturation)
+\param P Presso em Pa
+\param err Se no for nulo, recebe 109 se a iterao no convergir
+\return Enhancement Factor
+*/
+double Ashrae::eFactor(const SaturationPoint &sp, double P, int *err) const{
+  return eFactor(sp, P, 1.0, err);
+}
+
+/*! Enhancement factor partindo da estimativa f0, em geral o valor de uma amostra prxima (ver SolverContext). As substituies sucessivas convergem para o mesmo valor de eFactor(sp, P) dentro da tolerncia tol.eFactor. Uma classe derivada que redefine eFactor(sp, P) deve redefinir tambm esta funo (ver Giacomo).
+\param sp Grandezas de saturao (ver saturation)
+\param P Presso em Pa
+\param f0 Estimativa inicial
+\param err Se no for nulo, recebe 109 se a iterao no convergir (o resultado  o ltimo valor calculado)
+\return Enhancement Factor
+*/
+double Ashrae::eFactor(const SaturationPoint &sp, double P, double f0, int *err) const{
+  return AshraeEFactor::eFactor(*this, sp, P, f0, err);
+}
+
+
+/*! Enhancement factor de n estados (ver eFactor). As grandezas de saturao de vtraits<V>::L estados so calculadas de uma vez (PwsBatch, vfBatch, kappafBatch, henrykBatch e coeficientes viriais vetoriais) e as substituies sucessivas de ln f so feitas em paralelo, congelando os elementos que j convergiram. A verso vetorial no utiliza as tabelas do modo rpido: avaliada em vrios estados de cada vez, a iterao exata no  mais lenta que as tabelas avaliadas estado a estado, e o resultado difere do de eFactor no modo rpido no mximo pela tolerncia das tabelas (ver fastMode). Se a verso vetorial no corresponder ao tipo dinmico, cada estado  calculado por eFactor(saturation(T), P, err).
+\param n Nmero de estados
+\param T Temperaturas em K
+\param P Presses em Pa
+\param f Recebe os enhancement factors
+\param err Se no for nulo, err[i] recebe 109 se a iterao do estado i no convergiu (f  o ltimo valor calculado, como em eFactor; os demais elementos no so modificados)
+*/
+PSYCHRO_NOINLINE void Ashrae::eFactorBatch(size_t n, const double *T, const double *P, double *f,
+			  int *err) const{
+  if (!nativeBatch()){
+    for (size_t i = 0; i < n; ++i) f[i] = eFactor(saturation(T[i]), P[i], err ? err+i : 0);
+    return;
   }
 
-  if (fnovo < 1.0) fnovo = 1.0;
-  return fnovo;
+  PSYCHRO_SIMD_DISPATCH(eFactorLanes, n, T, P, f, err);
+}
+
+/// eFactorBatch com o vetor V (ver PSYCHRO_SIMD_DISPATCH)
+template<class V>
+void Ashrae::eFactorLanes(size_t n, const double *T, const double *P, double *f,
+			  int *err) const{
+  typedef typename vtraits<V>::mask M;
+  const size_t L = vtraits<V>::L;
+  const double EPS = tol.eFactor;
+  const int NMAX = 50;
+  double t[L], pws[L], vc[L], kk[L], k[L];
+  V c[14];
+
+  for (size_t i = 0; i < n; i += L){
+    size_t m = (n - i < L) ? n - i : L;
+    vstore(t, (m == L) ? vload<V>(T+i) : vload_tail<V>(T+i, m));
+    V Pk = (m == L) ? vload<V>(P+i) : vload_tail<V>(P+i, m);
+
+    PwsBatch(L, t, pws);
+    vfBatch(L, t, vc);
+    kappafBatch(L, t, kk);
+    henrykBatch(L, t, k);
+    V Tk = vload<V>(t), p = vload<V>(pws);
+    V K = vselect((M)(Tk < 273.15), vset<V>(0.0), vload<V>(k));
+    AshraeCorrelations::virial(Tk, c);
+
+    V fv = vset<V>(1.0);
+    M active = vnot(M());
+    for (int iter = 0; iter < NMAX && vany(active); ++iter){
+      V xas = (Pk - fv*p)/Pk;
+      V fnovo = vexp(AshraeCorrelations::lnf(Tk, Pk, xas, p, Mv*vload<V>(vc), vload<V>(kk), K,
+					     c[0], c[1], c[2], c[3], c[4], c[5], c[6]));
+      M conv = (M)(vfabs(fnovo - fv) < EPS);
+      fv = vselect(active, fnovo, fv);
+      active = active & vnot(conv);
+    }
+    fv = vselect((M)(fv < 1.0), vset<V>(1.0), fv);
 
+    if (m == L) vstore(f+i, fv);
+    else vstore_tail(f+i, fv, m);
+    if (err)
+      for (size_t j = 0; j < m; ++j)
+	if (active[j]) err[i+j] = 109;
+  }
 }
 
 
@@ -530,54 +941,107 @@ double Ashrae::eFactor(double Tk, double P){
 \xv Frao molar
 \return Entalpia em J/kg
 */
-double Ashrae::h_(double Tk, double P, double xv){
-
-  double  xa = 1.0 - xv;
-
-  double a[] = {0.63290874e1,
-         0.28709015e2,
-         0.26431805e-2,
-         -0.10405863e-4,
-         0.18660410e-7,
-		-0.9784331e-11};
-  double d[] = {-0.5008e-2,
-         0.32491829e2,
-         0.65576345e-2,
-         -0.26442147e-4,
-         0.51751789e-7,
-		-0.31541624e-10};
-
-  // Clculo dos coeficientes
-  double B = xa*xa * Baa(Tk) + 2*xa*xv*Baw(Tk) + xv*xv * Bww(Tk);
-  double C = xa*xa*xa*Caaa(Tk) + 3*xa*xa*xv*Caaw(Tk) + 3*xa*xv*xv*Caww(Tk) + xv*xv*xv*Cwww(Tk);
-
-  double dB = xa*xa * dBaa(Tk) + 2*xa*xv*dBaw(Tk) + xv*xv * dBww(Tk);
-  double dC = xa*xa*xa*dCaaa(Tk) + 3*xa*xa*xv*dCaaw(Tk) + 3*xa*xv*xv*dCaww(Tk) +
-    xv*xv*xv*dCwww(Tk);
-
+double Ashrae::h_(double Tk, double P, double xv, int *err) const{
+  return Kernel<Ashrae>::h_(*this, Tk, P, xv, err);
+}
 
-  double ha = -7914.1982;
-  double hv = 35994.17;
 
-  
-  double termo1 = a[0] + a[1]*Tk + a[2]*Tk*Tk + a[3]*Tk*Tk*Tk +
-    a[4]*Tk*Tk*Tk*Tk + a[5]*pow(Tk, 5) + ha;
+/*! Entalpia molar do ar mido (ver h_) e, opcionalmente, suas derivadas. A derivada em relao a xv  exata para a equao virial (inclui a variao do volume molar com a composio). A derivada em relao a T inclui as partes de gs perfeito e \f$R\cdot termo_3\f$ mas despreza \f$RT\, d(termo_3)/dT\f$, que exigiria as derivadas segundas dos coeficientes viriais e  da ordem de 0,1% do calor especfico.
+\param Tk Temperatura em K
+\param P Presso em Pa
+\param xv Frao molar
+\param dhdx Se no for nulo, recebe \f$\partial h_m/\partial x_v\f$ J/kmol
+\param dhdT Se no for nulo, recebe \f$\partial h_m/\partial T\f$ J/(kmol.K)
+\param err Se no for nulo, recebe o cdigo de erro
+\return Entalpia em J/kmol
+*/
+double Ashrae::hM_(double Tk, double P, double xv, double *dhdx, double *dhdT, int *err) const{
+  return Kernel<Ashrae>::hM_(*this, Tk, P, xv, dhdx, dhdT, err);
+}
 
-  
 
-  double termo2 = d[0] + d[1]*Tk + d[2]*Tk*Tk + d[3]*Tk*Tk*Tk +
-    d[4]*pow(Tk,4) + d[5]*pow(Tk,5) + hv;
+/*! Entalpia do ar mido por kg de ar seco, \f$H = (1+\omega) h\f$, e suas derivadas em relao ao teor de umidade e  temperatura (ver hM_). Utilizada no balano de energia do saturador adiabtico.
+\param Tk Temperatura em K
+\param P Presso em Pa
+\param w Teor de umidade kg de vapor / kg de ar seco
+\param dHdw Se no for nulo, recebe \f$\partial H/\partial \omega\f$ J/kg
+\param dHdT Se no for nulo, recebe \f$\partial H/\partial T\f$ J/(kg.K)
+\param err Se no for nulo, recebe o cdigo de erro
+\return Entalpia J/kg de ar seco
+*/
+double Ashrae::hw_(double Tk, double P, double w, double *dHdw, double *dHdT, int *err) const{
+  return Kernel<Ashrae>::hw_(*this, Tk, P, w, dHdw, dHdT, err);
+}
 
-  //# Clculo do volume molar
-  double Vm = vM_(Tk, P, xv);
 
-  
-  double termo3 = (B - Tk*dB)/Vm + (C - 0.5*Tk*dC)/(Vm*Vm);
+/*! Entalpia por kg de ar seco e derivadas (ver hw_) de n estados, vrios de cada vez. O volume molar  obtido de ZBatch, portanto a equao de estado do modelo (Ashrae ou Giacomo)  respeitada. Se a verso vetorial no corresponder ao tipo dinmico (ver GasPerfeito::nativeBatch), cada estado  calculado por hw_.
+\param n Nmero de estados
+\param T Temperaturas em K
+\param P Presses em Pa
+\param w Teores de umidade kg de vapor / kg de ar seco
+\param H Recebe as entalpias J/kg de ar seco
+\param dHdw Se no for nulo, recebe \f$\partial H/\partial \omega\f$ J/kg
+\param dHdT Se no for nulo, recebe \f$\partial H/\partial T\f$ J/(kg.K)
+\param err Se no for nulo, err[i] recebe o cdigo de erro de Z do estado i (os demais elementos no so modificados)
+*/
+PSYCHRO_NOINLINE void Ashrae::hwBatch(size_t n, const double *T, const double *P, const double *w, double *H,
+		     double *dHdw, double *dHdT, int *err) const{
+  if (!nativeBatch()){
+    for (size_t i = 0; i < n; ++i)
+      H[i] = hw_(T[i], P[i], w[i], dHdw ? dHdw+i : 0, dHdT ? dHdT+i : 0, err ? err+i : 0);
+    return;
+  }
 
-  double hm = xa * termo1 * 1000.0 + xv * termo2 * 1000.0 + R*Tk*termo3;
-  
-  return hm/(xa * Ma + xv*Mv);
+  PSYCHRO_SIMD_DISPATCH(hwLanes, n, T, P, w, H, dHdw, dHdT, err);
+}
 
+/// hwBatch com o vetor V (ver PSYCHRO_SIMD_DISPATCH)
+template<class V>
+void Ashrae::hwLanes(size_t n, const double *T, const double *P, const double *w, double *H,
+		     double *dHdw, double *dHdT, int *err) const{
+  const size_t L = vtraits<V>::L;
+  double t[L], p[L], x[L], z[L];
+  int e[L];
+  V c[14];
+
+  for (size_t i = 0; i < n; i += L){
+    size_t m = (n - i < L) ? n - i : L;
+    V Tk = (m == L) ? vload<V>(T+i) : vload_tail<V>(T+i, m);
+    V Pk = (m == L) ? vload<V>(P+i) : vload_tail<V>(P+i, m);
+    V wk = (m == L) ? vload<V>(w+i) : vload_tail<V>(w+i, m);
+
+    // Nmero de kmols de mistura por kg de ar seco
+    V nk = 1.0/Ma + wk/Mv;
+    V xv = wk / Mv / nk;
+
+    vstore(t, Tk);
+    vstore(p, Pk);
+    vstore(x, xv);
+    for (size_t j = 0; j < L; ++j) e[j] = 0;
+    ZBatch(L, t, p, x, z, e);
+    V Vm = vload<V>(z) * (R*Tk/Pk);
+
+    AshraeCorrelations::virial(Tk, c);
+    V dhdx, dhdT;
+    V hm = AshraeCorrelations::hM(Tk, Pk, xv, c, Vm, dHdw ? &dhdx : 0, dHdT ? &dhdT : 0);
+
+    V Hk = nk * hm;
+    if (m == L) vstore(H+i, Hk);
+    else vstore_tail(H+i, Hk, m);
+    if (dHdw){
+      V d = hm/Mv + dhdx / (Ma*Mv*nk);
+      if (m == L) vstore(dHdw+i, d);
+      else vstore_tail(dHdw+i, d, m);
+    }
+    if (dHdT){
+      V d = nk * dhdT;
+      if (m == L) vstore(dHdT+i, d);
+      else vstore_tail(dHdT+i, d, m);
+    }
+    if (err)
+      for (size_t j = 0; j < m; ++j)
+	if (e[j]) err[i+j] = e[j];
+  }
 }
 
 
@@ -587,40 +1051,18 @@ double Ashrae::h_(double Tk, double P, double xv){
 \param xas Estimativa da frao molar de saturao do ar
 \result Uma estimativa melhor de ln(f)
 */
-double Ashrae::lnf(double Tk, double P, double xas){
-  double vc = v_f_(Tk) * Mv;
-  double kk = kappa_f(Tk);
-  double k;
-  if (Tk < 273.15)
-    k = 0.0;
-  else
-    k = henryk(Tk);
-  
-  double RT = R*Tk;
-  double p = Pws(Tk);
-
-  double t1 = vc/RT * ( (1 + kk*p)*(P-p) - .5 * kk * (P*P - p*p) );
-  
-  double t2 = log(1.0 - k*xas*P) + (xas*xas*P/RT)*Baa(Tk) - (2*xas*xas*P/RT)*Baw(Tk);
-  
-  double t3 = -(P-p-xas*xas*P)/RT*Bww(Tk) + xas*xas*xas*P*P/(RT*RT) * Caaa(Tk);
-  
-  double t4 = 3*xas*xas*(1.0-2.0*xas)*P*P/(2*RT*RT) * Caaw(Tk) -
-    (3*xas*xas*(1-xas)*P*P)/(RT*RT)*Caww(Tk);
-  
-  double t5 = - ( (1.0+2.0*xas)*pow(1.0-xas, 2) * P*P - p*p)/(2.0*RT*RT) * Cwww(Tk);
-
-  double t6 = -xas*xas*(1.0-3.0*xas)*(1.0-xas)*P*P/(RT*RT) * Baa(Tk) * Bww(Tk) -
-    2.0*xas*xas*xas*(2.0-3.0*xas)*P*P/(RT*RT) * Baa(Tk) * Baw(Tk);
-  
-  double t7 = 6.0*xas*xas*pow(1.0-xas,2)*P*P/(RT*RT)*Bww(Tk)*Baw(Tk) -
-    3.0*pow(xas,4)*P*P/(2.0*RT*RT)*pow(Baa(Tk),2);
-  
-  double  t8 = -2.0*xas*xas*(1.0-xas)*(1.0-3.0*xas)*P*P/(RT*RT) * pow(Baw(Tk),2) -
-    ( p*p - (1.0+3.0*xas)*pow(1.0-xas,3)*P*P) / (2*RT*RT) * pow(Bww(Tk),2);
-  
+double Ashrae::lnf(double Tk, double P, double xas) const{
+  return lnf(saturation(Tk), P, xas);
+}
 
-  return t1+t2+t3+t4+t5+t6+t7+t8;
+/*! Funo auxiliar para clculo do enhancement factor a partir das grandezas de saturao.
+\param sp Grandezas de saturao
+\param P Presso Pa
+\param xas Estimativa da frao molar de saturao do ar
+\result Uma estimativa melhor de ln(f)
+*/
+double Ashrae::lnf(const SaturationPoint &sp, double P, double xas) const{
+  return AshraeCorrelations::lnf(sp, P, xas);
 }
 
 
@@ -628,25 +1070,8 @@ double Ashrae::lnf(double Tk, double P, double xas){
 \param Tk Temp. K
 \return k (1/Pa)
 */
-double Ashrae::henryk_O2(double Tk){
-
-  double tau = 1000/Tk;
-  double alfa = -0.0005943;
-  double beta = -0.1470;
-  double gama = -0.05120;
-  double delta = -0.1076;
-  double eps = 0.8447;
-    
-  double a2 = alfa;
-  double a1 = gama*tau + delta;
-  double a0 = beta*tau*tau + eps*tau - 1.0;
-    
-
-  // Resolver o sistema ax^2+bx+c=0 onde x=log10(k)
-
-  double raizes = (-a1 - sqrt(a1*a1 - 4.0*a2*a0)) / (2.0*a2);
-  return pow(10,raizes);
-  
+double Ashrae::henryk_O2(double Tk) const{
+  return AshraeCorrelations::henryk_O2(Tk);
 }
 
 
@@ -654,25 +1079,8 @@ double Ashrae::henryk_O2(double Tk){
 \param Tk Temp. K
 \return k (1/Pa)
 */
-double Ashrae::henryk_N2(double Tk){
-
-  double  tau = 1000/Tk;
-  double  alfa = -0.1021;
-  double  beta = -0.1482;
-  double  gama = -0.019;
-  double  delta = -0.03741;
-  double eps = 0.851;
-
-  double a2 = alfa;
-  double a1 = gama*tau + delta;
-  double a0 = beta*tau*tau + eps*tau - 1.0;
-    
-
-  // Resolver o sistema ax^2+bx+c=0 onde x=log10(k)
-
-  double raizes = (-a1 - sqrt(a1*a1 - 4.0*a2*a0)) / (2.0*a2);
-  return pow(10,raizes);
-
+double Ashrae::henryk_N2(double Tk) const{
+  return AshraeCorrelations::henryk_N2(Tk);
 }
 
 /*! Calcula o coeficiente de Henry do ar [5]:
@@ -681,17 +1089,38 @@ double Ashrae::henryk_N2(double Tk){
 \param Tk Temp. K
 \return k (1/Pa)
 */
-double Ashrae::henryk(double Tk){
-  double kO2 = henryk_O2(Tk);
-  double kN2 = henryk_N2(Tk);
-  double xO2 = 0.22;
-  double xN2 = 0.78;
-  
-  double k = 1.0 / (xO2/kO2 + xN2/kN2);
-  k = 1e-4/k * 1.0/101325.0;
-  
-  return k;
+double Ashrae::henryk(double Tk) const{
+  return Kernel<Ashrae>::henryk(*this, Tk);
+}
+
+
+/*! Constante de Henry do ar de n temperaturas (ver henryk), vrias de cada vez. Se a verso vetorial no corresponder ao tipo dinmico (ver GasPerfeito::nativeBatch), cada temperatura  calculada por henryk.
+\param n Nmero de temperaturas
+\param T Temperaturas em K
+\param k Recebe as constantes de Henry 1/Pa
+*/
+PSYCHRO_NOINLINE void Ashrae::henrykBatch(size_t n, const double *T, double *k) const{
+  if (!nativeBatch()){
+    for (size_t i = 0; i < n; ++i) k[i] = henryk(T[i]);
+    return;
+  }
+
+  PSYCHRO_SIMD_DISPATCH(henrykLanes, n, T, k);
+}
 
+/// henrykBatch com o vetor V (ver PSYCHRO_SIMD_DISPATCH)
+template<class V>
+void Ashrae::henrykLanes(size_t n, const double *T, double *k) const{
+  const size_t L = vtraits<V>::L;
+  for (size_t i = 0; i < n; i += L){
+    size_t m = (n - i < L) ? n - i : L;
+    V tau = 1000/((m == L) ? vload<V>(T+i) : vload_tail<V>(T+i, m));
+    V kO2 = AshraeCorrelations::henrykGas(tau, -0.0005943, -0.1470, -0.05120, -0.1076, 0.8447);
+    V kN2 = AshraeCorrelations::henrykGas(tau, -0.1021, -0.1482, -0.019, -0.03741, 0.851);
+    V ka = AshraeCorrelations::henryk(kO2, kN2);
+    if (m == L) vstore(k+i, ka);
+    else vstore_tail(k+i, ka, m);
+  }
 }
 
 
@@ -700,107 +1129,126 @@ double Ashrae::henryk(double Tk){
 \param Tk Temp. K
 \return \f$\kappa\f$ (1/Pa)
 */
-double Ashrae::kappa_l(double Tk){
-  
-  double Tc = Tk - 273.15;
-  
-  double k;
-
-  if (Tc < 100.0)
-    k = (50.88496 + 0.6163813*Tc + 1.459187e-3*Tc*Tc + 20.08438e-6*Tc*Tc*Tc -
-	 58.47727e-9*pow(Tc,4) + 410.4110e-12 * pow(Tc,5)) / (1.0 + 19.67348e-3*Tc);
-  else 
-    k =  (50.884917 + 0.62590623*Tc + 1.3848668e-3*Tc*Tc + 21.603427e-6*Tc*Tc*Tc -
-	  72.087667e-9*pow(Tc,4) + 465.45054e-12 * pow(Tc,5)) / (1 + 19.859983e-3*Tc);
-
-  return(k * 1e-11);  // 1/Pa
-
+double Ashrae::kappa_l(double Tk) const{
+  return AshraeCorrelations::kappa_l(Tk);
 }
 
 /*! Compressibilidade isotrmica do gelo na presso atmosfrica, retirado de [2]. Vlido para 173.15 < T < 273.15.
 \param Tk Temp. K
 \return \f$\kappa\f$ (1/Pa)
 */
-double Ashrae::kappa_s(double Tk){
-  return (8.875 + 0.0165 * Tk) * 1e-11;
-
+double Ashrae::kappa_s(double Tk) const{
+  return AshraeCorrelations::kappa_s(Tk);
 }
 
 /*! Compressibilidade isotrmica da fase no gasosa: T<273.15 - kappa_s, T>273.15 kappa_l
 \param Tk Temp. K
 \return \f$\kappa\f$
 */
-double Ashrae::kappa_f(double Tk){
-  if (Tk < 273.15)
-    return kappa_s(Tk);
-  else
-    return kappa_l(Tk);
+double Ashrae::kappa_f(double Tk) const{
+  return Kernel<Ashrae>::kappa_f(*this, Tk);
 }
 
 
+/*! Compressibilidade isotrmica da fase condensada de n temperaturas (ver kappa_f), vrias de cada vez. Se a verso vetorial no corresponder ao tipo dinmico (ver GasPerfeito::nativeBatch), cada temperatura  calculada por kappa_f.
+\param n Nmero de temperaturas
+\param T Temperaturas em K
+\param k Recebe as compressibilidades 1/Pa
+*/
+PSYCHRO_NOINLINE void Ashrae::kappafBatch(size_t n, const double *T, double *k) const{
+  if (!nativeBatch()){
+    for (size_t i = 0; i < n; ++i) k[i] = kappa_f(T[i]);
+    return;
+  }
 
+  PSYCHRO_SIMD_DISPATCH(kappafLanes, n, T, k);
+}
 
-
-void Ashrae::set(double T, char ch, double umidade, double P){
-  double B, Rel, D, XSV;
-  // Verificar faixa de temperatura, caso d pau, usar 25oC
-  if (!FaixaT(T)){
-    errorcode = 10;
+/// kappafBatch com o vetor V (ver PSYCHRO_SIMD_DISPATCH)
+template<class V>
+void Ashrae::kappafLanes(size_t n, const double *T, double *k) const{
+  const size_t L = vtraits<V>::L;
+  for (size_t i = 0; i < n; i += L){
+    size_t m = (n - i < L) ? n - i : L;
+    V Tk = (m == L) ? vload<V>(T+i) : vload_tail<V>(T+i, m);
+    V kf = AshraeCorrelations::kappa_f(Tk);
+    if (m == L) vstore(k+i, kf);
+    else vstore_tail(k+i, kf, m);
   }
-  if (!FaixaP(P)){
-    errorcode = 11;
+}
+
+
+
+
+
+/*! Especifica a mistura ar-vapor sem modificar o objeto. Ver GasPerfeito::state.
+\param T Temperatura do ar em K
+\param ch 'R', 'W', 'D', 'B' ou 'X'
+\param umidade A umidade do ar mido. Vai depender do que foi especificado em ch.
+\param P Presso do ar mido em Pa
+\return Estado do ar mido
+*/
+MoistAirState Ashrae::state(double T, char ch, double umidade, double P) const{
+  if (nativeBatch()) return AshraeStatic(*this).state(T, ch, umidade, P);
+  return Kernel<Ashrae>::state(*this, T, ch, umidade, P);
+}
+
+/*! Especifica a mistura ar-vapor partindo dos valores da amostra anterior de uma srie (ver SolverContext). O contexto c passa a ter o estado calculado como amostra anterior.
+ */
+MoistAirState Ashrae::state(double T, char ch, double umidade, double P, SolverContext &c) const{
+  if (nativeBatch()) return AshraeStatic(*this).state(T, ch, umidade, P, c);
+  return Kernel<Ashrae>::state(*this, T, ch, umidade, P, &c);
+}
+
+
+/*! Estados de n amostras (ver state). Com a temperatura de bulbo mido ('B') o teor de umidade  calculado em lote por CalcWfromBBatch; com os demais tipos de umidade cada estado  calculado por state.
+\param n Nmero de amostras
+\param ch 'R', 'W', 'D', 'B' ou 'X'
+\param T Temperaturas em K
+\param umidade Umidades
+\param P Presses em Pa
+\param s Recebe os estados
+*/
+void Ashrae::stateBatch(size_t n, char ch, const double *T, const double *umidade,
+			const double *P, MoistAirState *s) const{
+  if (ch != 'B' || !nativeBatch()){
+    for (size_t i = 0; i < n; ++i) s[i] = state(T[i], ch, umidade[i], P[i]);
+    return;
   }
 
-  switch(ch){
-  case 'X':			// Frao molar de vapor
-    XV = umidade;
-    XSV = eFactor(T, P) * Pws(T) / P;
-    if (XV < 0.0 || XV > XSV) {
-      errorcode = 16;
-    }
-    W = Mv/Ma * XV/(1.0 - XV);
-    break;
-  case 'W':			// Teor de umidade
-    W = umidade;
-    XV = W / (Mv/Ma + W);
-    XSV = eFactor(T, P) * Pws(T) / P;
-    if (XV < 0.0 || XV > XSV) {
-      errorcode = 15;
+  const size_t NB = 256;
+  double B[NB], W[NB];
+  int st[NB];
+  for (size_t i0 = 0; i0 < n; i0 += NB){
+    size_t len = (n - i0 < NB) ? n - i0 : NB;
+    for (size_t j = 0; j < len; ++j){
+      size_t i = i0 + j;
+      st[j] = FaixaT(T[i]);
+      if (!st[j]) st[j] = FaixaP(P[i]);
+      B[j] = umidade[i];
+      if (B[j] > T[i]){
+	st[j] = 14; B[j] = T[i];
+      }
     }
-    break;
-  case 'R':			// UMidade relativa
-    Rel = umidade;
-    if (Rel < 0.0){
-      errorcode = 12; Rel = 0.0;
+    CalcWfromBBatch(len, T+i0, B, P+i0, W, st);
+    for (size_t j = 0; j < len; ++j){
+      MoistAirState &sj = s[i0+j];
+      sj.T = T[i0+j];
+      sj.P = P[i0+j];
+      sj.W = W[j];
+      sj.xv = W[j] / (Mv/Ma + W[j]);
+      sj.status = st[j];
     }
-    XV = Rel * eFactor(T, P) * Pws(T) / P;
-    W = Mv/Ma * XV/(1.0 - XV);
-    break;
-    
-  case 'B':			// Temp. de bulbo mido
-    // A aproximao linear facilita mesmo estes clculos...
-    
-    B = umidade;
-    if (B > T){
-      errorcode = 14; B = T;
-    }
-    W = CalcWfromB(T,B,P);	
-    XV = W / (Mv/Ma + W);
-    break;
-  case 'D':			// Ponto de orvalho
-    D = umidade;
-    if (D > T){
-      errorcode = 13; D = T;
-    }
-    XV = eFactor(D,P) * Pws(D)/P;
-    W = Mv/Ma * XV/(1.0 - XV);
-    break;
+  }
+}
 
-  };
 
+void Ashrae::set(double T, char ch, double umidade, double P){
+  MoistAirState s = state(T, ch, umidade, P);
+  if (s.status) errorcode = s.status;
+  XV = s.xv;
+  W = s.W;
   M = XV * Mv + (1.0 - XV) * Ma;
-
-
 }
 
 /*! Volume molar do ar seco. Utilizando os coeficientes viriais implementados neste trabalho.
@@ -808,27 +1256,8 @@ void Ashrae::set(double T, char ch, double umidade, double P){
 \param P Presso Pa
 \return Volume molar \f$m^3/kmol\f$
 */
-double Ashrae::vM_a_(double Tk, double P){
-  double xa = 1.0;
-
-  double vmi =  R*Tk/P;
-  double vm  = vmi;
-  double vmn;
-  double b = Baa(Tk);
-  double c = Caaa(Tk);
-  const double NMAX = 100;
-  const double EPS=1e-8;
-  double erro;
-  for (int iter = 0; iter < NMAX; ++iter){
-    vmn = R*Tk/P * (1 + b/vm + c/(vm*vm));
-    erro = fabs(vmn - vm);
-    vm = vmn;
-
-    if (erro < EPS) return vm;
-  }
-  errorcode = 102;
-  return(vm);
-  
+double Ashrae::vM_a_(double Tk, double P, int *err) const{
+  return Kernel<Ashrae>::vM_a_(*this, Tk, P, err);
 }
 
 
@@ -838,12 +1267,12 @@ double Ashrae::vM_a_(double Tk, double P){
 \param P Presso Pa
 \return Volume molar \f$m^3/kg\f$
 */
-double Ashrae::v_a_(double T, double P){
-  return vM_a_(T, P) / Ma;
+double Ashrae::v_a_(double T, double P, int *err) const{
+  return vM_a_(T, P, err) / Ma;
 }
 
-double Ashrae::r_a_(double T, double P){
-  return 1/v_a_(T,P);
+double Ashrae::r_a_(double T, double P, int *err) const{
+  return 1/v_a_(T,P, err);
 }
 
 
@@ -854,28 +1283,9 @@ double Ashrae::r_a_(double T, double P){
 \param P Presso Pa
 \return Entalpia, J/kg
 */
-double Ashrae::h_a_(double Tk, double P){
-  double b[] = {-0.79078691e4,
-         0.28709015e2,
-         0.26431805e-2,
-         -0.10405863e-4,
-         0.18660410e-7,
-		-0.97843331e-11};
-
-  double B = Baa(Tk);
-  double C = Caaa(Tk);
-  double dB = dBaa(Tk);
-  double dC = dCaaa(Tk);
-  
-  double Vm = vM_a_(Tk, P);
-
-  double ha = 1000*(b[0] + b[1]*Tk + b[2]*Tk*Tk + b[3]*Tk*Tk*Tk +
-		    b[4]*pow(Tk,4) + b[5]*pow(Tk,5));
-  
-  ha = ha + R*Tk * ( (B - Tk*dB)/Vm + (C - 0.5*Tk*dC)/(Vm*Vm)  );
-  return ha/Ma;
-
-}  
+double Ashrae::h_a_(double Tk, double P, int *err) const{
+  return Kernel<Ashrae>::h_a_(*this, Tk, P, err);
+}
 
 
 
@@ -883,38 +1293,20 @@ double Ashrae::h_a_(double Tk, double P){
 \param Tk Temp. K
 \return Volume molar \f$m^3/kmol\f$
 */
-double Ashrae::vM_v_(double Tk){
-  double P = Pws(Tk);
-  double vmi =  R*Tk/P;
-  double vm  = vmi;
-  double vmn;
-  double b = Bww(Tk);
-  double c = Cwww(Tk);
-  const double NMAX = 200;
-  const double EPS=1e-9;
-  double erro;
-  for (int iter = 0; iter < NMAX; ++iter){
-    vmn = R*Tk/P * (1 + b/vm + c/(vm*vm));
-    erro = fabs(vmn - vm);
-    vm = vmn; 
-
-    if (erro < EPS) return vm;
-  }
-  errorcode = 101;
-  return(vm);
-  
+double Ashrae::vM_v_(double Tk, int *err) const{
+  return Kernel<Ashrae>::vM_v_(*this, Tk, err);
 }
 
 
 
 
-double Ashrae::v_(double T, double P, double xv){
-  return vM_(T, P, xv) / ((1.0-xv)*Ma + xv * Mv);
+double Ashrae::v_(double T, double P, double xv, int *err) const{
+  return Kernel<Ashrae>::v_(*this, T, P, xv, err);
 }
 
 
-double Ashrae::r_(double T, double P, double xv){
-  return 1.0/v_(T, P, xv);
+double Ashrae::r_(double T, double P, double xv, int *err) const{
+  return Kernel<Ashrae>::r_(*this, T, P, xv, err);
 }
 
 
@@ -926,16 +1318,8 @@ double Ashrae::r_(double T, double P, double xv){
 \param Tk Temp. K
 \return Entalpia J/kg
 */
-double Ashrae::h_s_(double Tk){
-  double D[] = {-0.647595E3,
-         0.274292e0,
-         0.2910583e-2,
-         0.1083437e-5,
-		0.107e-5};
-
-  return 1000.0 * (D[0] + D[1]*Tk + D[2]*Tk*Tk + D[3]*Tk*Tk*Tk + D[4]*Pws(Tk));
-  
-
+double Ashrae::h_s_(double Tk) const{
+  return Kernel<Ashrae>::h_s_(*this, Tk);
 }
 
 
@@ -943,51 +1327,89 @@ double Ashrae::h_s_(double Tk){
 \param Tk Temp. K
 \return Entalpia J/kg
 */
-double Ashrae::h_l_(double Tk){
-  double beta0 = Tk * v_l_(273.15) * dPws(273.15);
-  double beta = Tk * v_l_(Tk) * dPws(Tk) - beta0;
-  double L[] = {-0.11411380e4,
-         0.41930463e1,
-         -0.8134865e-4,
-         0.1451133e-6,
-         -0.1005230e-9,
-         -0.563473,
-		-0.036};
-
-  double M[] = {-0.1141837121e4,
-		0.4194325677e1,
-		-0.6908894163e-4,
-		0.105555302e-6,
-		-0.7111382234e-10,
-		0.6059e-6};
-  
-  double alfa;
-  if (Tk < 373.125){
-    
-    alfa = L[0] + L[1]*Tk + L[2]*Tk*Tk + L[3]*Tk*Tk*Tk + L[4]*Tk*Tk*Tk*Tk +
-      L[5] * pow(10,L[6] * (Tk- 273.15));
-  }else if (373.125 < Tk && Tk <= 403.128){
-    alfa = M[0] + M[1]*Tk + M[2]*Tk*Tk + M[3]*Tk*Tk*Tk + M[4]*Tk*Tk*Tk*Tk;
-    
-  }else{
-    alfa = M[0] + M[1]*Tk + M[2]*Tk*Tk + M[3]*Tk*Tk*Tk +
-      M[4]*Tk*Tk*Tk*Tk - M[5]*pow(Tk - 403.128, 3.1);
-  }
+double Ashrae::h_l_(double Tk) const{
+  return Kernel<Ashrae>::h_l_(*this, Tk);
+}
 
-  return 1000.0 * alfa + beta;
+/*! Termo de referncia de h_l_: a parcela \f$\beta\f$ da entalpia da gua  \f$T (v_l(T) P_{ws}'(T) - v_l(273.15) P_{ws}'(273.15))\f$. S depende do modelo; os mtodos iterativos o calculam uma vez por chamada (ver hfSat).
+\return \f$v_l(273.15) P_{ws}'(273.15)\f$ em J/(kg.K)
+*/
+double Ashrae::hlRef() const{
+  return Kernel<Ashrae>::hlRef(*this);
 }
 
 
 
+/*! Derivada da entalpia da fase condensada em relao  temperatura. Para a gua lquida, a derivada do termo beta de h_l_ (da ordem de 1 J/(kg.K))  desprezada.
+\param Tk Temp. K
+\return \f$dh_f/dT\f$ J/(kg.K)
+*/
+double Ashrae::dh_f_(double Tk) const{
+  return Kernel<Ashrae>::dh_f_(*this, Tk);
+}
+
+
 /*! Entalpia da fase no gasosa (T < 273.15 - h_s_, T > 273.15 - h_l_)
 \param Tk Temp. K
 \return Entalpia em J/kg
 */
-double Ashrae::h_f_(double Tk){
-  if (Tk < 273.15)
-    return h_s_(Tk);
-  else
-    return h_l_(Tk);
+double Ashrae::h_f_(double Tk) const{
+  return Kernel<Ashrae>::h_f_(*this, Tk);
+}
+
+/*! Entalpia da fase condensada e sua derivada (ver h_f_ e dh_f_) a partir das grandezas de saturao: a presso de vapor e sua derivada e o volume da fase condensada so os de sp, e o termo de referncia da gua  ref, de modo que nenhuma delas  recalculada. Uma classe derivada que redefine h_f_ ou dh_f_ deve redefinir tambm esta funo.
+\param sp Grandezas de saturao (ver saturation)
+\param ref Termo de referncia da gua (ver hlRef)
+\param dh Se no for nulo, recebe \f$dh_f/dT\f$ J/(kg.K)
+\return Entalpia em J/kg
+*/
+double Ashrae::hfSat(const SaturationPoint &sp, double ref, double *dh) const{
+  return AshraeCorrelations::hfSat(sp, ref, dh);
+}
+
+
+/*! Entalpia da fase condensada e sua derivada (ver h_f_ e dh_f_) de n temperaturas, vrias de cada vez. As expresses do gelo e dos trs trechos da gua lquida so avaliadas para todos os elementos e selecionadas por mscara. A presso de vapor e sua derivada vm de PwsdPwsBatch. Se a verso vetorial no corresponder ao tipo dinmico (ver GasPerfeito::nativeBatch), cada temperatura  calculada por h_f_ e dh_f_.
+\param n Nmero de temperaturas
+\param T Temperaturas em K
+\param h Recebe as entalpias J/kg
+\param dh Se no for nulo, recebe \f$dh_f/dT\f$ J/(kg.K)
+*/
+PSYCHRO_NOINLINE void Ashrae::hfBatch(size_t n, const double *T, double *h, double *dh) const{
+  if (!nativeBatch()){
+    for (size_t i = 0; i < n; ++i){
+      h[i] = h_f_(T[i]);
+      if (dh) dh[i] = dh_f_(T[i]);
+    }
+    return;
+  }
+
+  PSYCHRO_SIMD_DISPATCH(hfLanes, n, T, h, dh);
+}
+
+/// hfBatch com o vetor V (ver PSYCHRO_SIMD_DISPATCH)
+template<class V>
+void Ashrae::hfLanes(size_t n, const double *T, double *h, double *dh) const{
+  const size_t L = vtraits<V>::L;
+  double t[L], p[L], dp[L], vl[L];
+  // Em h_l_, beta0  proporcional a T
+  const double beta0 = hlRef();
+
+  for (size_t i = 0; i < n; i += L){
+    size_t m = (n - i < L) ? n - i : L;
+    V Tk = (m == L) ? vload<V>(T+i) : vload_tail<V>(T+i, m);
+    vstore(t, Tk);
+    PwsdPwsBatch(L, t, p, dp);
+    vfBatch(L, t, vl);
+    V d;
+    V hf = AshraeCorrelations::hf(Tk, vload<V>(p), vload<V>(dp), vload<V>(vl), beta0,
+				  dh ? &d : 0);
+    if (m == L) vstore(h+i, hf);
+    else vstore_tail(h+i, hf, m);
+    if (dh){
+      if (m == L) vstore(dh+i, d);
+      else vstore_tail(dh+i, d, m);
+    }
+  }
 }
 
 
@@ -995,198 +1417,644 @@ double Ashrae::h_f_(double Tk){
 \param Tk Temp. K
 \return Entalpia J/kg
 */
-double Ashrae::h_v_(double Tk){
-  double xv = 1.0;
-  double  xa = 0.0;
+double Ashrae::h_v_(double Tk, int *err) const{
+  return Kernel<Ashrae>::h_v_(*this, Tk, err);
+}
 
-  double P = Pws(Tk);
-  double a[] = {0.63290874e1,
-         0.28709015e2,
-         0.26431805e-2,
-         -0.10405863e-4,
-         0.18660410e-7,
-		-0.9784331e-11};
-  double d[] = {-0.5008e-2,
-         0.32491829e2,
-         0.65576345e-2,
-         -0.26442147e-4,
-         0.51751789e-7,
-		-0.31541624e-10};
 
-  // Clculo dos coeficientes
-  double B = Bww(Tk); 
-  double C = Cwww(Tk); 
 
-  double dB = dBww(Tk); 
-  double dC = dCwww(Tk); 
+/*! Funo auxiliar para clculos que envolvem a temperatura de bulbo mido. Esta funo simplesmente faz o balano de energia. Se o balano  satisfeito, a funo retorna 0:
 
+\f[ (1 + \omega) \cdot h(T, P, \omega) + (\omega' - \omega)\cdot h_f(B) - (1 + \omega')\cdot h(B,P,\omega') = 0\f]
 
-  double hv = 35994.17;
+\param w Teor de umidade na entrada do saturador adiabtico kg de vapor/kg de ar seco
+\param T Temperatura do ar mido K
+\param B Temperatura de bulbo mido do ar K
+\param P Presso Pa
+\return Erro no balano de energia
+*/
+double Ashrae::AuxWB(double w, double T, double B, double P, int *err) const{
+  return Kernel<Ashrae>::AuxWB(*this, w, T, B, P, err);
+}
+
+/*! Balano de energia do saturador adiabtico (ver AuxWB) com as grandezas de saturao na temperatura de bulbo mido j calculadas.
+\param w Teor de umidade na entrada do saturador adiabtico kg de vapor/kg de ar seco
+\param T Temperatura do ar mido K
+\param sb Grandezas de saturao na temperatura de bulbo mido
+\param P Presso Pa
+\return Erro no balano de energia
+*/
+double Ashrae::AuxWB(double w, double T, const SaturationPoint &sb, double P, int *err) const{
+  return Kernel<Ashrae>::AuxWB(*this, w, T, sb, P, err);
+}
+
+/*! Dada a temperatura de bulbo mido, esta funo calcula o teor de umidade resolvendo o balano de energia do saturador adiabtico (ver AuxWB) com o mtodo de Newton-Raphson. Como a temperatura de bulbo mido  conhecida, o estado na sada do saturador (w2, h_f_(B) e a entalpia do ar saturado)  calculado uma nica vez. A derivada do resduo em relao a w  analtica (hw_):
+\f[ \frac{\partial F}{\partial \omega} = \frac{\partial H(T,P,\omega)}{\partial \omega} - h_f(B) \f]
+\param T Temp. K
+\param B Temperatura de bulbo mido K
+\param P Presso Pa
+\return Teor de umidade \f$\omega\f$ em kg de vapor / kg de ar seco
+*/
+double Ashrae::CalcWfromB(double T, double B, double P, int *err) const{
+  return Kernel<Ashrae>::CalcWfromB(*this, T, B, P, err);
+}
 
-  
 
   
+double Ashrae::ENTHALPY(const MoistAirState &s, int *err) const{
+  if (nativeBatch()) return AshraeStatic(*this).ENTHALPY(s, err);
+  return Kernel<Ashrae>::ENTHALPY(*this, s, err);
+}
 
-  double termo2 = d[0] + d[1]*Tk + d[2]*Tk*Tk + d[3]*Tk*Tk*Tk +
-    d[4]*pow(Tk,4) + d[5]*pow(Tk,5) + hv;
+double Ashrae::VOLUME(const MoistAirState &s, int *err) const{
+  if (nativeBatch()) return AshraeStatic(*this).VOLUME(s, err);
+  return Kernel<Ashrae>::VOLUME(*this, s, err);
+}
 
-  //# Clculo do volume molar
-  double Vm = vM_v_(Tk);
+double Ashrae::DENSITY(const MoistAirState &s, int *err) const{
+  if (nativeBatch()) return AshraeStatic(*this).DENSITY(s, err);
+  return Kernel<Ashrae>::DENSITY(*this, s, err);
+}
 
-  
-  double termo3 = (B - Tk*dB)/Vm + (C - 0.5*Tk*dC)/(Vm*Vm);
 
-  double hm =  termo2 * 1000.0 + R*Tk*termo3;
-  
-  return hm/Mv;
+/*! Temperatura de ponto de orvalho. Resolve diretamente
+\f[ f(D,P)\cdot P_{ws}(D) = x_v P \f]
+pelo mtodo de Newton-Raphson na forma logartmica, \f$\ln f + \ln P_{ws}(D) - \ln(x_v P) = 0\f$, que  quase linear em 1/D. As grandezas de saturao (saturation, com a presso de vapor e sua derivada calculadas juntas) so calculadas uma vez por passo; o enhancement factor  calculado a partir delas a cada passo mas mantido constante na derivada. O valor inicial  a estimativa explcita Tws0. No h iterao interna em Tws.
+\param s Estado do ar mido
+\param err Se no for nulo, recebe 109 se a iterao do enhancement factor no convergir em algum passo e 105 se a iterao no convergir; se a iterao divergir para temperaturas negativas (valor inicial ruim, muito fora das faixas) o resultado  NaN
+\return Temperatura de ponto de orvalho em K
+*/
+double Ashrae::DEWPOINT(const MoistAirState &s, int *err) const{
+  if (nativeBatch()) return AshraeStatic(*this).DEWPOINT(s, err);
+  return Kernel<Ashrae>::DEWPOINT(*this, s, err);
+}
 
+/// Temperatura de ponto de orvalho do estado s partindo do valor da amostra anterior armazenado em c (ver SolverContext)
+double Ashrae::DEWPOINT(const MoistAirState &s, SolverContext &c, int *err) const{
+  if (nativeBatch()) return AshraeStatic(*this).DEWPOINT(s, c, err);
+  return Kernel<Ashrae>::DEWPOINT(*this, s, err, &c);
 }
 
 
+double Ashrae::RELHUM(const MoistAirState &s, int *err) const{
+  if (nativeBatch()) return AshraeStatic(*this).RELHUM(s, err);
+  return Kernel<Ashrae>::RELHUM(*this, s, err);
+}
 
-/*! Funo auxiliar para clculos que envolvem a temperatura de bulbo mido. Esta funo simplesmente faz o balano de energia. Se o balano  satisfeito, a funo retorna 0:
 
-\f[ (1 + \omega) \cdot h(T, P, \omega) + (\omega' - \omega)\cdot h_f(B) - (1 + \omega')\cdot h(B,P,\omega') = 0\f]
+/*! Propriedades selecionadas do estado s numa s passagem. A massa especfica, o volume, a entalpia e o bulbo mido utilizam o volume molar da mistura (uma soluo da equao virial, ver Z) e a entalpia utiliza os coeficientes viriais: separadamente, cada funo os recalcula. Aqui eles so calculados uma nica vez, e a entalpia da entrada do saturador no bulbo mido  a prpria entalpia do estado. A umidade relativa e o ponto de orvalho no tm clculos em comum com as demais propriedades (as temperaturas de saturao so outras).
 
-\param w Teor de umidade na entrada do saturador adiabtico kg de vapor/kg de ar seco
-\param T Temperatura do ar mido K
-\param B Temperatura de bulbo mido do ar K
-\param P Presso Pa
-\return Erro no balano de energia
+A massa especfica, o volume, a entalpia, a umidade relativa e o ponto de orvalho so idnticos aos das funes de sada; o bulbo mido difere apenas pelo arredondamento.
+\param s Estado do ar mido
+\param mask Propriedades calculadas (ver MoistAirProperty)
+\return Propriedades; as que no foram pedidas valem NaN. O cdigo de erro parte de s.status
 */
-double Ashrae::AuxWB(double w, double T, double B, double P){
-  // Funo auxiliar para calcular W de B
-  double f1, f2;
-  double xv1, xv2, w2;
+MoistAirProperties Ashrae::evaluate_all(const MoistAirState &s, unsigned mask) const{
+  if (nativeBatch()) return AshraeStatic(*this).evaluate_all(s, mask);
+  return Kernel<Ashrae>::evaluate_all(*this, s, mask);
+}
 
-  xv1 = w / (Mv/Ma + w);
-  xv2 = eFactor(B, P) * Pws(B) / P;
+/*! Como evaluate_all, mas as propriedades e os intermedirios (volume molar, entalpia molar, presso de saturao e enhancement factor) j armazenados em c para o estado s no so recalculados. Se s no for o estado de c, c  esvaziada antes.
+\param c Memria das propriedades (ver MoistAirCache)
+\param s Estado do ar mido
+\param mask Propriedades pedidas (ver MoistAirProperty)
+\return Propriedades armazenadas em c
+*/
+const MoistAirProperties &Ashrae::evaluate(MoistAirCache &c, const MoistAirState &s, unsigned mask) const{
+  if (nativeBatch()) return AshraeStatic(*this).evaluate(c, s, mask);
+  return Kernel<Ashrae>::evaluate(*this, c, s, mask);
+}
 
-  w2 = Mv / Ma * xv2 / (1 - xv2);
+/*! Temperatura de bulbo mido. O balano de energia do saturador adiabtico
+\f[ F(B) = H(T,P,\omega) + (\omega'(B) - \omega)\cdot h_f(B) - H(B,P,\omega'(B)) = 0\f]
+ resolvido pelo mtodo de Newton-Raphson. O resduo e a sua derivada so calculados juntos:
+\f[ \frac{dF}{dB} = \omega' \frac{dh_f}{dB} + (\omega' - \omega) \frac{dh_f}{dB} - \frac{\partial H}{\partial T} - \frac{\partial H}{\partial \omega'}\frac{d\omega'}{dB} \f]
+com \f$d\omega'/dB\f$ obtido de dPws (o enhancement factor  mantido constante na derivada, sua variao com a temperatura  inferior a 0,01%/K). A entrada do saturador no depende de B e  calculada uma nica vez.
+\param s Estado do ar mido
+\param err Se no for nulo, recebe o cdigo de erro
+\return Temperatura de bulbo mido em K
+*/
+double Ashrae::WETBULB(const MoistAirState &s, int *err) const{
+  if (nativeBatch()) return AshraeStatic(*this).WETBULB(s, err);
+  return Kernel<Ashrae>::WETBULB(*this, s, err);
+}
 
-  return (1.0 + w)*h_(T, P, xv1) + (w2 - w) * h_f_(B) - (1.0 + w2) * h_(B,P,xv2);
+/// Temperatura de bulbo mido do estado s partindo do valor da amostra anterior armazenado em c (ver SolverContext)
+double Ashrae::WETBULB(const MoistAirState &s, SolverContext &c, int *err) const{
+  if (nativeBatch()) return AshraeStatic(*this).WETBULB(s, c, err);
+  return Kernel<Ashrae>::WETBULB(*this, s, err, &c);
 }
 
-/*! Dada a temperatura de bulbo mido, esta funo calcula o teor de umidade utilizando a funo AuxWB e uma iterao de Newton-Raphson.
-\param T Temp. K
-\param B Temperatura de bulbo mido K
-\param P Presso Pa
-\return Teor de umidade \f$\omega\f$ em kg de vapor / kg de ar seco
+
+/*! Entalpia do ar seco (ver h_a_) de vtraits<V>::L estados com os coeficientes viriais c
+\param eps Tolerncia no volume molar (ver Tolerances::volume)
+\param fail Recebe a mscara dos elementos em que a equao virial no convergiu
+ */
+template<class V>
+static V haLanes(Ashrae::VirialMethod method, double eps, const V &Tk, const V &P, const V c[14],
+		 typename vtraits<V>::mask &fail){
+  const double R = Psychro::R;
+  V Vm = vMvirialLanes(method, Tk, P, c[0], c[3], 100, eps, fail);
+  V ha = 1000*(-0.79078691e4 + Tk*(0.28709015e2 + Tk*(0.26431805e-2 + Tk*(-0.10405863e-4 +
+    Tk*(0.18660410e-7 - 0.97843331e-11*Tk)))));
+  ha = ha + R*Tk * ( (c[0] - Tk*c[7])/Vm + (c[3] - 0.5*Tk*c[10])/(Vm*Vm) );
+  return ha/Psychro::Ma;
+}
+
+/*! Entalpia do vapor saturado (ver h_v_) de vtraits<V>::L estados com os coeficientes viriais c e a presso de vapor pws
+\param eps Tolerncia no volume molar (ver Tolerances::volume)
+\param fail Recebe a mscara dos elementos em que a equao virial no convergiu
+ */
+template<class V>
+static V hvLanes(Ashrae::VirialMethod method, double eps, const V &Tk, const V &pws, const V c[14],
+		 typename vtraits<V>::mask &fail){
+  const double R = Psychro::R;
+  V Vm = vMvirialLanes(method, Tk, pws, c[1], c[4], 200, eps, fail);
+  V termo2 = (-0.5008e-2 + 35994.17) + Tk*(0.32491829e2 + Tk*(0.65576345e-2 +
+    Tk*(-0.26442147e-4 + Tk*(0.51751789e-7 - 0.31541624e-10*Tk))));
+  V termo3 = (c[1] - Tk*c[8])/Vm + (c[4] - 0.5*Tk*c[11])/(Vm*Vm);
+  return (termo2 * 1000.0 + R*Tk*termo3)/Psychro::Mv;
+}
+
+
+/*! Temperatura de ponto de orvalho de n estados (ver DEWPOINT). A iterao de Newton-Raphson  a mesma de DEWPOINT, feita em vtraits<V>::L estados simultaneamente: a cada passo o enhancement factor, a presso de vapor e sua derivada de todos os elementos so calculados pelas verses em lote (eFactorBatch e PwsdPwsBatch, que selecionam gelo ou gua em cada elemento) e os elementos que j convergiram ficam congelados. O resultado difere do de DEWPOINT apenas pelo arredondamento. Se a verso vetorial no corresponder ao tipo dinmico (ver GasPerfeito::nativeBatch), cada estado  calculado por DEWPOINT.
+\param n Nmero de estados
+\param P Presses em Pa
+\param xv Fraes molares de vapor
+\param D Recebe as temperaturas de ponto de orvalho em K
+\param err Se no for nulo, err[i] recebe 109 se o enhancement factor do estado i no convergiu em algum passo (como em DEWPOINT) e 105 se a iterao do estado i no convergiu, ou se \f$x_v P \le 0\f$ (D[i] recebe NaN); os demais elementos no so modificados
 */
-double Ashrae::CalcWfromB(double T, double B, double P){
-  // Esta funo calcula o teor de umidade dado T, B(TBU) e P
+PSYCHRO_NOINLINE void Ashrae::DEWPOINTBatch(size_t n, const double *P, const double *xv, double *D,
+			   int *err) const{
+  if (!nativeBatch()){
+    for (size_t i = 0; i < n; ++i){
+      MoistAirState s = {NAN, P[i], xv[i], NAN, 0};
+      D[i] = DEWPOINT(s, err ? err+i : 0);
+    }
+    return;
+  }
 
-  // Caso fosse mistura de gases ideais, seria muito simples. Mas neste caso temos que
-  // iterar. Mas usaremos o dado de TBU de gs perfeito como dado inicial.
+  PSYCHRO_SIMD_DISPATCH(DEWPOINTLanes, n, P, xv, D, err);
+}
 
-  double w, w2, xsv, wnovo;
-  const double EPS = 1e-8;
+/// DEWPOINTBatch com o vetor V (ver PSYCHRO_SIMD_DISPATCH)
+template<class V>
+void Ashrae::DEWPOINTLanes(size_t n, const double *P, const double *xv, double *D,
+			   int *err) const{
+  typedef typename vtraits<V>::mask M;
+  const size_t L = vtraits<V>::L;
+  const double EPS=tol.dewpoint;
   const int NMAX = 100;
-  double f, df, dw;
+  double d[L], p[L], f[L], pw[L], dp[L];
+  int e[L], ee[L];
+
+  for (size_t i = 0; i < n; i += L){
+    size_t m = (n - i < L) ? n - i : L;
+    V Pk = (m == L) ? vload<V>(P+i) : vload_tail<V>(P+i, m);
+    V x = (m == L) ? vload<V>(xv+i) : vload_tail<V>(xv+i, m);
+    vstore(p, Pk);
+    for (size_t j = 0; j < L; ++j) e[j] = 0;
+
+    // vlog no aceita valores nulos ou negativos: estes elementos no so iterados
+    V Pv = x * Pk;
+    M invalido = vnot((M)(Pv > 0.0));
+    Pv = vselect(invalido, vset<V>(1000.0), Pv);
+    V lnPv = vlog(Pv);
+
+    // Chute inicial: Gas perfeito
+    V Dv = Tws0Lanes(Pv);
+    // Ponto anterior: temperatura, resduo e derivada analtica (correo secante, ver Kernel::DEWPOINT)
+    V Da = Dv, ga = vset<V>(0.0), Ja = ga;
+    M active = vnot(invalido), nan = M(), primeiro = vnot(M());
+    for (int iter = 0; iter < NMAX && vany(active); ++iter){
+      vstore(d, Dv);
+      // Como em DEWPOINT, apenas os erros do enhancement factor dos elementos ainda ativos contam
+      for (size_t j = 0; j < L; ++j) ee[j] = 0;
+      eFactorBatch(L, d, p, f, ee);
+      for (size_t j = 0; j < L; ++j)
+	if (ee[j] && active[j]) e[j] = ee[j];
+      PwsdPwsBatch(L, d, pw, dp);
+      V pv = vload<V>(pw);
+      V g = vlog(vload<V>(f)*pv) - lnPv;
+      V J = vload<V>(dp) / pv;
+      M sec = vnot(primeiro) & vnot((M)(Dv < 273.15) ^ (M)(Da < 273.15));
+      V dD = -g / vselect(sec, (g - ga) / (Dv - Da) + (J - Ja) / 2, J);
+      Da = Dv; ga = g; Ja = J;
+      primeiro = M();
+      Dv = vselect(active, Dv + dD, Dv);
+      active = active & vnot((M)(vfabs(dD) < EPS) | (sec & (M)(dD*dD < EPS)));
+      // NaN ou temperatura negativa: a iterao divergiu (ver DEWPOINT)
+      nan = nan | (active & vnot((M)(Dv > 0.0)));
+      active = active & vnot(nan);
+    }
+    Dv = vselect(invalido | nan, vset<V>(NAN), Dv);
+    active = active | invalido | nan;
+
+    if (m == L) vstore(D+i, Dv);
+    else vstore_tail(D+i, Dv, m);
+    if (err)
+      for (size_t j = 0; j < m; ++j){
+	if (e[j]) err[i+j] = e[j];
+	if (active[j]) err[i+j] = 105;
+      }
+  }
+}
 
-  xsv = eFactor(B, P) * Pws(B) / P;
-  w2 = Mv / Ma * xsv / (1 - xsv);
 
-  w = ( h_a_(B) - h_a_(T) - w2 * h_f_(B) + w2 * h_v_(B) ) / ( h_v_(T) - h_f_(B) );
-  //return w;
-  // Agora com este valor inicial, iterar at conseguir chegar
-  for (int iter = 0; iter < NMAX; ++iter){
-    f = AuxWB(w, T, B, P);
-    df = (AuxWB(w + 1e-4*w2, T, B, P) - f) / (1e-4 * w2);
-    
-    dw = -f / df;
-    w = w + dw;
-    //cout << dw << endl;
-    if (fabs(dw) < EPS*w2) return w;
+/*! Temperatura de bulbo mido de n estados (ver WETBULB). A iterao de Newton-Raphson sobre o balano de energia do saturador adiabtico  a mesma de WETBULB, feita em vtraits<V>::L estados simultaneamente. Todas as grandezas na temperatura de bulbo mido so calculadas pelas verses em lote (eFactorBatch, PwsdPwsBatch, hfBatch e hwBatch); como B de cada elemento pode estar abaixo ou acima de 273.15, o ramo do gelo ou da gua  selecionado elemento a elemento por mscara. O valor inicial (perfectGasSeed) tambm  calculado em lote, por GasPerfeito::WETBULBBatch de seedModel. Os elementos que j convergiram ficam congelados. O resultado difere do de WETBULB apenas pelo arredondamento. Se a verso vetorial no corresponder ao tipo dinmico (ver GasPerfeito::nativeBatch), cada estado  calculado por WETBULB.
+\param n Nmero de estados
+\param T Temperaturas em K
+\param P Presses em Pa
+\param W Teores de umidade kg de vapor / kg de ar seco
+\param B Recebe as temperaturas de bulbo mido em K
+\param err Se no for nulo, err[i] recebe 100 se a iterao do estado i no convergiu ou o cdigo de erro de Z (os demais elementos no so modificados)
+*/
+PSYCHRO_NOINLINE void Ashrae::WETBULBBatch(size_t n, const double *T, const double *P, const double *W,
+			  double *B, int *err) const{
+  if (!nativeBatch()){
+    for (size_t i = 0; i < n; ++i){
+      MoistAirState s = {T[i], P[i], W[i] / (Mv/Ma + W[i]), W[i], 0};
+      B[i] = WETBULB(s, err ? err+i : 0);
+    }
+    return;
   }
 
-  errorcode = 103;
-  return w;
+  PSYCHRO_SIMD_DISPATCH(WETBULBLanes, n, T, P, W, B, err);
 }
 
-
-  
-double Ashrae::ENTHALPY(double T, double P){
-  if (!FaixaT(T)) {errorcode=10;}
-  if (!FaixaT(P)) {errorcode=11;}
-  return h_(T, P, XV) * (1.0 + W);
+/// WETBULBBatch com o vetor V (ver PSYCHRO_SIMD_DISPATCH)
+template<class V>
+void Ashrae::WETBULBLanes(size_t n, const double *T, const double *P, const double *W,
+			  double *B, int *err) const{
+  typedef typename vtraits<V>::mask M;
+  const size_t L = vtraits<V>::L;
+  const double EPS=tol.wetbulb;
+  const int NMAX = 400;
+  double t[L], p[L], w[L], b[L], ef[L], pws[L], dpws[L], hf[L], dhf[L];
+  double w2[L], H[L], dHdw[L], dHdT[L];
+  int e[L], ee[L];
+
+  for (size_t i = 0; i < n; i += L){
+    size_t m = (n - i < L) ? n - i : L;
+    vstore(t, (m == L) ? vload<V>(T+i) : vload_tail<V>(T+i, m));
+    vstore(p, (m == L) ? vload<V>(P+i) : vload_tail<V>(P+i, m));
+    vstore(w, (m == L) ? vload<V>(W+i) : vload_tail<V>(W+i, m));
+    V Tk = vload<V>(t), Pk = vload<V>(p), wk = vload<V>(w);
+    for (size_t j = 0; j < L; ++j) e[j] = 0;
+
+    // Entrada do saturador
+    hwBatch(L, t, p, w, H, 0, 0, e);
+    V H1 = vload<V>(H);
+
+    V Bv = Tk - 1.0;
+    if (perfectGasSeed){
+      // Valor inicial: bulbo mido do gs perfeito, se estiver do mesmo lado de 273.15 que T - 1
+      // (perto de 273.15 a equao tem uma raiz no gelo e outra na gua, ver Kernel::WETBULB)
+      for (size_t j = 0; j < L; ++j) ee[j] = 0;
+      seedModel().WETBULBBatch(L, t, p, w, b, ee);
+      for (size_t j = 0; j < L; ++j)
+	if (ee[j]) b[j] = NAN;
+      V Bg = vload<V>(b);
+      M usa = (M)(Bg <= Tk) & vnot((M)(Bg < 273.15) ^ (M)(Bv < 273.15));
+      Bv = vselect(usa, Bg, Bv);
+    }
+    // Ponto anterior: temperatura, resduo e derivada analtica (correo secante, ver Kernel::WETBULB)
+    V Ba = Bv, Fa = vset<V>(0.0), dFa = Fa;
+    M active = vnot(M()), nan = M(), primeiro = vnot(M());
+    for (int iter = 0; iter < NMAX && vany(active); ++iter){
+      vstore(b, Bv);
+      // Como em WETBULB, apenas os erros do enhancement factor dos elementos ainda ativos contam
+      for (size_t j = 0; j < L; ++j) ee[j] = 0;
+      eFactorBatch(L, b, p, ef, ee);
+      for (size_t j = 0; j < L; ++j)
+	if (ee[j] && active[j]) e[j] = ee[j];
+      PwsdPwsBatch(L, b, pws, dpws);
+      hfBatch(L, b, hf, dhf);
+
+      V f = vload<V>(ef);
+      V xsv = f * vload<V>(pws) / Pk;
+      V w2k = Mv / Ma * xsv / (1 - xsv);
+      V dw2 = Mv / Ma * f * vload<V>(dpws) / Pk / ((1 - xsv)*(1 - xsv));
+      vstore(w2, w2k);
+      hwBatch(L, b, p, w2, H, dHdw, dHdT, e);
+
+      V hfk = vload<V>(hf);
+      V F = H1 + (w2k - wk) * hfk - vload<V>(H);
+      V dF = dw2 * hfk + (w2k - wk) * vload<V>(dhf) - vload<V>(dHdT) - vload<V>(dHdw) * dw2;
+      M sec = vnot(primeiro) & vnot((M)(Bv < 273.15) ^ (M)(Ba < 273.15));
+      V dB = -F / vselect(sec, (F - Fa) / (Bv - Ba) + (dF - dFa) / 2, dF);
+      Ba = Bv; Fa = F; dFa = dF;
+      primeiro = M();
+      V Bn = Bv + dB;
+      // Um passo que atravessa 273.15 no indica convergncia: a entalpia da fase condensada  descontnua
+      M cruza = (M)(Bn < 273.15) ^ (M)(Bv < 273.15);
+      Bv = vselect(active, Bn, Bv);
+      active = active & vnot(((M)(vfabs(dB) < EPS) | (sec & (M)(dB*dB < EPS))) & vnot(cruza));
+      // Um elemento que virou NaN no converge mais: sai da iterao como no convergido
+      nan = nan | (active & vnot((M)(Bv == Bv)));
+      active = active & vnot(nan);
+    }
+    active = active | nan;
+
+    if (m == L) vstore(B+i, Bv);
+    else vstore_tail(B+i, Bv, m);
+    if (err)
+      for (size_t j = 0; j < m; ++j){
+	if (e[j]) err[i+j] = e[j];
+	if (active[j]) err[i+j] = 100;
+      }
+  }
 }
 
-double Ashrae::VOLUME(double T, double P){
-  if (!FaixaT(T)) {errorcode=10;}
-  if (!FaixaT(P)) {errorcode=11;}
-  return v_(T, P, XV) * (1.0 + W);
+
+/*! Teor de umidade de n estados dada a temperatura de bulbo mido (ver CalcWfromB). A iterao de Newton-Raphson em w  a mesma de CalcWfromB, feita em vtraits<V>::L estados simultaneamente. O estado na sada do saturador e o valor inicial (entalpias do ar seco e do vapor em T e B) tambm so calculados em lote; o ramo do gelo ou da gua  selecionado elemento a elemento. Os elementos que j convergiram ficam congelados. Se a verso vetorial no corresponder ao tipo dinmico (ver GasPerfeito::nativeBatch), cada estado  calculado por CalcWfromB.
+\param n Nmero de estados
+\param T Temperaturas em K
+\param B Temperaturas de bulbo mido em K
+\param P Presses em Pa
+\param W Recebe os teores de umidade kg de vapor / kg de ar seco
+\param err Se no for nulo, err[i] recebe 103 se a iterao do estado i no convergiu ou o cdigo de erro das equaes viriais (os demais elementos no so modificados)
+*/
+PSYCHRO_NOINLINE void Ashrae::CalcWfromBBatch(size_t n, const double *T, const double *B, const double *P,
+			     double *W, int *err) const{
+  if (!nativeBatch()){
+    for (size_t i = 0; i < n; ++i) W[i] = CalcWfromB(T[i], B[i], P[i], err ? err+i : 0);
+    return;
+  }
+
+  PSYCHRO_SIMD_DISPATCH(CalcWfromBLanes, n, T, B, P, W, err);
 }
 
-double Ashrae::DENSITY(double T, double P){
-  if (!FaixaT(T)) {errorcode=10;}
-  if (!FaixaT(P)) {errorcode=11;}
-  return r_(T, P, XV);
+/// CalcWfromBBatch com o vetor V (ver PSYCHRO_SIMD_DISPATCH)
+template<class V>
+void Ashrae::CalcWfromBLanes(size_t n, const double *T, const double *B, const double *P,
+			     double *W, int *err) const{
+  typedef typename vtraits<V>::mask M;
+  const size_t L = vtraits<V>::L;
+  const double EPS = tol.W;
+  const int NMAX = 100;
+  double t[L], b[L], p[L], w[L], ef[L], pws[L], pwsT[L], hf[L], H[L], dH[L], patm[L];
+  int e[L];
+  V cT[14], cB[14];
+
+  for (size_t j = 0; j < L; ++j) patm[j] = 101325.0;
+
+  for (size_t i = 0; i < n; i += L){
+    size_t m = (n - i < L) ? n - i : L;
+    vstore(t, (m == L) ? vload<V>(T+i) : vload_tail<V>(T+i, m));
+    vstore(b, (m == L) ? vload<V>(B+i) : vload_tail<V>(B+i, m));
+    vstore(p, (m == L) ? vload<V>(P+i) : vload_tail<V>(P+i, m));
+    V Tk = vload<V>(t), Bk = vload<V>(b), Pk = vload<V>(p);
+    for (size_t j = 0; j < L; ++j) e[j] = 0;
+
+    eFactorBatch(L, b, p, ef, e);
+    PwsBatch(L, b, pws);
+    V xsv = vload<V>(ef) * vload<V>(pws) / Pk;
+    V w2 = Mv / Ma * xsv / (1 - xsv);
+
+    // Sada do saturador: no depende de w
+    hfBatch(L, b, hf, 0);
+    vstore(w, w2);
+    hwBatch(L, b, p, w, H, 0, 0, e);
+    V hfk = vload<V>(hf), H2 = vload<V>(H);
+
+    M f1 = M(), f2 = M(), f3 = M(), f4 = M();
+    V wk;
+    if (perfectGasSeed){
+      // Valor inicial: expresso explcita do gs perfeito com o w2 do modelo (ver GasPerfeito::state)
+      for (size_t j = 0; j < L; ++j) w[j] = Kernel<Ashrae>::seedW(seedModel(), t[j], b[j], w[j]);
+      wk = vload<V>(w);
+    }
+    else{
+      // Valor inicial: entalpias do ar seco e do vapor em T e B
+      AshraeCorrelations::virial(Tk, cT);
+      AshraeCorrelations::virial(Bk, cB);
+      V patmk = vload<V>(patm);
+      V haB = haLanes(virialMethod, tol.volume, Bk, patmk, cB, f1);
+      V haT = haLanes(virialMethod, tol.volume, Tk, patmk, cT, f2);
+      V hvB = hvLanes(virialMethod, tol.volume, Bk, vload<V>(pws), cB, f3);
+      PwsBatch(L, t, pwsT);
+      V hvT = hvLanes(virialMethod, tol.volume, Tk, vload<V>(pwsT), cT, f4);
+      wk = ( haB - haT - w2 * hfk + w2 * hvB ) / ( hvT - hfk );
+    }
+
+    M active = vnot(M()), nan = M();
+    for (int iter = 0; iter < NMAX && vany(active); ++iter){
+      vstore(w, wk);
+      hwBatch(L, t, p, w, H, dH, 0, e);
+      V F = vload<V>(H) + (w2 - wk) * hfk - H2;
+      V dw = -F / (vload<V>(dH) - hfk);
+      wk = vselect(active, wk + dw, wk);
+      active = active & vnot((M)(vfabs(dw) < EPS*w2));
+      nan = nan | (active & vnot((M)(wk == wk)));
+      active = active & vnot(nan);
+    }
+    active = active | nan;
+
+    if (m == L) vstore(W+i, wk);
+    else vstore_tail(W+i, wk, m);
+    if (err)
+      for (size_t j = 0; j < m; ++j){
+	if (f1[j] || f2[j]) err[i+j] = 102;
+	if (f3[j] || f4[j]) err[i+j] = 101;
+	if (e[j]) err[i+j] = e[j];
+	if (active[j]) err[i+j] = 103;
+      }
+  }
 }
 
 
-double Ashrae::DEWPOINT(double T, double P){
-  // Vai ter que iterar... Que merda
-  if (!FaixaT(T)) {errorcode=10;}
-  if (!FaixaT(P)) {errorcode=11;}
-
-  // Chute inicial: Gas perfeito
-  double D = Tws(XV * P);
-  double Dnovo;
-  double f, erro;
-  const double EPS=1e-9;
-  const int NMAX = 100;
+/*! Clculo em lote das propriedades do ar mido. Ver GasPerfeito::batch. As amostras so processadas em blocos: os estados so obtidos por stateBatch e as propriedades explcitas por batch_eval; o ponto de orvalho e a temperatura de bulbo mido, que so iterativos, so calculados em paralelo pelas verses vetoriais (DEWPOINTBatch e WETBULBBatch). O resultado difere do das funes de sada apenas pelo arredondamento. A classe Giacomo herda esta funo: as correlaes redefinidas (Z, Pws, eFactor) continuam sendo utilizadas. Nas classes derivadas cujas correlaes as verses vetoriais no reproduzem (ver GasPerfeito::nativeBatch) cada amostra  calculada com state e evaluate_all (ver batch_eval).
+*/
+void Ashrae::batch(size_t n, char ch, const double *T, const double *umidade,
+		   const double *P, const MoistAirColumns &out) const{
+  if (!nativeBatch()){
+    batch_eval(*this, n, ch, T, umidade, P, out);
+    return;
+  }
 
-  for (int iter = 0; iter < NMAX; ++iter){
-    f = eFactor(D, P);
+  const size_t NB = 256;
+  MoistAirState s[NB];
+  double W[NB], xv[NB];
+  int st[NB];
+
+  for (size_t i0 = 0; i0 < n; i0 += NB){
+    size_t len = (n - i0 < NB) ? n - i0 : NB;
+    stateBatch(len, ch, T+i0, umidade+i0, P+i0, s);
+
+    MoistAirColumns o = out.shift(i0);
+    o.dewpoint = 0;
+    o.wetbulb = 0;
+    o.status = st;
+    batch_eval(*this, len, s, o);
+
+    if (out.dewpoint || out.wetbulb){
+      for (size_t j = 0; j < len; ++j){
+	W[j] = s[j].W;
+	xv[j] = s[j].xv;
+      }
+      if (out.dewpoint) DEWPOINTBatch(len, P+i0, xv, out.dewpoint+i0, st);
+      if (out.wetbulb) WETBULBBatch(len, T+i0, P+i0, W, out.wetbulb+i0, st);
+    }
+    if (out.status)
+      for (size_t j = 0; j < len; ++j) out.status[i0+j] = st[j];
+  }
+}
 
-    // Calcular a nova temperatura de ponto de orvalho
-    Dnovo = Tws(XV*P/f);
-    erro = fabs(Dnovo - D);
-    D = Dnovo;
-    if (erro < EPS) return D;
+/*! Clculo em lote com entradas e sadas em float (ver Psychro::batchFloat). As amostras so processadas em blocos de 256 por LaneKernel::batch (ver ashrae_lanes.h): os estados, as propriedades explcitas, o ponto de orvalho e o bulbo mido so calculados em vetores float, com o dobro de elementos por vetor dos de batch, e as correlaes (presso de vapor, coeficientes viriais, enhancement factor e entalpias) com constantes float. As amostras em que a preciso simples no basta (ver LaneKernel: iteraes que no convergem, estados perto da saturao, da troca de fase em 273.15 K ou com \f$x_v > 0.5\f$, teor de umidade pequeno dado o bulbo mido) so recalculadas em double por batch: de 1.5% a 4% das amostras vlidas em entradas uniformes. O cdigo de erro de cada amostra  o de batch (com tolerncias abaixo da resoluo do float, como tol.eFactor = 0, as iteraes em float convergem onde as de batch no convergem).
+
+O erro dominante  o de \f$\ln P_{ws}\f$, soma de termos at cinco vezes maiores que o resultado: a presso de vapor tem erro relativo de at \f$8\times10^{-6}\f$. Erro mximo em relao a batch com as mesmas entradas (convertidas para double), para Ashrae e Giacomo, em \f$10^7\f$ amostras (todos os tipos de umidade) de 173.15 a 473.15 K e de 20 kPa a 5 MPa, em cada nvel SIMD (entre parnteses, outras \f$10^7\f$ de 253.15 a 323.15 K e de 70 a 110 kPa):
+- W e xv: \f$3\times10^{-7}\f$ relativo dados W ou xv; \f$1.5\times10^{-5}\f$ (\f$10^{-5}\f$) dados a umidade relativa ou o ponto de orvalho; \f$2\times10^{-4}\f$ (\f$10^{-4}\f$) dado o bulbo mido
+- densidade: \f$2\times10^{-6}\f$ (\f$6\times10^{-7}\f$) relativo
+- volume especfico: \f$7\times10^{-6}\f$ (\f$1.5\times10^{-6}\f$) relativo
+- entalpia: 25 J/kg (3 J/kg) de ar seco, dominado pelo erro de W; 0.7 J/kg (0.15 J/kg) dados W ou xv
+- umidade relativa: \f$7\times10^{-5}\f$ (\f$2\times10^{-5}\f$)
+- ponto de orvalho: \f$5\times10^{-4}\f$ K (\f$4\times10^{-4}\f$ K); \f$2.5\times10^{-3}\f$ K (\f$10^{-3}\f$ K) dado o bulbo mido
+- bulbo mido: \f$4\times10^{-4}\f$ K (\f$2\times10^{-4}\f$ K)
+
+Os erros maiores ocorrem nos nveis sem FMA (SIMD_SCALAR e SIMD_SSE42). Nas classes derivadas cujas correlaes as verses vetoriais no reproduzem (ver GasPerfeito::nativeBatch) o clculo  o de GasPerfeito::batchFloat (em double).
+\param n Nmero de amostras
+\param ch Tipo de umidade ('R', 'W', 'D', 'B' ou 'X', ver set)
+\param T Temperaturas em K
+\param umidade Umidades
+\param P Presses em Pa
+\param out Colunas de sada (ponteiros nulos no so calculados)
+*/
+void Ashrae::batchFloat(size_t n, char ch, const float *T, const float *umidade,
+			const float *P, const MoistAirColumnsF &out) const{
+  if (!nativeBatch()){
+    GasPerfeito::batchFloat(n, ch, T, umidade, P, out);
+    return;
   }
+  batchFloatModel(AshraeStatic(*this), n, ch, T, umidade, P, out);
+}
 
-  errorcode = 105;
-  return D;
-  
-      
-  
+/// batchFloat com o modelo esttico m do tipo dinmico (ver models.h)
+template<class Model>
+PSYCHRO_NOINLINE void Ashrae::batchFloatModel(const Model &m, size_t n, char ch, const float *T,
+					      const float *umidade, const float *P,
+					      const MoistAirColumnsF &out) const{
+  const size_t NB = 256;
+  int st[NB];
+  char refine[NB];
+
+  for (size_t i0 = 0; i0 < n; i0 += NB){
+    size_t len = (n - i0 < NB) ? n - i0 : NB;
+    MoistAirColumnsF o = out.shift(i0);
+    o.status = st;
+    PSYCHRO_SIMD_DISPATCH_FLOAT(LaneKernel<Model>::template batch, m, len, ch, T+i0,
+				umidade+i0, P+i0, o, refine);
+
+    bool any = false;
+    for (size_t j = 0; j < len; ++j){
+      int f = FaixaT(T[i0+j]);
+      if (!f) f = FaixaP(P[i0+j]);
+      if (f) st[j] = f;
+      if (refine[j]) any = true;
+    }
+    if (any) batch_float_eval(*this, len, ch, T+i0, umidade+i0, P+i0, o, refine);
+    if (out.status)
+      for (size_t j = 0; j < len; ++j) out.status[i0+j] = st[j];
+  }
 }
 
+template void Ashrae::batchFloatModel(const GiacomoStatic &, size_t, char, const float *,
+				      const float *, const float *, const MoistAirColumnsF &) const;
 
-double Ashrae::RELHUM(double T, double P){
-  if (!FaixaT(T)) {errorcode=10;}
-  if (!FaixaT(P)) {errorcode=11;}
-  return XV * P / (eFactor(T,P) * Pws(T));
+/*! As verses vetoriais das funes em lote reproduzem as correlaes do tipo dinmico? Ver GasPerfeito::nativeBatch.
+\return true se o tipo dinmico  Ashrae
+*/
+bool Ashrae::nativeBatch() const{
+  return typeid(*this) == typeid(Ashrae);
 }
 
-double Ashrae::WETBULB(double T, double P){
-  // Esta funo calcula a temperatura de bulbo mido
-  // Este aqui necessariamente tem que ser iterativo. CHute inicial TBS-1
-  // A funo ir calcular TBU usando a funo auxiliar AuxWB
-  if (!FaixaT(T)) {errorcode=10;}
-  if (!FaixaT(P)) {errorcode=11;}
+/*! Malha de presses e umidades na temperatura T (ver grid_eval). As grandezas que dependem apenas de T (ver SaturationPoint: presso de vapor, fase condensada, constante de Henry e coeficientes viriais) so calculadas uma nica vez, o enhancement factor uma vez por presso, e os estados e as propriedades explcitas de cada ponto por Kernel::grid, reutilizando-as. Como em batch, os estados dados pelo bulbo mido (ch = 'B'), o ponto de orvalho e o bulbo mido so calculados pelas verses vetoriais (stateBatch, DEWPOINTBatch e WETBULBBatch). Se as verses vetoriais no corresponderem ao tipo dinmico (ver GasPerfeito::nativeBatch), cada ponto  calculado com state e evaluate_all (ver grid_row_eval).
+\param T Temperatura em K
+\param nP Nmero de presses
+\param P Presses em Pa
+\param ch Tipo de umidade ('R', 'W', 'D', 'B' ou 'X', ver set)
+\param nU Nmero de umidades
+\param umidade Umidades
+\param out Colunas de sada com nP*nU elementos; o ponto (j, k)  o elemento j*nU + k
+*/
+void Ashrae::gridRow(double T, size_t nP, const double *P, char ch, size_t nU,
+		     const double *umidade, const MoistAirColumns &out) const{
+  if (!nativeBatch()){
+    grid_row_eval(*this, T, nP, P, ch, nU, umidade, out);
+    return;
+  }
+  gridRowModel(AshraeStatic(*this), T, nP, P, ch, nU, umidade, out);
+}
 
-  
-  double B = T - 1.0;
-  double f, df, w=W, dB;
-  const double EPS=1e-7;
-  const int NMAX = 400;
-  double xsv;
-  
-  for (int iter = 0; iter < NMAX; ++iter){
-
-    // Calcular f e df (funo auxilar)
-    f = AuxWB(w, T, B, P);
-    df = (AuxWB(w, T, B + 0.00001, P) - f) / 0.00001;
-    dB = -f / df;
-    B = B + dB;
-    if (fabs(dB) < EPS) return B;
+/// gridRow com o modelo esttico m do tipo dinmico (ver models.h)
+template<class Model>
+void Ashrae::gridRowModel(const Model &m, double T, size_t nP, const double *P, char ch,
+			  size_t nU, const double *umidade, const MoistAirColumns &out) const{
+  if (!out.dewpoint && !out.wetbulb && ch != 'B'){
+    Kernel<Model>::grid(m, T, nP, P, ch, nU, umidade, out);
+    return;
   }
 
-  errorcode = 100;
-  return B;
+  size_t n = nP * nU;
+  vector<double> buf(5*n);
+  vector<int> st(n);
+  vector<MoistAirState> s;
+  double *W = &buf[0], *xv = &buf[n], *Tc = &buf[2*n], *Pc = &buf[3*n], *Uc = &buf[4*n];
+  for (size_t j = 0; j < nP; ++j)
+    for (size_t k = 0; k < nU; ++k){
+      Tc[j*nU + k] = T;
+      Pc[j*nU + k] = P[j];
+      Uc[j*nU + k] = umidade[k];
+    }
+  if (ch == 'B'){
+    s.resize(n);
+    stateBatch(n, ch, Tc, Uc, Pc, &s[0]);
+  }
+
+  MoistAirColumns o = out;
+  o.dewpoint = o.wetbulb = 0;
+  o.W = W;
+  o.xv = xv;
+  o.status = &st[0];
+  Kernel<Model>::grid(m, T, nP, P, ch, nU, umidade, o, s.empty() ? 0 : &s[0]);
+
+  if (out.dewpoint) DEWPOINTBatch(n, Pc, xv, out.dewpoint, &st[0]);
+  if (out.wetbulb) WETBULBBatch(n, Tc, Pc, W, out.wetbulb, &st[0]);
+
+  for (size_t i = 0; i < n; ++i){
+    if (out.W) out.W[i] = W[i];
+    if (out.xv) out.xv[i] = xv[i];
+    if (out.status) out.status[i] = st[i];
+  }
+}
+
+template void Ashrae::gridRowModel(const GiacomoStatic &, double, size_t, const double *, char,
+				   size_t, const double *, const MoistAirColumns &) const;
+
+double Ashrae::ENTHALPY(double T, double P){
+  return cached(T, P, PROP_ENTHALPY).enthalpy;
+}
+
+double Ashrae::VOLUME(double T, double P){
+  return cached(T, P, PROP_VOLUME).volume;
+}
+
+double Ashrae::DENSITY(double T, double P){
+  return cached(T, P, PROP_DENSITY).density;
+}
+
+
+double Ashrae::DEWPOINT(double T, double P){
+  return cached(T, P, PROP_DEWPOINT).dewpoint;
+}
+
+
+double Ashrae::RELHUM(double T, double P){
+  return cached(T, P, PROP_RELHUM).relhum;
+}
+
+double Ashrae::WETBULB(double T, double P){
+  return cached(T, P, PROP_WETBULB).wetbulb;
 }
 
     
@@ -0,0 +1,244 @@
+#include <cmath>
+#include <cstring>
+
+#include <psychro/psychro.h>
+
+
+using namespace std;
+
+
+/*! Cria a memria vazia. A capacidade  dividida igualmente entre as parties e arredondada para cima para um mltiplo de WAYS.
+\param o Passos de quantizao, capacidade e nmero de parties
+*/
+ResultCache::ResultCache(const ResultCacheOptions &o): opt(o), shards(o.shards ? o.shards : 1){
+  size_t per = shards.size() * WAYS;
+  nsets = (opt.capacity + per - 1) / per;
+  if (nsets < 1) nsets = 1;
+  for (size_t k = 0; k < shards.size(); ++k){
+    shards[k].slots.resize(nsets * WAYS);
+    shards[k].clock = 0;
+    shards[k].hits = shards[k].misses = shards[k].evictions = 0;
+    shards[k].size = 0;
+  }
+}
+
+
+/// Arredonda x para o mltiplo de d mais prximo (d nulo: x exato) e armazena em k o ndice do mltiplo ou os bits de x
+static bool snap(double &x, double d, int64_t &k){
+  if (!std::isfinite(x)) return false;
+  if (d > 0){
+    double r = nearbyint(x / d);
+    if (fabs(r) > 4e18) return false;
+    k = (int64_t) r;
+    x = r * d;
+  }
+  else{
+    if (x == 0) x = 0;		// -0 e +0 so o mesmo estado
+    memcpy(&k, &x, sizeof(k));
+  }
+  return true;
+}
+
+
+/*! Quantiza as entradas (ver ResultCacheOptions) e calcula a chave correspondente. config  m.configHash(), calculado uma vez por chamada de get ou batch.
+\return false se alguma entrada no for finita: o estado  calculado mas no  armazenado
+*/
+bool ResultCache::quantize(const Psychro &m, uint64_t config, double &T, char ch, double &umidade,
+			   double &P, Key &k) const{
+  double du;
+  switch(ch){
+  case 'B':
+  case 'D': du = opt.dT; break;
+  case 'R': du = opt.dR; break;
+  case 'W':
+  case 'X': du = opt.dW; break;
+  default: du = 0;
+  }
+  k.model = m.id.value;
+  k.config = config;
+  k.ch = ch;
+  return snap(T, opt.dT, k.T) && snap(umidade, du, k.u) && snap(P, opt.dP, k.P);
+}
+
+
+/// Mistura de bits (splitmix64)
+static inline uint64_t mix(uint64_t h){
+  h ^= h >> 30;
+  h *= 0xbf58476d1ce4e5b9ULL;
+  h ^= h >> 27;
+  h *= 0x94d049bb133111ebULL;
+  return h ^ (h >> 31);
+}
+
+
+/// Partio e conjunto da chave k
+ResultCache::Shard &ResultCache::shard(const Key &k, size_t &set){
+  uint64_t h = mix(k.model ^ (uint64_t) (unsigned char) k.ch);
+  h = mix(h ^ k.config);
+  h = mix(h ^ (uint64_t) k.T);
+  h = mix(h ^ (uint64_t) k.u);
+  h = mix(h ^ (uint64_t) k.P);
+  set = (size_t) (h % nsets);
+  return shards[(size_t) (h >> 40) % shards.size()];
+}
+
+
+/// Procura a chave k. Se encontrar, copia o resultado em r
+bool ResultCache::find(const Key &k, MoistAirProperties &r){
+  size_t set;
+  Shard &s = shard(k, set);
+  lock_guard<mutex> g(s.lock);
+  Entry *e = &s.slots[set * WAYS];
+  for (int w = 0; w < WAYS; ++w)
+    if (e[w].stamp && e[w].key == k){
+      e[w].stamp = ++s.clock;
+      r = e[w].props;
+      ++s.hits;
+      return true;
+    }
+  ++s.misses;
+  return false;
+}
+
+
+/// Armazena o resultado r da chave k no lugar do resultado utilizado h mais tempo do conjunto
+void ResultCache::insert(const Key &k, const MoistAirProperties &r){
+  size_t set;
+  Shard &s = shard(k, set);
+  lock_guard<mutex> g(s.lock);
+  Entry *e = &s.slots[set * WAYS], *v = e;
+  for (int w = 0; w < WAYS; ++w){
+    // Outra thread pode ter calculado a mesma chave
+    if (e[w].stamp && e[w].key == k){
+      v = e + w;
+      break;
+    }
+    if (e[w].stamp < v->stamp) v = e + w;
+  }
+  if (!v->stamp) ++s.size;
+  else if (!(v->key == k)) ++s.evictions;
+  v->key = k;
+  v->props = r;
+  v->stamp = ++s.clock;
+}
+
+
+/// Campos de MoistAirProperties correspondentes s colunas (ver MoistAirColumns::column)
+static double MoistAirProperties::* const fields[] = {
+  &MoistAirProperties::W, &MoistAirProperties::xv, &MoistAirProperties::density,
+  &MoistAirProperties::volume, &MoistAirProperties::enthalpy, &MoistAirProperties::relhum,
+  &MoistAirProperties::dewpoint, &MoistAirProperties::wetbulb
+};
+
+
+/// Copia r para a amostra i das colunas no nulas de out
+static void put(const MoistAirColumns &out, size_t i, const MoistAirProperties &r){
+  for (int c = 0; c < MoistAirColumns::NCOL; ++c){
+    double *col = out.*MoistAirColumns::column(c);
+    if (col) col[i] = r.*fields[c];
+  }
+  if (out.status) out.status[i] = r.status;
+}
+
+
+/*! Propriedades do estado dado pelas entradas de Psychro::state, quantizadas (ver ResultCacheOptions). Se a entrada j estiver armazenada, o resultado  copiado da memria; seno  calculado por m.batch com uma nica amostra (fora do bloqueio), como em batch, e armazenado.
+\param m Modelo
+\param T Temperatura em K
+\param ch Tipo de umidade ('R', 'W', 'D', 'B' ou 'X', ver Psychro::set)
+\param umidade Umidade
+\param P Presso em Pa
+\return Todas as propriedades do estado
+*/
+MoistAirProperties ResultCache::get(const Psychro &m, double T, char ch, double umidade, double P){
+  Key k;
+  bool ok = quantize(m, m.configHash(), T, ch, umidade, P, k);
+  MoistAirProperties r(MoistAirState{});
+  if (ok && find(k, r)) return r;
+
+  MoistAirColumns o;
+  for (int c = 0; c < MoistAirColumns::NCOL; ++c) o.*MoistAirColumns::column(c) = &(r.*fields[c]);
+  o.status = &r.status;
+  m.batch(1, ch, &T, &umidade, &P, o);
+  if (ok) insert(k, r);
+  return r;
+}
+
+
+/*! Clculo em lote atravs da memria. As amostras so processadas em blocos: as que esto na memria so copiadas e as demais so calculadas juntas por m.batch (com as verses vetoriais do modelo) e armazenadas. get calcula as entradas ausentes da mesma forma, portanto os resultados armazenados no dependem de qual das duas funes calculou a entrada.
+\param m Modelo utilizado
+\param n Nmero de amostras
+\param ch Tipo de umidade ('R', 'W', 'D', 'B' ou 'X', ver Psychro::set)
+\param T Temperaturas em K
+\param umidade Umidades
+\param P Presses em Pa
+\param out Colunas de sada (ponteiros nulos no so calculados)
+*/
+void ResultCache::batch(const Psychro &m, size_t n, char ch, const double *T,
+			const double *umidade, const double *P, const MoistAirColumns &out){
+  const size_t NB = 256;
+  double t[NB], u[NB], p[NB], res[MoistAirColumns::NCOL][NB];
+  int st[NB];
+  size_t idx[NB];
+  Key key[NB];
+  bool ok[NB];
+  MoistAirProperties r(MoistAirState{});
+  MoistAirColumns o;
+  for (int c = 0; c < MoistAirColumns::NCOL; ++c) o.*MoistAirColumns::column(c) = res[c];
+  o.status = st;
+  const uint64_t config = m.configHash();
+
+  for (size_t i0 = 0; i0 < n; i0 += NB){
+    size_t len = (n - i0 < NB) ? n - i0 : NB, nm = 0;
+
+    // Amostras armazenadas; as demais so agrupadas no incio de t, u e p
+    for (size_t j = 0; j < len; ++j){
+      size_t i = i0 + j;
+      t[nm] = T[i];
+      u[nm] = umidade[i];
+      p[nm] = P[i];
+      ok[nm] = quantize(m, config, t[nm], ch, u[nm], p[nm], key[nm]);
+      if (ok[nm] && find(key[nm], r)){
+	put(out, i, r);
+	continue;
+      }
+      idx[nm++] = i;
+    }
+    if (!nm) continue;
+
+    m.batch(nm, ch, t, u, p, o);
+    for (size_t j = 0; j < nm; ++j){
+      for (int c = 0; c < MoistAirColumns::NCOL; ++c) r.*fields[c] = res[c][j];
+      r.status = st[j];
+      if (ok[j]) insert(key[j], r);
+      put(out, idx[j], r);
+    }
+  }
+}
+
+
+/*! Estatsticas somadas de todas as parties
+ */
+ResultCache::Stats ResultCache::stats() const{
+  Stats s = {0, 0, 0, 0};
+  for (size_t k = 0; k < shards.size(); ++k){
+    const Shard &h = shards[k];
+    lock_guard<mutex> g(h.lock);
+    s.hits += h.hits;
+    s.misses += h.misses;
+    s.evictions += h.evictions;
+    s.size += h.size;
+  }
+  return s;
+}
+
+
+void ResultCache::clear(){
+  for (size_t k = 0; k < shards.size(); ++k){
+    Shard &h = shards[k];
+    lock_guard<mutex> g(h.lock);
+    for (size_t j = 0; j < h.slots.size(); ++j) h.slots[j].stamp = 0;
+    h.clock = 0;
+    h.hits = h.misses = h.evictions = 0;
+    h.size = 0;
+  }
+}
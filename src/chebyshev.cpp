@@ -0,0 +1,179 @@
+#include <cmath>
+
+#include <psychro/chebyshev.h>
+
+
+using namespace std;
+
+
+ChebyshevTable::ChebyshevTable(): x0(0), x1(0), y0(0), y1(0), mx(0), my(0), nx(0), ny(0),
+				  hx(0), hy(0), maxerr(0){}
+
+
+/*! Ajusta uma funo de uma varivel no intervalo [x0, x1]
+\param f Funo a ser aproximada
+\param x0 Limite inferior
+\param x1 Limite superior
+\param mx Grau dos polinmios
+\param tol Maior erro relativo admissvel
+\param nmax Nmero mximo de intervalos
+\return 0 se a tolerncia foi atingida, 1 caso contrrio (a tabela fica com nmax intervalos)
+*/
+int ChebyshevTable::fit(const function<double(double)> &f, double x0, double x1, int mx,
+			double tol, int nmax){
+  return fit([&f](double x, double){ return f(x); }, x0, x1, 0.0, 0.0, mx, 0, tol, nmax);
+}
+
+
+/*! Ajusta uma funo de duas variveis no retngulo [x0, x1] x [y0, y1]. A cada tentativa o nmero de intervalos em cada direo  dobrado.
+\param f Funo a ser aproximada
+\param x0 Limite inferior em x
+\param x1 Limite superior em x
+\param y0 Limite inferior em y
+\param y1 Limite superior em y
+\param mx Grau dos polinmios em x
+\param my Grau dos polinmios em y (0 para funes de uma varivel)
+\param tol Maior erro relativo admissvel
+\param nmax Nmero mximo de intervalos em cada direo
+\return 0 se a tolerncia foi atingida, 1 caso contrrio
+*/
+int ChebyshevTable::fit(const function<double(double,double)> &f, double x0, double x1,
+			double y0, double y1, int mx, int my, double tol, int nmax){
+  this->x0 = x0; this->x1 = x1;
+  this->y0 = y0; this->y1 = y1;
+  this->mx = mx; this->my = my;
+
+  for (int n = 1; n <= nmax; n *= 2){
+    nx = n;
+    ny = (my > 0) ? n : 1;
+    hx = nx / (x1 - x0);
+    hy = (my > 0) ? ny / (y1 - y0) : 0.0;
+
+    c.assign((size_t)nx * ny * (mx+1) * (my+1), 0.0);
+    for (int i = 0; i < nx; ++i)
+      for (int j = 0; j < ny; ++j)
+	fitSegment(f, i, j);
+
+    maxerr = check(f);
+    if (maxerr <= tol) return 0;
+  }
+  return 1;
+}
+
+
+/*! Interpolao nos ns de Chebyshev do retngulo (i, j)
+ */
+void ChebyshevTable::fitSegment(const function<double(double,double)> &f, int i, int j){
+  const int kx = mx+1, ky = my+1;
+  double xa = x0 + i / hx;
+  double ya = (my > 0) ? y0 + j / hy : y0;
+  vector<double> F(kx*ky);
+
+  for (int q = 0; q < ky; ++q){
+    double ty = cos(M_PI*(q+0.5)/ky);
+    double y = (my > 0) ? ya + 0.5*(ty+1)/hy : y0;
+    for (int p = 0; p < kx; ++p){
+      double tx = cos(M_PI*(p+0.5)/kx);
+      F[q*kx + p] = f(xa + 0.5*(tx+1)/hx, y);
+    }
+  }
+
+  double *a = &c[((size_t)i*ny + j) * kx * ky];
+  for (int r = 0; r < ky; ++r)
+    for (int s = 0; s < kx; ++s){
+      double sum = 0.0;
+      for (int q = 0; q < ky; ++q)
+	for (int p = 0; p < kx; ++p)
+	  sum += F[q*kx + p] * cos(M_PI*s*(p+0.5)/kx) * cos(M_PI*r*(q+0.5)/ky);
+      sum *= 4.0 / (kx*ky);
+      if (s == 0) sum *= 0.5;
+      if (r == 0) sum *= 0.5;
+      a[r*kx + s] = sum;
+    }
+}
+
+
+/*! Maior erro relativo nos extremos de \f$T_{m+1}\f$ de cada intervalo, onde o erro de interpolao  mximo
+ */
+double ChebyshevTable::check(const function<double(double,double)> &f) const{
+  double emax = 0.0;
+  const int kx = mx+1, ky = (my > 0) ? my+1 : 0;
+
+  for (int i = 0; i < nx; ++i)
+    for (int j = 0; j < ny; ++j)
+      for (int q = 0; q <= ky; ++q)
+	for (int p = 0; p <= kx; ++p){
+	  double x = x0 + (i + 0.5*(1 - cos(M_PI*p/kx))) / hx;
+	  double y = (my > 0) ? y0 + (j + 0.5*(1 - cos(M_PI*q/ky))) / hy : y0;
+	  double fe = f(x, y);
+	  double fa = (my > 0) ? (*this)(x, y) : (*this)(x);
+	  double e = fabs(fa - fe);
+	  if (fe != 0.0) e /= fabs(fe);
+	  if (e > emax) emax = e;
+	}
+  return emax;
+}
+
+
+/*! Intervalo que contm x e a coordenada local t em [-1, 1]
+ */
+int ChebyshevTable::locate(double x, double a, double h, int n, double &t) const{
+  double u = (x - a) * h;
+  int i = (int) u;
+  if (i < 0) i = 0;
+  else if (i > n-1) i = n-1;
+  t = 2*(u - i) - 1;
+  return i;
+}
+
+
+/*! Valor da aproximao de uma varivel (algoritmo de Clenshaw)
+\param x Abscissa, deve estar no domnio (ver contains)
+\param dx Se no for nulo, recebe a derivada em relao a x
+\return Valor aproximado da funo
+*/
+double ChebyshevTable::operator()(double x, double *dx) const{
+  double t;
+  int i = locate(x, x0, hx, nx, t);
+  const double *a = &c[(size_t)i * (mx+1)];
+
+  double b1 = 0, b2 = 0, d1 = 0, d2 = 0, b0, d0;
+  for (int k = mx; k > 0; --k){
+    d0 = 2*b1 + 2*t*d1 - d2;
+    b0 = 2*t*b1 - b2 + a[k];
+    b2 = b1; b1 = b0;
+    d2 = d1; d1 = d0;
+  }
+
+  if (dx) *dx = (b1 + t*d1 - d2) * 2 * hx;
+  return t*b1 - b2 + a[0];
+}
+
+
+/*! Valor da aproximao de duas variveis (Clenshaw em x para cada coeficiente em y e depois em y)
+\param x Abscissa, deve estar no domnio (ver contains)
+\param y Ordenada, deve estar no domnio
+\return Valor aproximado da funo
+*/
+double ChebyshevTable::operator()(double x, double y) const{
+  double tx, ty;
+  int i = locate(x, x0, hx, nx, tx);
+  int j = locate(y, y0, hy, ny, ty);
+  const int kx = mx+1;
+  const double *a = &c[((size_t)i*ny + j) * kx * (my+1)];
+
+  double c1 = 0, c2 = 0, c0 = 0;
+  for (int r = my; r >= 0; --r){
+    const double *ar = a + r*kx;
+    double b1 = 0, b2 = 0, b0;
+    for (int k = mx; k > 0; --k){
+      b0 = 2*tx*b1 - b2 + ar[k];
+      b2 = b1; b1 = b0;
+    }
+    double cr = tx*b1 - b2 + ar[0];
+    if (r == 0) return ty*c1 - c2 + cr;
+    c0 = 2*ty*c1 - c2 + cr;
+    c2 = c1; c1 = c0;
+  }
+  return c0;
+}
@@ -0,0 +1,120 @@
+#include <cstring>
+#include <cstdint>
+#include <vector>
+
+#include <psychro/psychro.h>
+
+
+using namespace std;
+
+
+/// Bits de x (+0 e -0 so a mesma entrada)
+static inline uint64_t bits(double x){
+  uint64_t b;
+  if (x == 0) x = 0;
+  memcpy(&b, &x, sizeof(b));
+  return b;
+}
+
+
+/*! Clculo em lote de dados com muitas amostras repetidas, como as sries de um sistema de aquisio com entradas quantizadas, em que o mesmo trio (T, umidade, P) aparece em longas sequncias.
+
+As amostras so processadas em blocos. Em cada bloco, as amostras distintas so identificadas (uma amostra igual  anterior  reconhecida diretamente; as demais por uma tabela de disperso das entradas), apenas elas so calculadas, numa nica chamada a m.batch, e os resultados so copiados para as posies de todas as amostras iguais. Um bloco sem repeties  passado diretamente para m.batch. Amostras so iguais se as entradas forem idnticas bit a bit; os resultados so portanto os mesmos de m.batch.
+
+A razo n / (valor retornado)  o fator de reduo do nmero de clculos (em particular das iteraes do bulbo mido e do ponto de orvalho). Como as repeties so procuradas dentro de cada bloco, o valor retornado pode ser maior que o nmero de trios distintos de todo o lote.
+
+\param m Modelo utilizado
+\param n Nmero de amostras
+\param ch Tipo de umidade ('R', 'W', 'D', 'B' ou 'X', ver Psychro::set)
+\param T Temperaturas em K
+\param umidade Umidades
+\param P Presses em Pa
+\param out Colunas de sada (ponteiros nulos no so calculados)
+\return Nmero de amostras calculadas
+*/
+size_t dedup_batch(const Psychro &m, size_t n, char ch, const double *T,
+		   const double *umidade, const double *P, const MoistAirColumns &out){
+  // Blocos de at 16384 amostras; a tabela de disperso tem ao menos o dobro de posies
+  const size_t NB = (n < 16384) ? n : 16384;
+  size_t NH = 16;
+  while (NH < 2*NB) NH *= 2;
+  const uint32_t VAZIO = 0xffffffff;
+  vector<uint32_t> tab(NH), idx(NB);
+  vector<uint64_t> key;
+  vector<double> in, res;
+  vector<int> st;
+  MoistAirColumns o;
+  size_t total = 0;
+
+  for (size_t i0 = 0; i0 < n; i0 += NB){
+    size_t len = (n - i0 < NB) ? n - i0 : NB, nu = 0;
+    const double *t = T + i0, *u = umidade + i0, *p = P + i0;
+
+    if (key.empty()){
+      key.resize(3*NB);
+      in.resize(3*NB);
+    }
+    for (size_t k = 0; k < NH; ++k) tab[k] = VAZIO;
+
+    for (size_t j = 0; j < len; ++j){
+      uint64_t a = bits(t[j]), b = bits(u[j]), c = bits(p[j]);
+      // Sequncia de amostras iguais
+      if (j && a == key[3*idx[j-1]] && b == key[3*idx[j-1]+1] && c == key[3*idx[j-1]+2]){
+	idx[j] = idx[j-1];
+	continue;
+      }
+      uint64_t h = a * 0x9e3779b97f4a7c15ULL;
+      h = (h ^ (h >> 29) ^ b) * 0xbf58476d1ce4e5b9ULL;
+      h = (h ^ (h >> 31) ^ c) * 0x94d049bb133111ebULL;
+      size_t s = (size_t) (h >> 32) & (NH - 1);
+      for (;; s = (s + 1) & (NH - 1)){
+	uint32_t q = tab[s];
+	if (q == VAZIO){
+	  tab[s] = (uint32_t) nu;
+	  key[3*nu] = a;
+	  key[3*nu+1] = b;
+	  key[3*nu+2] = c;
+	  in[nu] = t[j];
+	  in[NB+nu] = u[j];
+	  in[2*NB+nu] = p[j];
+	  idx[j] = (uint32_t) nu++;
+	  break;
+	}
+	if (key[3*q] == a && key[3*q+1] == b && key[3*q+2] == c){
+	  idx[j] = q;
+	  break;
+	}
+      }
+    }
+    total += nu;
+
+    // Sem repeties: no  necessrio copiar
+    if (nu == len){
+      m.batch(len, ch, t, u, p, out.shift(i0));
+      continue;
+    }
+
+    if (res.empty()){
+      res.resize(MoistAirColumns::NCOL*NB);
+      for (int k = 0; k < MoistAirColumns::NCOL; ++k)
+	if (out.*MoistAirColumns::column(k))
+	  o.*MoistAirColumns::column(k) = &res[k*NB];
+      if (out.status){
+	st.resize(NB);
+	o.status = &st[0];
+      }
+    }
+
+    m.batch(nu, ch, &in[0], &in[NB], &in[2*NB], o);
+
+    for (int k = 0; k < MoistAirColumns::NCOL; ++k){
+      double *dst = out.*MoistAirColumns::column(k);
+      if (!dst) continue;
+      const double *src = o.*MoistAirColumns::column(k);
+      for (size_t j = 0; j < len; ++j) dst[i0 + j] = src[idx[j]];
+    }
+    if (out.status)
+      for (size_t j = 0; j < len; ++j) out.status[i0 + j] = st[idx[j]];
+  }
+  return total;
+}
@@ -1,6 +1,13 @@
 #include <cmath>
+#include <typeinfo>
 
 #include <psychro/psychro.h>
+#include <psychro/models.h>
+
+#if defined(__GNUC__)
+// As funes vetoriais deste arquivo retornam os vetores de 4 e 8 elementos (ver vecmath.h)
+#pragma GCC diagnostic ignored "-Wpsabi"
+#endif
 
 /*! \file GasPerfeito.cpp
   \brief Este arquivo implementa as classe GasPerfeito
@@ -30,19 +37,43 @@ GasPerfeito::GasPerfeito(){
   \param xv Frao molar
   \return Compressibilidade do gs
 */
-double GasPerfeito::Z(double TT, double PP, double xv){
+double GasPerfeito::Z(double, double, double, int *) const{
   return 1.0;
 }
 
+/*! Compressibilidade de n estados, calculada por Z em cada estado.
+\param n Nmero de estados
+\param T Temperaturas em K
+\param P Presses em Pa
+\param xv Fraes molares de vapor
+\param Z Recebe as compressibilidades
+\param err Se no for nulo, err[i] recebe o cdigo de erro do estado i (os elementos sem erro no so modificados)
+*/
+void GasPerfeito::ZBatch(size_t n, const double *T, const double *P, const double *xv,
+			 double *Z, int *err) const{
+  for (size_t i = 0; i < n; ++i) Z[i] = this->Z(T[i], P[i], xv[i], err ? err+i : 0);
+}
+
 /*! Esta funo retorna o enhancement factor que neste caso vale 1 (gs perfeito). Implementado apenas para manter a estrutura da biblioteca.
   \param TT Temperatura do ar mido em K
   \param PP Presso em Pa
   \return Retorna o enhancement factor. Neste caso, gs perfeito, retorna 1
  */
-double GasPerfeito::eFactor(double TT, double PP){
+double GasPerfeito::eFactor(double, double) const{
   return 1.0;
 }
 
+/*! Enhancement factor de n estados, calculado por eFactor em cada estado.
+\param n Nmero de estados
+\param T Temperaturas em K
+\param P Presses em Pa
+\param f Recebe os enhancement factors
+*/
+void GasPerfeito::eFactorBatch(size_t n, const double *T, const double *P, double *f,
+			       int *) const{
+  for (size_t i = 0; i < n; ++i) f[i] = eFactor(T[i], P[i]);
+}
+
 
 // Entalpia do ar mido (linear)
 
@@ -50,8 +81,8 @@ double GasPerfeito::eFactor(double TT, double PP){
   \param T Temperatura em K
   \return A entalpia do ar seco em J/kg
  */
-double GasPerfeito::h_a_(double T){
-  return 1006*(T - 273.15);
+double GasPerfeito::h_a_(double T) const{
+  return GasPerfeitoCorrelations::h_a(T);
 }
 
 
@@ -60,8 +91,24 @@ double GasPerfeito::h_a_(double T){
   \param T Temperatura em K
   \return A entalpia do vapor saturado em J/kg
  */
-double GasPerfeito::h_v_(double T){
-  return 1000.0 * (2501.0 + 1.805*(T-273.15));
+double GasPerfeito::h_v_(double T, int *) const{
+  return GasPerfeitoCorrelations::h_v(T);
+}
+
+/*! Derivada da entalpia do ar seco (calor especfico) em J/(kg.K), coerente com h_a_
+  \param T Temperatura em K
+  \return \f$dh_a/dT\f$
+*/
+double GasPerfeito::dh_a_(double) const{
+  return 1006.0;
+}
+
+/*! Derivada da entalpia do vapor saturado (calor especfico) em J/(kg.K), coerente com h_v_
+  \param T Temperatura em K
+  \return \f$dh_v/dT\f$
+*/
+double GasPerfeito::dh_v_(double) const{
+  return 1805.0;
 }
 
 // Entalpia do ar mido
@@ -70,44 +117,55 @@ double GasPerfeito::h_v_(double T){
 \param xv Frao molar de vapor
   \return A entalpia do ar mido em J/kg
 */
-double GasPerfeito::h_(double T, double xv){
-  double xa = 1.0 - xv;
-  double M = xa * Ma + xv * Mv;
-  
-  return (xa * h_a_(T) * Ma + xv * h_v_(T) * Mv) / (xa*Ma + xv*Mv);
-  
+double GasPerfeito::h_(double T, double xv) const{
+  return Kernel<GasPerfeito>::h_(*this, T, xv);
 }
 
 /*! Entalpia do gelo. Vlido para T < 273.15
 \param T Temperatura em K
   \return A entalpia do gelo saturado em J/kg
 */
-double GasPerfeito::h_s_(double T){
-      return 1000.0 * (334.402 + 1.95645*(T-273.15));  // Gelo
+double GasPerfeito::h_s_(double T) const{
+  return GasPerfeitoCorrelations::h_s(T);
 }
 
 /*! Entalpia da gua lquida saturada, T > 273.15
   \param T Temperatura em K
   \return A entalpia da gua saturada em J/kg
 */
-double GasPerfeito::h_l_(double T){
-      return 1000.0 * (334.402 + 1.95645*(T-273.15));  // Gelo
+double GasPerfeito::h_l_(double T) const{
+  return GasPerfeitoCorrelations::h_s(T);
 }
  
+/*! Derivada da entalpia da fase no gasosa (calor especfico) em J/(kg.K)
+  \param T Temperatura em K
+  \return \f$dh_f/dT\f$
+*/
+double GasPerfeito::dh_f_(double T) const{
+  return GasPerfeitoCorrelations::dh_f(T);
+}
+
 /*! Entalpia da fase no gasosa em J/kg. Para T<273.15, isto corresponde ao gelo. Para T > 273.15, a fase no gasosa corresponde  gua.
   \param T Temperatura em K
   \return A entalpia da fase no gasosa da gua em J/kg
 */
-double GasPerfeito::h_f_(double T){
-    if (T<273.15)
-      return 1000.0 * (334.402 + 1.95645*(T-273.15));  // Gelo
-    else
-      return (4186*(T-273.15));	// gua
+double GasPerfeito::h_f_(double T) const{
+  return GasPerfeitoCorrelations::h_f(T);
 }
 
 
 
 
+/// Faixas de presso e coeficientes da correlao de temperatura de saturao (ver GasPerfeitoCorrelations::tabTws)
+alignas(64) const double GasPerfeitoCorrelations::tabTws[6][7] = {
+  {1.0, 611.0, 0.1004926534E-2, 0.1392917633E-2, 0.2815151574E0, 0.7311621119E1, 0.2125893734E3},
+  {611.0, 12350.0, 0.5031062503E-2, -0.8826779380E-1, 0.1243688446E1, 0.3388534296E1, 0.2150077993E3},
+  {12350.0, 101420.0, 0.0121404, -0.356801, 5.06151, -20.8232, 272.789},
+  {101420.0, 476207.0, 0.2467291016E-1, -0.9367112883E0, 0.1514142334E2, -0.9882417501E2, 0.4995092948E3},
+  {476207.0, 1555099.0, 0.2748402484E-1, -0.1068661307E1, 0.1742964962E2, -0.1161208532E3, 0.5472618120E3},
+  {1555099.0, 22089000.0, 0.0, 0.428138, -12.6338, 146.784, -292.288}
+};
+
 /*! Esta funo calcula a temperatura de saturao de vapor em K. Neste caso, a correlao foi retirada de
 ASHRAE, Psychrometrics: Theory and Practice, 1996 (Tabela 16).
 
@@ -115,73 +173,60 @@ Cuidado com erros no livro. Modifica
 
 A correlao  vlida para p = 1 Pa a p = 1555099
 \param p Presso do vapor saturado em Pa
-\return Temperatura do vapor saturado em K
-*/
-double GasPerfeito::Tws(double p)
-{
-  double P = p;
-  double beta, T;
-  double E, F, G, H, K;
-
-  if ( 1.0 <= P && P < 611.0)
-    {
-      E = 0.1004926534E-2;
-      F = 0.1392917633E-2;
-      G = 0.2815151574E0;
-      H = 0.7311621119E1;
-      K = 0.2125893734E3;
-    }
-  else if (611.0 <= P && P < 12350.0)
-    {
-      E = 0.5031062503E-2;
-      F = -0.8826779380E-1;
-      G = 0.1243688446E1;
-      H = 0.3388534296E1;
-      K = 0.2150077993E3;
-    }
-  else if (12350.0 <= P && P < 101420.0)
-    {
-      E = 0.0121404;
-      F = -0.356801;
-      G = 5.06151;
-      H = -20.8232;
-      K = 272.789;
-    }
+\param err Se no for nulo, recebe 18 se p estiver fora da faixa da correlao (o cdigo 11, de FaixaP, se refere  presso do ar mido)
+\return Temperatura do vapor saturado em K (NaN fora da faixa da correlao)
+*/
+double GasPerfeito::Tws(double p, int *err) const{
+  return GasPerfeitoCorrelations::Tws(p, err);
+}
 
-  else if (101420.0 <= P && P < 476207.0)
-    {
-      E = 0.2467291016E-1;
-      F = -0.9367112883E0;
-      G = 0.1514142334E2;
-      H = -0.9882417501E2;
-      K = 0.4995092948E3;
-    }
-  else if (476207.0 <= P && P < 1555099.0)
-    {
-      E = 0.2748402484E-1;
-      F = -0.1068661307E1;
-      G = 0.1742964962E2;
-      H = -0.1161208532E3;
-      K = 0.5472618120E3;
-    }
-  else if (1555099.0 <= P && P <22089000.0)
-    {
-      E = 0.0;
-      F = 0.428138;
-      G = -12.6338;
-      H = 146.784;
-      K = -292.288;
-    }
-  else
-    {
-      // Fora dos limites
-    }
-  beta = log(P);
 
-  T = E*beta*beta*beta*beta + F*beta*beta*beta + G*beta*beta + H*beta + K;
-  return T;
-  
-  
+/*! Temperatura de saturao de n presses (ver Tws), vrias de cada vez. Os coeficientes de cada elemento so selecionados por mscaras a partir de GasPerfeitoCorrelations::tabTws. Se a verso vetorial no corresponder ao tipo dinmico (ver nativeBatch), cada presso  calculada por Tws.
+\param n Nmero de presses
+\param P Presses do vapor saturado em Pa
+\param T Recebe as temperaturas em K (NaN fora da faixa da correlao)
+\param err Se no for nulo, err[i] recebe 18 se P[i] estiver fora da faixa (os demais elementos no so modificados)
+*/
+PSYCHRO_NOINLINE void GasPerfeito::TwsBatch(size_t n, const double *P, double *T, int *err) const{
+  if (!nativeBatch()){
+    for (size_t i = 0; i < n; ++i) T[i] = Tws(P[i], err ? err+i : 0);
+    return;
+  }
+
+  PSYCHRO_SIMD_DISPATCH(TwsLanes, n, P, T, err);
+}
+
+/// TwsBatch com o vetor V (ver PSYCHRO_SIMD_DISPATCH)
+template<class V>
+void GasPerfeito::TwsLanes(size_t n, const double *P, double *T, int *err) const{
+  typedef typename vtraits<V>::mask M;
+  const size_t L = vtraits<V>::L;
+
+  for (size_t i = 0; i < n; i += L){
+    size_t m = (n - i < L) ? n - i : L;
+    V Pk = (m == L) ? vload<V>(P+i) : vload_tail<V>(P+i, m);
+    const double (&tab)[6][7] = GasPerfeitoCorrelations::tabTws;
+    const double *c = tab[5];
+    V E = vset<V>(c[2]), F = vset<V>(c[3]), G = vset<V>(c[4]), H = vset<V>(c[5]), K = vset<V>(c[6]);
+    for (int k = 4; k >= 0; --k){
+      M in = (M)(Pk < tab[k][1]);
+      c = tab[k];
+      E = vselect(in, vset<V>(c[2]), E);
+      F = vselect(in, vset<V>(c[3]), F);
+      G = vselect(in, vset<V>(c[4]), G);
+      H = vselect(in, vset<V>(c[5]), H);
+      K = vselect(in, vset<V>(c[6]), K);
+    }
+    M fora = (M)(Pk < tab[0][0]) | (M)(Pk >= tab[5][1]);
+    V beta = vlog(vselect(fora, vset<V>(1.0), Pk));
+    V Tk = (((E*beta + F)*beta + G)*beta + H)*beta + K;
+    Tk = vselect(fora, vset<V>(NAN), Tk);
+    if (m == L) vstore(T+i, Tk);
+    else vstore_tail(T+i, Tk, m);
+    if (err)
+      for (size_t j = 0; j < m; ++j)
+	if (fora[j]) err[i+j] = 18;
+  }
 }
 
 /***************************************
@@ -190,74 +235,74 @@ double GasPerfeito::Tws(double p)
 // Esta funo retorna a presso de saturao da gua em
 // kPa (-50 a +100oC sobre gua lquida)
 
+/// Faixas de temperatura e coeficientes da correlao de presso de vapor (ver GasPerfeitoCorrelations::tabPws)
+alignas(64) const double GasPerfeitoCorrelations::tabPws[6][6] = {
+  {213.149, 273.15, -0.7297593707E-5, 0.5397420727E-2, 0.2069880620E2, -0.604227518E4},
+  {273.149, 322.15, 0.1255001965E-4, -0.1923595289E-1, 0.2705101899E2, -0.6344011577E4},
+  {322.149, 373.15, 0.1246732157E-4, -0.1915465806E-1, 0.2702388315E2, -0.6340941639E4},
+  {373.149, 423.15, 0.1204507646E-4, -0.1866650553E-1, 0.2683629403E2, -0.6316972063E4},
+  {423.15, 473.15, 0.1069730183E-4, -0.1698965754E-1, 0.2614073298E2, -0.622078230E4},
+  {473.149, 647.15, 1.20064E-5, -0.0193912, 27.539, -6483.51}
+};
+
 /*! Esta funo calcula a presso de saturao de vapor em Pa. Neste caso, a correlao foi retirada de
 ASHRAE, Psychrometrics: Theory and Practice, 1996 (Tabela 15).
 
 Correlao vlida para temperaturas entre 213.15K e 473.15K e depois espandida at 647.15K por Paulo Jos Saiz Jabardo em 15/12/2002.
 \param T Temperatura do vapor saturado em K
-\return Presso do vapor saturado em Pa
+\param err Se no for nulo, recebe 17 se T estiver fora da faixa da correlao (213.149K a 647.15K, exclusive)
+\return Presso do vapor saturado em Pa (NaN fora da faixa da correlao)
 */
-double GasPerfeito::Pws(double T)
-{
+double GasPerfeito::Pws(double T, int *err) const{
+  return GasPerfeitoCorrelations::Pws(T, err);
+}
 
+/*! Derivada da presso de vapor saturado (ver Pws). Os coeficientes da faixa so procurados uma nica vez para a presso e a derivada.
+\param T Temperatura em K
+\return dP/dT Pa/K (NaN fora da faixa da correlao)
+*/
+double GasPerfeito::dPws(double T) const{
+  return GasPerfeitoCorrelations::dPws(T);
+}
 
+/*! Presso de vapor saturado e sua derivada calculadas juntas, com uma nica procura dos coeficientes e uma nica exponencial (ver Pws e dPws)
+\param T Temperatura em K
+\param dP Recebe dP/dT Pa/K (NaN fora da faixa da correlao)
+\return Presso de vapor em Pa (NaN fora da faixa da correlao)
+*/
+double GasPerfeito::PwsdPws(double T, double &dP) const{
+  return GasPerfeitoCorrelations::PwsdPws(T, dP);
+}
 
-  // Clculo da presso de saturao do vapor dgua, tabela 15, ASHRAE
-  double T_k;
-  double A, B, C, D, alfa;
 
-  T_k = T;
-  
+/*! Presso de vapor saturado de n temperaturas (ver Pws), calculadas vrias de cada vez (ver vecmath.h). Os coeficientes de cada elemento so selecionados por mscaras (ver GasPerfeitoCorrelations::coefPwsLanes). Temperaturas fora das faixas resultam em NaN. Se a verso vetorial no corresponder ao tipo dinmico (ver nativeBatch), cada temperatura  calculada por Pws.
+\param n Nmero de temperaturas
+\param T Temperaturas em K
+\param p Recebe as presses em Pa
+*/
+PSYCHRO_NOINLINE void GasPerfeito::PwsBatch(size_t n, const double *T, double *p) const{
+  if (!nativeBatch()){
+    for (size_t i = 0; i < n; ++i) p[i] = Pws(T[i]);
+    return;
+  }
 
-  if ( 213.149 <= T_k && T_k < 273.15)
-    {
-      A = -0.7297593707E-5;
-      B = 0.5397420727E-2;
-      C = 0.2069880620E2;
-      D = -0.604227518E4;
-    }
-  else if (273.149 <= T_k && T_k < 322.15)
-    {
-      A = 0.1255001965E-4;
-      B = -0.1923595289E-1;
-      C = 0.2705101899E2;
-      D = -0.6344011577E4;
-    }
-  else if (322.149 <= T_k && T_k < 373.15)
-    {
-      A = 0.1246732157E-4;
-      B = -0.1915465806E-1;
-      C = 0.2702388315E2;
-      D = -0.6340941639E4;
-    }
-  else if (373.149 <= T_k && T_k < 423.15)
-    {
-      A = 0.1204507646E-4;
-      B = -0.1866650553E-1;
-      C = 0.2683629403E2;
-      D = -0.6316972063E4;
-    }
-  else if (423.15 <= T_k && T_k < 473.15)
-    {
-      A = 0.1069730183E-4;
-      B = -0.1698965754E-1;
-      C = 0.2614073298E2;
-      D = -0.622078230E4;
-    }
-  else if (473.149 <= T_k && T_k < 647.15)
-    {
-      A = 1.20064E-5;
-      B = -0.0193912;
-      C = 27.539;
-      D = -6483.51;
-    }
+  PSYCHRO_SIMD_DISPATCH(PwsLanes, n, T, p);
+}
 
+/// PwsBatch com o vetor V (ver PSYCHRO_SIMD_DISPATCH)
+template<class V>
+void GasPerfeito::PwsLanes(size_t n, const double *T, double *p) const{
+  const size_t L = vtraits<V>::L;
 
-  alfa = A*T_k*T_k + B*T_k + C + D/T_k;
-  return 1000*exp(alfa);
-  
-  
-  
+  for (size_t i = 0; i < n; i += L){
+    size_t m = (n - i < L) ? n - i : L;
+    V Tk = (m == L) ? vload<V>(T+i) : vload_tail<V>(T+i, m);
+    V A, B, C, D;
+    GasPerfeitoCorrelations::coefPwsLanes(Tk, A, B, C, D);
+    V P = 1000*vexp(A*Tk*Tk + B*Tk + C + D/Tk);
+    if (m == L) vstore(p+i, P);
+    else vstore_tail(p+i, P, m);
+  }
 }
 
 
@@ -268,7 +313,7 @@ double GasPerfeito::Pws(double T)
   \param xv Frao molar do vapor
   \return Volume especfico do ar mido em \f$m^3/kg\f$
 */
-double GasPerfeito::v_(double T, double P, double xv){
+double GasPerfeito::v_(double T, double P, double xv, int *) const{
   double M = (1.0 - xv) * Ma + xv * Mv;
   return R*T/(P * M);
 }
@@ -279,7 +324,7 @@ double GasPerfeito::v_(double T, double P, double xv){
   \param xv Frao molar do vapor
   \return Densidade do ar mido em \f$kg/m^3\f$
 */
-double GasPerfeito::r_(double T, double P, double xv){
+double GasPerfeito::r_(double T, double P, double xv, int *) const{
   return 1/v_(T,P, xv);
 }
 
@@ -289,7 +334,7 @@ double GasPerfeito::r_(double T, double P, double xv){
   \param xv Frao molar do vapor
   \return Volume molar do ar mido em \f$m^3/kmol\f$
 */
-double GasPerfeito::vM_(double T, double P, double xv){
+double GasPerfeito::vM_(double T, double P, double, int *) const{
   return R*T/P;
 }
 
@@ -298,7 +343,7 @@ double GasPerfeito::vM_(double T, double P, double xv){
   \param P Presso em Pa
   \return Volume especfico do ar seco em \f$m^3/kg\f$
 */
-double GasPerfeito::v_a_(double T, double P){
+double GasPerfeito::v_a_(double T, double P, int *) const{
   return R*T/(P*Ma);
 }
 
@@ -308,7 +353,7 @@ double GasPerfeito::v_a_(double T, double P){
   \param P Presso em Pa
   \return Densidade do ar seco em \f$kg/m^3\f$
 */
-double GasPerfeito::r_a_(double T, double P){
+double GasPerfeito::r_a_(double T, double P, int *) const{
   return 1/v_a_(T,P);
 }
 
@@ -318,7 +363,7 @@ double GasPerfeito::r_a_(double T, double P){
   \param P Presso em Pa
   \return Volume molar do ar seco em \f$m^3/kmol\f$
 */
-double GasPerfeito::vM_a_(double T, double P){
+double GasPerfeito::vM_a_(double T, double P, int *) const{
   return R*T/P;
 }
 
@@ -327,7 +372,7 @@ double GasPerfeito::vM_a_(double T, double P){
   \param T Temperatura em K
   \return Volume especfico em \f$m^3/kg\f$
 */
-double GasPerfeito::v_v_(double T){
+double GasPerfeito::v_v_(double T, int *) const{
   double P = Pws(T);
   return R*T/(P*Mv);
 }
@@ -336,7 +381,7 @@ double GasPerfeito::v_v_(double T){
   \param T Temperatura em K
   \return Densidade em \f$kg/m^3\f$
 */
-double GasPerfeito::r_v_(double T){
+double GasPerfeito::r_v_(double T, int *) const{
   return 1/v_v_(T);
 }
 
@@ -344,7 +389,7 @@ double GasPerfeito::r_v_(double T){
   \param T Temperatura em K
   \return Volume  em \f$m^3/kmol\f$
 */
-double GasPerfeito::vM_v_(double T){
+double GasPerfeito::vM_v_(double T, int *) const{
   return R*T/Pws(T);
 }
 
@@ -354,9 +399,8 @@ double GasPerfeito::vM_v_(double T){
   \param Tk Temperatura em K
   return Volume especfico em \f$m^3\f$
 */
-double GasPerfeito::v_l_(double Tk){
-  return 1/r_l_(Tk);
-  
+double GasPerfeito::v_l_(double Tk) const{
+  return Kernel<GasPerfeito>::v_l_(*this, Tk);
 }
 
 /*! Densidade da gua lquida saturada para  273.15 < Tk < 473.15. Correlao retirada de 
@@ -366,21 +410,15 @@ R. W. Hyland e A. Wexler, Formulations for the Thermodynamic properties of the s
 \param Tk Temperatura em K
 \return Densidade em \f$kg/m^3\f$
 */
-double GasPerfeito::r_l_(double Tk){
-  double termo1 = -0.2403360201e4 - 0.140758895e1*Tk + 0.1068287657e0*Tk*Tk -
-    0.2914492351e-3*pow(Tk,3) + 0.373497936e-6*pow(Tk,4) - 0.21203787e-9*pow(Tk,5);
-
-  double termo2 =  -0.3424442728e1 + 0.1619785e-1*Tk;
-
-  return termo1 / termo2;
-
+double GasPerfeito::r_l_(double Tk) const{
+  return GasPerfeitoCorrelations::r_l(Tk);
 }
 
 /*! Volume molar da gua lquida saturada, 273.15 < T < 473.15
   \param T Temperatura em K
   \return Volume molar em \f$m^3/kmol\f$
 */
-double GasPerfeito::vM_l_(double T){
+double GasPerfeito::vM_l_(double T) const{
   return v_l_(T) * Mv;
 }
 
@@ -391,17 +429,15 @@ R. W. Hyland e A. Wexler, Formulations for the Thermodynamic properties of the s
 \param Tk Temperatura em K
 \return Volume especfico em \f$m^3/kg\f$
 */
-double GasPerfeito::v_s_(double Tk){
-
-  return 0.1070003e-2 - 0.249936e-7*Tk + 0.371611e-9*Tk*Tk;
-
+double GasPerfeito::v_s_(double Tk) const{
+  return GasPerfeitoCorrelations::v_s(Tk);
 }
 
 /*! Volume molar do gelo saturado, 173.15 < T < 273.15
 \param T Temperatura em K
 \return Volume molar em \f$m^3/kmol\f$
 */
-double GasPerfeito::vM_s_(double T){
+double GasPerfeito::vM_s_(double T) const{
   return v_s_(T) * Mv;
 }
 
@@ -409,7 +445,7 @@ double GasPerfeito::vM_s_(double T){
 \param Tk Temperatura em K
 \return Densidade em \f$kg/m^3\f$
 */
-double GasPerfeito::r_s_(double Tk){
+double GasPerfeito::r_s_(double Tk) const{
   return 1/v_s_(Tk);
 }
 
@@ -418,11 +454,37 @@ double GasPerfeito::r_s_(double Tk){
 \param Tk Temperatura em K
 \return Volume especfico em \f$m^3/kg\f$
 */
-double GasPerfeito::v_f_(double Tk){
-  if (Tk < 273.15)
-    return v_s_(Tk);
-  else
-    return v_l_(Tk);
+double GasPerfeito::v_f_(double Tk) const{
+  return Kernel<GasPerfeito>::v_f_(*this, Tk);
+}
+
+/*! Volume especfico da fase condensada de n temperaturas (ver v_f_), vrias de cada vez. As expresses do gelo e da gua so avaliadas e selecionadas por mscara. Se a verso vetorial no corresponder ao tipo dinmico (ver nativeBatch), cada temperatura  calculada por v_f_.
+\param n Nmero de temperaturas
+\param T Temperaturas em K
+\param v Recebe os volumes especficos em \f$m^3/kg\f$
+*/
+PSYCHRO_NOINLINE void GasPerfeito::vfBatch(size_t n, const double *T, double *v) const{
+  if (!nativeBatch()){
+    for (size_t i = 0; i < n; ++i) v[i] = v_f_(T[i]);
+    return;
+  }
+
+  PSYCHRO_SIMD_DISPATCH(vfLanes, n, T, v);
+}
+
+/// vfBatch com o vetor V (ver PSYCHRO_SIMD_DISPATCH)
+template<class V>
+void GasPerfeito::vfLanes(size_t n, const double *T, double *v) const{
+  typedef typename vtraits<V>::mask M;
+  const size_t L = vtraits<V>::L;
+  for (size_t i = 0; i < n; i += L){
+    size_t m = (n - i < L) ? n - i : L;
+    V Tk = (m == L) ? vload<V>(T+i) : vload_tail<V>(T+i, m);
+    V vf = vselect((M)(Tk < 273.15), GasPerfeitoCorrelations::v_s(Tk),
+		   1.0/GasPerfeitoCorrelations::r_l(Tk));
+    if (m == L) vstore(v+i, vf);
+    else vstore_tail(v+i, vf, m);
+  }
 }
 
 
@@ -430,7 +492,7 @@ double GasPerfeito::v_f_(double Tk){
 \param Tk Temperatura em K
 \return Volume molar em \f$m^3/kmol\f$
 */
-double GasPerfeito::vM_f_(double T){
+double GasPerfeito::vM_f_(double T) const{
   return v_f_(T) * Mv;
 }
 
@@ -438,121 +500,217 @@ double GasPerfeito::vM_f_(double T){
 \param Tk Temperatura em K
 \return Densidade em \f$kg/m^3\f$
 */
-double GasPerfeito::r_f_(double Tk){
+double GasPerfeito::r_f_(double Tk) const{
   return 1/v_f_(Tk);
 }
 
 
-/*! Definio do ar mido. Este funo especifica o ar mido. Novas funes podem ser criadas para fazerem as tarefas desta funo. Atualmente, esta funo tem quatro argumentos e no final calcula o teor de umidade (kg_vapor / kg_arseco) e a frao molar de vapor. Observe que com estes parmetros e as funes definidas acima  possvel calcular qualquer outro parmetro de interesse, ou seja, o estado do ar est especificado.
+/*! Definio do ar mido. Este funo especifica o ar mido sem modificar o objeto: o estado  devolvido em uma estrutura MoistAirState. Novas funes podem ser criadas para fazerem as tarefas desta funo. Atualmente, esta funo tem quatro argumentos e no final calcula o teor de umidade (kg_vapor / kg_arseco) e a frao molar de vapor. Observe que com estes parmetros e as funes definidas acima  possvel calcular qualquer outro parmetro de interesse, ou seja, o estado do ar est especificado.
 
 \param T Temperatura do ar em K, temperatura de bulbo seco (TBS)
 \param ch Character que determina como a umidade ser especificada. No momento pode ser 'R' para umidade relativa, 'W' para o teor de umidade, 'D' para a temperatura de ponto de orvalho, 'B' para a temperatura de bulbo mido e 'X' para a frao molar de vapor. Outros parmetros, no futuro, podem ser includos.
 \param umidade A umidade do ar mido. Vai depender do que foi especificado em ch.
 \param P Presso do ar mido em Pa
 */
+MoistAirState GasPerfeito::state(double T, char ch, double umidade, double P) const{
+  if (nativeBatch()) return GasPerfeitoModel(*this).state(T, ch, umidade, P);
+  return Kernel<GasPerfeito>::state(*this, T, ch, umidade, P);
+}
+
+/*! Especifica a mistura ar-vapor partindo dos valores da amostra anterior de uma srie (ver SolverContext). O contexto c passa a ter o estado calculado como amostra anterior.
+ */
+MoistAirState GasPerfeito::state(double T, char ch, double umidade, double P, SolverContext &c) const{
+  if (nativeBatch()) return GasPerfeitoModel(*this).state(T, ch, umidade, P, c);
+  return Kernel<GasPerfeito>::state(*this, T, ch, umidade, P, &c);
+}
+
+/*! Verso da funo state que armazena a mistura no prprio objeto (XV, W, M e errorcode). Mantida por compatibilidade. Como modifica o objeto, no deve ser utilizada quando o mesmo modelo  compartilhado entre threads.
+
+\param T Temperatura do ar em K, temperatura de bulbo seco (TBS)
+\param ch Character que determina como a umidade ser especificada (ver state)
+\param umidade A umidade do ar mido. Vai depender do que foi especificado em ch.
+\param P Presso do ar mido em Pa
+*/
 void GasPerfeito::set(double T, char ch, double umidade, double P){
-  // 
-  double B, Rel, D;
+  MoistAirState s = state(T, ch, umidade, P);
+  if (s.status) errorcode = s.status;
+  XV = s.xv;
+  W = s.W;
+  M = XV * Mv + (1.0 - XV) * Ma;
+}
 
-  // Verificar faixa de temperatura, caso d pau, usar 25oC
-  if (!FaixaT(T)){
-    errorcode = 10;
-  }
-  if (!FaixaP(P)){
-    errorcode = 11;
-  }
 
-  
-  double XSV;
-  switch(ch){
-  case 'X':			// Frao molar de vapor
-    XV = umidade;
-    // Verificar a faixa de frao molar
-    XSV = eFactor(T, P) * Pws(T) / P;
-    if (XV < 0.0 || XV > XSV) {
-      errorcode = 16;
-    }
-    W = Mv/Ma * XV/(1.0 - XV);
-    break;
-  case 'W':			// Teor de umidade
-    W = umidade;
-    XV = W / (Mv/Ma + W);
-    XSV = eFactor(T, P) * Pws(T) / P;
-    if (XV < 0.0 || XV > XSV) {
-      errorcode = 15;
-    }
-    
-    break;
-  case 'R':			// UMidade relativa
-    Rel = umidade;
-    if (Rel < 0.0){
-      errorcode = 12; Rel = 0.0;
-    }
-    XV = Rel * Pws(T) / P;
-    W = Mv/Ma * XV/(1.0 - XV);
-    break;
-    
-  case 'B':			// Temp. de bulbo mido
-    // A aproximao linear facilita mesmo estes clculos...
-    B = umidade;
-    double psat, w2, hs, hw;
-    if (B > T){
-      errorcode = 14; B = T;
-    }
-    psat = Pws(B);
-    w2 = Mv/Ma * psat / (P - psat);
-    hs = h_a_(B) + w2 * h_v_(B);
-    hw = h_f_(B);
-    W = (hs - h_a_(T) - w2 * hw) / (h_v_(T) - hw);
-    XV = W / (Mv/Ma + W);
-    
-    break;
-  case 'D':			// Ponto de orvalho
-    D = umidade;
-    if (D > T){
-      errorcode = 13; D = T;
-    }
-    XV = Pws(D)/P;
-    W = Mv/Ma * XV/(1.0 - XV);
-    break;
 
-  };
 
-  M = XV * Mv + (1.0 - XV) * Ma;
+/*! Volume especfico do ar mido por kg de ar seco. Calculado a partir da densidade da mistura: \f$ v = \frac{1 + \omega}{\rho(T,P)} \f$.
+\param s Estado do ar mido
+\param err Se no for nulo, recebe o cdigo de erro
+\return Volume especifico em \f$m^3/kg\f$ de ar seco.
+*/
+double GasPerfeito::VOLUME(const MoistAirState &s, int *err) const{
+  if (nativeBatch()) return GasPerfeitoModel(*this).VOLUME(s, err);
+  return Kernel<GasPerfeito>::VOLUME(*this, s, err);
+}
+
+
+/*! Densidade (ou massa especfica) do ar mido.
+
+\f$rho = P\cdot M / (R\cdot T) \f$
+
+\param s Estado do ar mido
+\param err Se no for nulo, recebe o cdigo de erro
+\return Densidade em \f$kg/m^3\f$
+ */
+double GasPerfeito::DENSITY(const MoistAirState &s, int *err) const{
+  if (nativeBatch()) return GasPerfeitoModel(*this).DENSITY(s, err);
+  return Kernel<GasPerfeito>::DENSITY(*this, s, err);
+}
 
 
+/*! Temperatura de ponto de orvalho do ar mido.
+\param s Estado do ar mido
+\param err Se no for nulo, recebe o cdigo de erro
+\return Temperatura de ponto de orvalho em K
+*/
+double GasPerfeito::DEWPOINT(const MoistAirState &s, int *err) const{
+  if (nativeBatch()) return GasPerfeitoModel(*this).DEWPOINT(s, err);
+  return Kernel<GasPerfeito>::DEWPOINT(*this, s, err);
 }
 
+/// Temperatura de ponto de orvalho do estado s partindo do valor da amostra anterior armazenado em c (ver SolverContext)
+double GasPerfeito::DEWPOINT(const MoistAirState &s, SolverContext &c, int *err) const{
+  if (nativeBatch()) return GasPerfeitoModel(*this).DEWPOINT(s, c, err);
+  return Kernel<GasPerfeito>::DEWPOINT(*this, s, err, &c);
+}
 
+/*! Entalpia do ar mido.
+\param s Estado do ar mido
+\param err Se no for nulo, recebe o cdigo de erro
+\return Entalpia em J/kg de ar seco
+*/
+double GasPerfeito::ENTHALPY(const MoistAirState &s, int *err) const{
+  if (nativeBatch()) return GasPerfeitoModel(*this).ENTHALPY(s, err);
+  return Kernel<GasPerfeito>::ENTHALPY(*this, s, err);
+}
 
+/*! Entropia do ar mido (ainda no implementado)
+\param s Estado do ar mido
+\param err Se no for nulo, recebe o cdigo de erro
+\return Entropia em J/kgK de ar seco
+*/
+double GasPerfeito::ENTROPY(const MoistAirState &, int *) const{
+  return 0;
+}
+
+/*! Umidade relativa do ar mido.
+\param s Estado do ar mido
+\param err Se no for nulo, recebe o cdigo de erro
+\return Umidade relativa
+*/
+double GasPerfeito::RELHUM(const MoistAirState &s, int *err) const{
+  if (nativeBatch()) return GasPerfeitoModel(*this).RELHUM(s, err);
+  return Kernel<GasPerfeito>::RELHUM(*this, s, err);
+}
 
-/*! Volume especfico do ar mido por kg de ar seco. Calculado a partir da densidade da mistura: \f$ v = \frac{1 + \omega}{\rho(T,P)} \f$.  interessante notar que usando a funo set, pode-se calcular o volume para diferentes temperaturas e presses, mas mesma composio do ar mido.
+/*! Propriedades selecionadas do estado s (ver Psychro::evaluate_all). O volume especfico  obtido da massa especfica; as demais propriedades do gs perfeito so explcitas ou quase, e so calculadas pelas funes de sada.
+\param s Estado do ar mido
+\param mask Propriedades calculadas (ver MoistAirProperty)
+\return Propriedades; as que no foram pedidas valem NaN. O cdigo de erro parte de s.status
+*/
+MoistAirProperties GasPerfeito::evaluate_all(const MoistAirState &s, unsigned mask) const{
+  if (nativeBatch()) return GasPerfeitoModel(*this).evaluate_all(s, mask);
+  return Kernel<GasPerfeito>::evaluate_all(*this, s, mask);
+}
+
+/*! Como evaluate_all, mas as propriedades j armazenadas em c para o estado s no so recalculadas (ver MoistAirCache).
+\param c Memria das propriedades
+\param s Estado do ar mido
+\param mask Propriedades pedidas (ver MoistAirProperty)
+\return Propriedades armazenadas em c
+*/
+const MoistAirProperties &GasPerfeito::evaluate(MoistAirCache &c, const MoistAirState &s, unsigned mask) const{
+  if (nativeBatch()) return GasPerfeitoModel(*this).evaluate(c, s, mask);
+  return Kernel<GasPerfeito>::evaluate(*this, c, s, mask);
+}
+
+/*! Temperatura de bulbo mido do ar mido. Esta funo  iterativa, utilizando o mtodo de Newton-Raphson com derivada analtica para calcular a temperatura de bulbo mido. A temperatura de bulbo mido  calculada a partir do balano de energia de um saturador adiabtico implementada na equao BcalcW.
+\param s Estado do ar mido
+\param err Se no for nulo, recebe o cdigo de erro
+\return Temperatura de bulbo mido em K
+*/
+double GasPerfeito::WETBULB(const MoistAirState &s, int *err) const{
+  if (nativeBatch()) return GasPerfeitoModel(*this).WETBULB(s, err);
+  return Kernel<GasPerfeito>::WETBULB(*this, s, err);
+}
+
+/// Temperatura de bulbo mido do estado s partindo do valor da amostra anterior armazenado em c (ver SolverContext)
+double GasPerfeito::WETBULB(const MoistAirState &s, SolverContext &c, int *err) const{
+  if (nativeBatch()) return GasPerfeitoModel(*this).WETBULB(s, c, err);
+  return Kernel<GasPerfeito>::WETBULB(*this, s, err, &c);
+}
+
+/*! Temperatura de bulbo mido de n estados (ver WETBULB). A iterao de Newton-Raphson sobre o balano de energia do saturador adiabtico (ver BcalcW)  feita em vtraits<V>::L estados simultaneamente por GasPerfeitoCorrelations::wetbulbLanes, com as entalpias lineares do gs perfeito e a presso de vapor de coefPwsLanes; o ramo do gelo ou da gua  selecionado elemento a elemento por mscara e os elementos que j convergiram ficam congelados. Fornece o valor inicial de Ashrae::WETBULBBatch (ver Ashrae::seedModel). Se a verso vetorial no corresponder ao tipo dinmico (ver nativeBatch), cada estado  calculado por WETBULB.
+\param n Nmero de estados
+\param T Temperaturas em K
+\param P Presses em Pa
+\param W Teores de umidade kg de vapor / kg de ar seco
+\param B Recebe as temperaturas de bulbo mido em K
+\param err Se no for nulo, err[i] recebe 100 se a iterao do estado i no convergiu (os demais elementos no so modificados)
+*/
+PSYCHRO_NOINLINE void GasPerfeito::WETBULBBatch(size_t n, const double *T, const double *P,
+						const double *W, double *B, int *err) const{
+  if (!nativeBatch()){
+    for (size_t i = 0; i < n; ++i){
+      MoistAirState s = {T[i], P[i], W[i] / (Mv/Ma + W[i]), W[i], 0};
+      B[i] = WETBULB(s, err ? err+i : 0);
+    }
+    return;
+  }
+
+  PSYCHRO_SIMD_DISPATCH(WETBULBLanes, n, T, P, W, B, err);
+}
+
+/// WETBULBBatch com o vetor V (ver PSYCHRO_SIMD_DISPATCH)
+template<class V>
+void GasPerfeito::WETBULBLanes(size_t n, const double *T, const double *P, const double *W,
+			       double *B, int *err) const{
+  typedef typename vtraits<V>::mask M;
+  const size_t L = vtraits<V>::L;
+
+  for (size_t i = 0; i < n; i += L){
+    size_t m = (n - i < L) ? n - i : L;
+    V Tk = (m == L) ? vload<V>(T+i) : vload_tail<V>(T+i, m);
+    V Pk = (m == L) ? vload<V>(P+i) : vload_tail<V>(P+i, m);
+    V wk = (m == L) ? vload<V>(W+i) : vload_tail<V>(W+i, m);
+    M active;
+    V b = GasPerfeitoCorrelations::wetbulbLanes(Tk, Pk, wk, tol.wetbulb, active);
+
+    if (m == L) vstore(B+i, b);
+    else vstore_tail(B+i, b, m);
+    if (err)
+      for (size_t j = 0; j < m; ++j)
+	if (active[j]) err[i+j] = 100;
+  }
+}
+
+
+/*! Volume especfico do ar mido por kg de ar seco.  interessante notar que usando a funo set, pode-se calcular o volume para diferentes temperaturas e presses, mas mesma composio do ar mido.
 \param T Temperatura em K
 \param P Presso em Pa
 \return Volume especifico em \f$m^3/kg\f$ de ar seco.
 */
 double GasPerfeito::VOLUME(double T, double P){
-  if (!FaixaT(T)) {errorcode=10; T = 293.15;}
-  if (!FaixaT(P)) {errorcode=11; P = 101325.0;}
-  
-  return (1.0+W) / DENSITY(T,P);
+  return cached(T, P, PROP_VOLUME).volume;
 }
 
 
 /*! Densidade (ou massa especfica) do ar mido. Aps especificar uma mistura ar-vapor, pode-se calcular para qualquer temperatura ou presso na faixa de aplicao do modelo.
-
-\f$rho = P\cdot M / (R\cdot T) \f$
-
-
 \param T Temperatura em K
 \param P Presso em Pa
 \return Densidade em \f$kg/m^3\f$
  */
 double GasPerfeito::DENSITY(double T, double P){
-  if (!FaixaT(T)) {errorcode=10;}
-  if (!FaixaT(P)) {errorcode=11;}
-  // Calcula a massa especfica do ar mido
-  return P * M / (R*T);
+  return cached(T, P, PROP_DENSITY).density;
 }
     
 /*! Calcula o teor de umidade.
@@ -578,10 +736,7 @@ double GasPerfeito::MOLFRAC(){
 \return Temperatura de ponto de orvalho em K
 */
 double GasPerfeito::DEWPOINT(double T, double P){
-  // Ponto de orvalho
-  if (!FaixaT(T)) {errorcode=10;}
-  if (!FaixaT(P)) {errorcode=11;}
-  return Tws(XV * P);
+  return cached(T, P, PROP_DEWPOINT).dewpoint;
 }
 
 /*! Calcula a entalpia de uma mistura ar-vapor para diferentes presses e temperaturas
@@ -590,10 +745,7 @@ double GasPerfeito::DEWPOINT(double T, double P){
 \return Entalpia em J/kg de ar seco
 */
 double GasPerfeito::ENTHALPY(double T, double P){
-  // Ponto de orvalho
-  if (!FaixaT(T)) {errorcode=10;}
-  if (!FaixaT(P)) {errorcode=11;}
-  return h_(T, XV)*(1.0 + W);
+  return cached(T, P, PROP_ENTHALPY).enthalpy;
 }
 
 /*! Calcula a entropia de uma mistura ar-vapor para diferentes presses e temperaturas
@@ -602,10 +754,7 @@ double GasPerfeito::ENTHALPY(double T, double P){
 \return Entropia em J/kgK de ar seco
 */
 double GasPerfeito::ENTROPY(double T, double P){
-  // Ponto de orvalho
-  if (!FaixaT(T)) {errorcode=10;}
-  if (!FaixaT(P)) {errorcode=11;}
-  return 0;
+  return ENTROPY(current(T, P), &errorcode);
 }
 
 /*! Calcula a umidade relativa de uma mistura ar-vapor para diferentes presses e temperaturas
@@ -614,10 +763,7 @@ double GasPerfeito::ENTROPY(double T, double P){
 \return Umidade relativa
 */
 double GasPerfeito::RELHUM(double T, double P){
-  // Umidade relativa
-  if (!FaixaT(T)) {errorcode=10;}
-  if (!FaixaT(P)) {errorcode=11;}
-  return XV*P/Pws(T);
+  return cached(T, P, PROP_RELHUM).relhum;
 }
 
 
@@ -629,47 +775,84 @@ double GasPerfeito::RELHUM(double T, double P){
 \param b Estimativa da temperatura de bulbo mido em K
 \param P Presso em Pa
 \param T Temperatura em K
+\param w Teor de umidade do ar mido
+\param df Se no for nulo, recebe a derivada do balano em relao a b (com os calores especficos dh_a_, dh_v_ e dh_f_ do modelo)
 \return O quanto no h balano de energia no saturador adiabtico para a estimativ b da temperatura de bulbo mido
 */
-double GasPerfeito::BcalcW(double b, double P, double T){
-  // Calcular w2
-  double w2 = Mv / Ma * Pws(b) / (P - Pws(b));
-
-  return -W*(h_v_(T) - h_f_(b)) + h_a_(b) - h_a_(T) + w2*(h_v_(b) - h_f_(b));
+double GasPerfeito::BcalcW(double b, double P, double T, double w, double *df) const{
+  return Kernel<GasPerfeito>::BcalcW(*this, b, P, T, w, df);
 }
 
 
     
   
-/*! Funo para clculo da temperatura de bulbo mido de uma mistura ar-vapor com composio conhecida a diferentes presses e temperaturas. Esta funo  iterativa, utilizando o mtodo de Newton-Raphson para calcular a temperatura de bulbo mido. A temperatura de bulbo mido  calculada a partir do balano de energia de um saturador adiabtico implementada na equao BcalcW.
+/*! Funo para clculo da temperatura de bulbo mido de uma mistura ar-vapor com composio conhecida a diferentes presses e temperaturas.
 \param T Temperatura em K
 \param P Presso em Pa
 \return Temperatura de bulbo mido em K
 */
 double GasPerfeito::WETBULB(double T, double P){
-  // Temperatura de bulbo mido
-  if (!FaixaT(T)) {errorcode=10;}
-  if (!FaixaT(P)) {errorcode=11;}
-
-  // Chute inicial
-  double b = T - 1.0, db;
-  double f, df;
-  const double EPS=1e-7;
-  const int NMAX = 100;
-  for (int iter = 0; iter < NMAX; ++iter){
-    f = BcalcW(b, P, T);
-    df = (BcalcW(b+0.0001,P, T)-f) / 0.0001;
-    db = - f / df;
-    b = b + db;
-    if (fabs(db) < EPS) return b;
-  }
-
-  errorcode = 100;		// No convergiu no nmero de etapas certas, erro
-  return(b);
+  return cached(T, P, PROP_WETBULB).wetbulb;
 }
       
     
   
+/*! Clculo em lote das propriedades do ar mido. As entradas so colunas com n elementos.
+\param n Nmero de amostras
+\param ch Tipo de umidade ('R', 'W', 'D', 'B' ou 'X', ver set)
+\param T Temperaturas em K
+\param umidade Umidades
+\param P Presses em Pa
+\param out Colunas de sada (ponteiros nulos no so calculados)
+*/
+void GasPerfeito::batch(size_t n, char ch, const double *T, const double *umidade,
+			const double *P, const MoistAirColumns &out) const{
+  batch_eval(*this, n, ch, T, umidade, P, out);
+}
+
+/*! Clculo em lote com entradas e sadas em float (ver Psychro::batchFloat). As amostras so processadas em blocos: as entradas de cada bloco so convertidas para double (converso exata), calculadas por batch e os resultados so arredondados para float. O resultado de cada propriedade difere do de batch com as mesmas entradas por no mximo meio ULP de float; o tempo de clculo  o de batch. As correlaes de GasPerfeito so explcitas (apenas o bulbo mido  iterativo) e baratas em double, e esta  tambm a verso das classes derivadas cujas correlaes as verses vetoriais no reproduzem (ver nativeBatch). Ashrae e Giacomo redefinem esta funo com o clculo em float (ver Ashrae::batchFloat).
+\param n Nmero de amostras
+\param ch Tipo de umidade ('R', 'W', 'D', 'B' ou 'X', ver set)
+\param T Temperaturas em K
+\param umidade Umidades
+\param P Presses em Pa
+\param out Colunas de sada (ponteiros nulos no so calculados)
+*/
+void GasPerfeito::batchFloat(size_t n, char ch, const float *T, const float *umidade,
+			     const float *P, const MoistAirColumnsF &out) const{
+  batch_float_eval(*this, n, ch, T, umidade, P, out);
+}
+
+
+/*! Indica se as verses vetoriais das funes em lote (PwsBatch, TwsBatch, ZBatch, ..., ver PSYCHRO_SIMD_DISPATCH em vecmath.h) reproduzem as correlaes escalares do tipo dinmico do objeto. As verses vetoriais reescrevem as correlaes de cada modelo, portanto isto s  garantido para os prprios modelos da biblioteca: uma classe derivada que redefine uma correlao (Pws, Z, h_f_, ...) teria resultados diferentes no clculo em lote e nas funes escalares. Quando esta funo retorna false, as funes em lote aplicam as funes escalares (virtuais) a cada elemento e batch e gridRow calculam cada amostra com state e evaluate_all (ver batch_eval). Quando retorna true, as funes de sada escalares (state, WETBULB, evaluate_all, ...) utilizam o modelo composto estaticamente (GasPerfeitoModel, AshraeStatic ou GiacomoStatic, ver models.h), em que as correlaes so expandidas nas iteraes; caso contrrio, as funes virtuais.
+
+Uma classe derivada que no redefine nenhuma correlao pode redefinir esta funo para retornar true. Uma que redefine tambm as verses em lote e as funes de sada de todas as que modifica (como Giacomo) tambm pode.
+\return true se o tipo dinmico  GasPerfeito
+*/
+bool GasPerfeito::nativeBatch() const{
+  return typeid(*this) == typeid(GasPerfeito);
+}
+
+
+/*! Malha de presses e umidades na temperatura T (ver grid_eval). A presso de saturao em T  calculada uma nica vez. Se as correlaes do tipo dinmico no forem as de GasPerfeito (ver nativeBatch), cada ponto  calculado com state e evaluate_all (ver grid_row_eval).
+\param T Temperatura em K
+\param nP Nmero de presses
+\param P Presses em Pa
+\param ch Tipo de umidade ('R', 'W', 'D', 'B' ou 'X', ver set)
+\param nU Nmero de umidades
+\param umidade Umidades
+\param out Colunas de sada com nP*nU elementos; o ponto (j, k)  o elemento j*nU + k
+*/
+void GasPerfeito::gridRow(double T, size_t nP, const double *P, char ch, size_t nU,
+			  const double *umidade, const MoistAirColumns &out) const{
+  if (!nativeBatch()){
+    grid_row_eval(*this, T, nP, P, ch, nU, umidade, out);
+    return;
+  }
+  GasPerfeitoModel(*this).gridRow(T, nP, P, ch, nU, umidade, out);
+}
+
+
 int GasPerfeito::ERROR(){
   return errorcode;
 }
@@ -7,7 +7,14 @@ Este arquivo possui as reimplementa
 */
 
 #include <cmath>
+#include <typeinfo>
 #include <psychro/psychro.h>
+#include <psychro/models.h>
+
+#if defined(__GNUC__)
+// As funes vetoriais deste arquivo retornam os vetores de 4 e 8 elementos (ver vecmath.h)
+#pragma GCC diagnostic ignored "-Wpsabi"
+#endif
 
  
 using namespace std;
@@ -18,21 +25,36 @@ using namespace std;
 \param xv Frao molar de vapor
 \return Fator de compressibilidade
 */
-double Giacomo::Z(double T, double P, double xv){
+double Giacomo::Z(double T, double P, double xv, int *) const{
+  return GiacomoCorrelations::Z(T, P, xv);
+}
 
-  double t = T - 273.15;
-  double a0 = 1.62419e-6;
-  double a1 = -2.8969e-8;
-  double a2 = 1.0880e-10;
-  double b0 = 5.757e-6;
-  double b1 = -2.589e-8;
-  double c0 = 1.9297e-4;
-  double c1 = -2.285e-6;
-  double d = 1.73e-11;
-  double e = -1.034e-8;
+/*! Volume molar da mistura. A compressibilidade de Giacomo no utiliza os coeficientes viriais: v  ignorado e o resultado  o de vM_.
+\param v Coeficientes viriais (no utilizados)
+\param T Temperatura K
+\param P Presso Pa
+\param xv Frao molar de vapor
+\return Volume molar \f$m^3/kmol\f$
+*/
+double Giacomo::vMfromVirial(const VirialSet &v, double T, double P, double xv, int *err) const{
+  return GiacomoZ::vMfromVirial(*this, v, T, P, xv, err);
+}
 
-  return 1.0 - P/T * (a0 + a1*t + a2*t*t + (b0 + b1*t)*xv +
-		      (c0 + c1*t)*xv*xv) + P*P/(T*T)*(d + e*xv*xv);
+
+/*! Compressibilidade de n estados. Como a correlao  explcita, basta aplic-la a cada estado; o lao  vetorizado pelo compilador. Numa classe derivada (ver nativeBatch) cada estado  calculado pela funo Z redefinida.
+\param n Nmero de estados
+\param T Temperaturas K
+\param P Presses Pa
+\param xv Fraes molares de vapor
+\param Z Recebe as compressibilidades
+\param err No utilizado: a correlao no tem erro de convergncia
+*/
+void Giacomo::ZBatch(size_t n, const double *T, const double *P, const double *xv,
+		     double *Z, int *err) const{
+  if (!nativeBatch())
+    for (size_t i = 0; i < n; ++i) Z[i] = this->Z(T[i], P[i], xv[i], err ? err+i : 0);
+  else
+    for (size_t i = 0; i < n; ++i) Z[i] = Giacomo::Z(T[i], P[i], xv[i]);
 }
 
 
@@ -43,14 +65,88 @@ double Giacomo::Z(double T, double P, double xv){
 \param T Temperatura em K
 \return Presso de saturao em Pa
 */
-double Giacomo::Pws(double T){
+double Giacomo::Pws(double T, int *) const{
+  return GiacomoCorrelations::Pws(T);
+}
+
+/*! Derivada da presso de vapor de saturao
+\param T Temperatura em K
+\return dP/dT em Pa/K
+*/
+double Giacomo::dPws(double T) const{
+  return GiacomoPws::dPws(*this, T);
+}
+
+/*! Presso de vapor de saturao e sua derivada
+\param T Temperatura em K
+\param dP Recebe dP/dT em Pa/K
+\return Presso de saturao em Pa
+*/
+double Giacomo::PwsdPws(double T, double &dP) const{
+  return GiacomoPws::PwsdPws(*this, T, dP);
+}
 
-  double A = 1.2811805e-5;
-  double B = -1.9509874e-2;
-  double C = 34.04926034;
-  double D = -6.3536311e3;
+/*! Presso de vapor de saturao de n temperaturas, vrias de cada vez (ver vecmath.h). Numa classe derivada (ver nativeBatch) cada temperatura  calculada por Pws.
+\param n Nmero de temperaturas
+\param T Temperaturas em K
+\param p Recebe as presses em Pa
+*/
+PSYCHRO_NOINLINE void Giacomo::PwsBatch(size_t n, const double *T, double *p) const{
+  if (!nativeBatch()){
+    for (size_t i = 0; i < n; ++i) p[i] = Pws(T[i]);
+    return;
+  }
+
+  PSYCHRO_SIMD_DISPATCH(PwsLanes, n, T, p);
+}
+
+/// PwsBatch com o vetor V (ver PSYCHRO_SIMD_DISPATCH)
+template<class V>
+void Giacomo::PwsLanes(size_t n, const double *T, double *p) const{
+  const size_t L = vtraits<V>::L;
+  size_t i = 0;
+  for (; i + L <= n; i += L){
+    V Tk = vload<V>(T+i);
+    vstore(p+i, GiacomoCorrelations::Pws(Tk));
+  }
+  if (i < n){
+    V Tk = vload_tail<V>(T+i, n-i);
+    vstore_tail(p+i, GiacomoCorrelations::Pws(Tk), n-i);
+  }
+}
+
+/*! Presso de vapor de saturao e sua derivada de n temperaturas (ver PwsdPws). Numa classe derivada (ver nativeBatch) cada temperatura  calculada por PwsdPws.
+\param n Nmero de temperaturas
+\param T Temperaturas em K
+\param p Recebe as presses em Pa
+\param dp Recebe dP/dT em Pa/K
+*/
+PSYCHRO_NOINLINE void Giacomo::PwsdPwsBatch(size_t n, const double *T, double *p, double *dp) const{
+  if (!nativeBatch()){
+    for (size_t i = 0; i < n; ++i) p[i] = PwsdPws(T[i], dp[i]);
+    return;
+  }
 
-  return exp(A*T*T + B*T + C + D/T);
+  PSYCHRO_SIMD_DISPATCH(PwsdPwsLanes, n, T, p, dp);
+}
+
+/// PwsdPwsBatch com o vetor V (ver PSYCHRO_SIMD_DISPATCH)
+template<class V>
+void Giacomo::PwsdPwsLanes(size_t n, const double *T, double *p, double *dp) const{
+  const size_t L = vtraits<V>::L;
+  for (size_t i = 0; i < n; i += L){
+    size_t m = (n - i < L) ? n - i : L;
+    V Tk = (m == L) ? vload<V>(T+i) : vload_tail<V>(T+i, m);
+    V P = GiacomoCorrelations::Pws(Tk);
+    V dP = P * GiacomoCorrelations::dlnPws(Tk);
+    if (m == L){
+      vstore(p+i, P);
+      vstore(dp+i, dP);
+    }else{
+      vstore_tail(p+i, P, m);
+      vstore_tail(dp+i, dP, m);
+    }
+  }
 }
 
 /*! Enhancement factor para presses entre 60 e 110 kPa e temperaturas entre 0 e 30oC
@@ -58,17 +154,134 @@ double Giacomo::Pws(double T){
 \param P Presso Pa
 \return Enhancement factor
 */
-double Giacomo::eFactor(double T, double P){
+double Giacomo::eFactor(double T, double P) const{
+  return GiacomoCorrelations::eFactor(T, P);
+}
+
+/*! Enhancement factor. Como a correlao de Giacomo  explcita, apenas a temperatura de sp  utilizada.
+\param sp Grandezas de saturao
+\param P Presso Pa
+\return Enhancement factor
+*/
+double Giacomo::eFactor(const SaturationPoint &sp, double P, int *) const{
+  return GiacomoEFactor::eFactor(*this, sp, P, 1.0, 0);
+}
+
+/// Enhancement factor: a correlao  explcita, f0 no  utilizado e no h erro de convergncia
+double Giacomo::eFactor(const SaturationPoint &sp, double P, double f0, int *err) const{
+  return GiacomoEFactor::eFactor(*this, sp, P, f0, err);
+}
+
+/*! Enhancement factor de n estados (ver eFactor). Numa classe derivada (ver nativeBatch)  utilizada a verso de Ashrae, que aplica as funes eFactor redefinidas a cada estado.
+\param n Nmero de estados
+\param T Temperaturas K
+\param P Presses Pa
+\param f Recebe os enhancement factors
+\param err No utilizado: a correlao  explcita
+*/
+void Giacomo::eFactorBatch(size_t n, const double *T, const double *P, double *f,
+			   int *err) const{
+  if (!nativeBatch())
+    Ashrae::eFactorBatch(n, T, P, f, err);
+  else
+    for (size_t i = 0; i < n; ++i) f[i] = Giacomo::eFactor(T[i], P[i]);
+}
+
+
+/*! As verses vetoriais das funes em lote (as de Giacomo e as herdadas de Ashrae) reproduzem as correlaes do tipo dinmico? Ver GasPerfeito::nativeBatch.
+\return true se o tipo dinmico  Giacomo
+*/
+bool Giacomo::nativeBatch() const{
+  return typeid(*this) == typeid(Giacomo);
+}
+
+
+/*! Especifica a mistura ar-vapor sem modificar o objeto (ver Ashrae::state). Esta e as demais funes de sada utilizam o modelo esttico GiacomoStatic (ver models.h) quando o tipo dinmico  Giacomo; numa classe derivada (ver nativeBatch) so as de Ashrae, com as correlaes redefinidas.
+ */
+MoistAirState Giacomo::state(double T, char ch, double umidade, double P) const{
+  if (nativeBatch()) return GiacomoStatic(*this).state(T, ch, umidade, P);
+  return Ashrae::state(T, ch, umidade, P);
+}
+
+MoistAirState Giacomo::state(double T, char ch, double umidade, double P, SolverContext &c) const{
+  if (nativeBatch()) return GiacomoStatic(*this).state(T, ch, umidade, P, c);
+  return Ashrae::state(T, ch, umidade, P, c);
+}
+
+double Giacomo::ENTHALPY(const MoistAirState &s, int *err) const{
+  if (nativeBatch()) return GiacomoStatic(*this).ENTHALPY(s, err);
+  return Ashrae::ENTHALPY(s, err);
+}
+
+double Giacomo::VOLUME(const MoistAirState &s, int *err) const{
+  if (nativeBatch()) return GiacomoStatic(*this).VOLUME(s, err);
+  return Ashrae::VOLUME(s, err);
+}
 
-  double alfa = 1.00062;
-  double beta = 3.14e-8;
-  double gama = 5.6e-7;
+double Giacomo::DENSITY(const MoistAirState &s, int *err) const{
+  if (nativeBatch()) return GiacomoStatic(*this).DENSITY(s, err);
+  return Ashrae::DENSITY(s, err);
+}
 
-  double t = T - 273.15;
+double Giacomo::WETBULB(const MoistAirState &s, int *err) const{
+  if (nativeBatch()) return GiacomoStatic(*this).WETBULB(s, err);
+  return Ashrae::WETBULB(s, err);
+}
 
-  return(alfa + beta*P + gama*t*t);
+double Giacomo::WETBULB(const MoistAirState &s, SolverContext &c, int *err) const{
+  if (nativeBatch()) return GiacomoStatic(*this).WETBULB(s, c, err);
+  return Ashrae::WETBULB(s, c, err);
 }
 
+double Giacomo::DEWPOINT(const MoistAirState &s, int *err) const{
+  if (nativeBatch()) return GiacomoStatic(*this).DEWPOINT(s, err);
+  return Ashrae::DEWPOINT(s, err);
+}
 
+double Giacomo::DEWPOINT(const MoistAirState &s, SolverContext &c, int *err) const{
+  if (nativeBatch()) return GiacomoStatic(*this).DEWPOINT(s, c, err);
+  return Ashrae::DEWPOINT(s, c, err);
+}
 
+double Giacomo::RELHUM(const MoistAirState &s, int *err) const{
+  if (nativeBatch()) return GiacomoStatic(*this).RELHUM(s, err);
+  return Ashrae::RELHUM(s, err);
+}
+
+MoistAirProperties Giacomo::evaluate_all(const MoistAirState &s, unsigned mask) const{
+  if (nativeBatch()) return GiacomoStatic(*this).evaluate_all(s, mask);
+  return Ashrae::evaluate_all(s, mask);
+}
 
+const MoistAirProperties &Giacomo::evaluate(MoistAirCache &c, const MoistAirState &s, unsigned mask) const{
+  if (nativeBatch()) return GiacomoStatic(*this).evaluate(c, s, mask);
+  return Ashrae::evaluate(c, s, mask);
+}
+
+/// Malha de presses e umidades na temperatura T (ver Ashrae::gridRow) com o modelo esttico GiacomoStatic
+void Giacomo::gridRow(double T, size_t nP, const double *P, char ch, size_t nU,
+		      const double *umidade, const MoistAirColumns &out) const{
+  if (!nativeBatch()){
+    Ashrae::gridRow(T, nP, P, ch, nU, umidade, out);
+    return;
+  }
+  gridRowModel(GiacomoStatic(*this), T, nP, P, ch, nU, umidade, out);
+}
+
+/// Clculo em lote em float (ver Ashrae::batchFloat) com o modelo esttico GiacomoStatic
+void Giacomo::batchFloat(size_t n, char ch, const float *T, const float *umidade,
+			 const float *P, const MoistAirColumnsF &out) const{
+  if (!nativeBatch()){
+    Ashrae::batchFloat(n, ch, T, umidade, P, out);
+    return;
+  }
+  batchFloatModel(GiacomoStatic(*this), n, ch, T, umidade, P, out);
+}
+
+
+/*! Pws e eFactor so explcitas e no consultam as tabelas: fastMode s ajusta as de Tws
+\return FAST_TWS
+*/
+unsigned Giacomo::fastTables() const{
+  return FAST_TWS;
+}
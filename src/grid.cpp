@@ -0,0 +1,82 @@
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <system_error>
+
+#include <psychro/psychro.h>
+
+
+using namespace std;
+
+
+/*! Estado compartilhado entre as threads de grid_eval
+ */
+struct GridWork{
+  const Psychro *m;
+  size_t nT, nP, nU;
+  const double *T, *P, *umidade;
+  char ch;
+  MoistAirColumns out;
+  /// Prximo plano de temperatura
+  atomic<size_t> next;
+
+  void run(){
+    size_t plano = nP * nU;
+    for (size_t i = next++; i < nT; i = next++)
+      m->gridRow(T[i], nP, P, ch, nU, umidade, out.shift(i * plano));
+  }
+};
+
+
+/*! Propriedades em todos os pontos de uma malha retangular T  P  umidade, como na construo de cartas psicromtricas, tabelas e estudos de sensibilidade. O ponto (i, j, k), com temperatura T[i], presso P[j] e umidade umidade[k],  o elemento (i*nP + j)*nU + k das colunas de out.
+
+Cada plano de temperatura  calculado por Psychro::gridRow, que calcula uma nica vez as grandezas que dependem apenas da temperatura (em Ashrae a presso de vapor, o volume molar e a compressibilidade da fase condensada, a constante de Henry e os coeficientes viriais, alm do enhancement factor uma vez por presso) e percorre as presses e umidades em sequncia, escrevendo um bloco contguo de out. Os resultados so os mesmos de Psychro::batch aplicado aos pontos da malha, a menos do arredondamento.
+
+Os planos so distribudos entre as threads um de cada vez, por um contador atmico (ver parallel_batch); a thread que chama tambm calcula.
+
+\param m Modelo utilizado
+\param nT Nmero de temperaturas
+\param T Temperaturas em K
+\param nP Nmero de presses
+\param P Presses em Pa
+\param ch Tipo de umidade ('R', 'W', 'D', 'B' ou 'X', ver Psychro::set)
+\param nU Nmero de umidades
+\param umidade Umidades
+\param out Colunas de sada com nT*nP*nU elementos (ponteiros nulos no so calculados)
+\param opt Nmero de threads (os demais campos no so utilizados)
+\return Nmero de threads utilizadas
+*/
+int grid_eval(const Psychro &m, size_t nT, const double *T, size_t nP, const double *P,
+	      char ch, size_t nU, const double *umidade, const MoistAirColumns &out,
+	      const ParallelOptions &opt){
+  unsigned nt = opt.threads;
+  if (nt == 0) nt = thread::hardware_concurrency();
+  if (nt == 0) nt = 1;
+  if (nt > nT) nt = nT ? (unsigned) nT : 1;
+
+  GridWork w;
+  w.m = &m;
+  w.nT = nT;
+  w.nP = nP;
+  w.nU = nU;
+  w.T = T;
+  w.P = P;
+  w.umidade = umidade;
+  w.ch = ch;
+  w.out = out;
+  w.next = 0;
+
+  vector<thread> pool;
+  pool.reserve(nt - 1);
+  for (unsigned k = 1; k < nt; ++k){
+    try{
+      pool.push_back(thread(&GridWork::run, &w));
+    }catch(const system_error &){
+      break;
+    }
+  }
+
+  w.run();
+  for (size_t k = 0; k < pool.size(); ++k) pool[k].join();
+  return (int) pool.size() + 1;
+}
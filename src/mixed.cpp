@@ -0,0 +1,105 @@
+#include <vector>
+
+#include <psychro/psychro.h>
+
+
+using namespace std;
+
+
+/*! Agrupa as n amostras pelo tipo de umidade (ordenao por contagem, estvel)
+\param n Nmero de amostras
+\param ch Tipo de umidade de cada amostra
+*/
+void KindBuckets::build(size_t n, const char *ch){
+  size_t pos[NKIND] = {0};
+  for (size_t i = 0; i < n; ++i) ++pos[index(ch[i])];
+
+  start[0] = 0;
+  for (int k = 0; k < NKIND; ++k){
+    start[k+1] = start[k] + pos[k];
+    pos[k] = start[k];
+  }
+
+  perm.resize(n);
+  for (size_t i = 0; i < n; ++i) perm[pos[index(ch[i])]++] = i;
+
+  kind[0] = 'R';
+  kind[1] = 'W';
+  kind[2] = 'X';
+  kind[3] = 'D';
+  kind[4] = 'B';
+  kind[5] = (start[5] < n) ? ch[perm[start[5]]] : 0;
+}
+
+
+/*! Clculo em lote em que cada amostra tem o seu prprio tipo de umidade, como num fluxo de dados com higrmetros, medidores de ponto de orvalho e psicrmetros misturados.
+
+Psychro::batch aplica o mesmo algoritmo a todas as amostras. Chamar o modelo amostra por amostra com tipos alternados impede a vetorizao (o estado de uma umidade relativa  explcito, o de um bulbo mido exige iteraes) e alterna o cdigo executado. Aqui as amostras so processadas em blocos: cada bloco  agrupado por tipo (KindBuckets), as entradas de cada grupo so copiadas para vetores contguos, cada grupo  calculado por uma nica chamada a m.batch e os resultados so devolvidos s posies originais. Um bloco em que todas as amostras tm o mesmo tipo  passado diretamente para m.batch.
+
+Os resultados so os mesmos de m.batch aplicado a cada amostra com o seu tipo.
+
+\param m Modelo utilizado
+\param n Nmero de amostras
+\param ch Tipo de umidade de cada amostra ('R', 'W', 'D', 'B' ou 'X', ver Psychro::set)
+\param T Temperaturas em K
+\param umidade Umidades
+\param P Presses em Pa
+\param out Colunas de sada (ponteiros nulos no so calculados)
+*/
+void mixed_batch(const Psychro &m, size_t n, const char *ch, const double *T,
+		 const double *umidade, const double *P, const MoistAirColumns &out){
+  // Blocos de at 4096 amostras; os vetores de trabalho tm o tamanho do bloco
+  const size_t NB = (n < 4096) ? n : 4096;
+  KindBuckets b;
+  vector<double> in, res;
+  vector<int> st;
+  MoistAirColumns o;
+
+  for (size_t i0 = 0; i0 < n; i0 += NB){
+    size_t len = (n - i0 < NB) ? n - i0 : NB;
+    const char *c = ch + i0;
+
+    // Bloco homogneo: no  necessrio permutar
+    size_t j = 1;
+    while (j < len && c[j] == c[0]) ++j;
+    if (j == len){
+      m.batch(len, c[0], T+i0, umidade+i0, P+i0, out.shift(i0));
+      continue;
+    }
+
+    if (in.empty()){
+      in.resize(3*NB);
+      res.resize(MoistAirColumns::NCOL*NB);
+      for (int k = 0; k < MoistAirColumns::NCOL; ++k)
+	if (out.*MoistAirColumns::column(k))
+	  o.*MoistAirColumns::column(k) = &res[k*NB];
+      if (out.status){
+	st.resize(NB);
+	o.status = &st[0];
+      }
+    }
+
+    b.build(len, c);
+    double *t = &in[0], *u = &in[NB], *p = &in[2*NB];
+    for (j = 0; j < len; ++j){
+      size_t i = i0 + b.perm[j];
+      t[j] = T[i];
+      u[j] = umidade[i];
+      p[j] = P[i];
+    }
+
+    for (int k = 0; k < KindBuckets::NKIND; ++k){
+      size_t s = b.start[k], cnt = b.start[k+1] - s;
+      if (cnt) m.batch(cnt, b.kind[k], t+s, u+s, p+s, o.shift(s));
+    }
+
+    for (int k = 0; k < MoistAirColumns::NCOL; ++k){
+      double *dst = out.*MoistAirColumns::column(k);
+      if (!dst) continue;
+      const double *src = o.*MoistAirColumns::column(k);
+      for (j = 0; j < len; ++j) dst[i0 + b.perm[j]] = src[j];
+    }
+    if (out.status)
+      for (j = 0; j < len; ++j) out.status[i0 + b.perm[j]] = st[j];
+  }
+}
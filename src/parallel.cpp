@@ -0,0 +1,160 @@
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <system_error>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <psychro/psychro.h>
+
+
+using namespace std;
+
+
+/*! Estado compartilhado entre as threads de parallel_batch
+ */
+struct ParallelWork{
+  const Psychro *m;
+  size_t n;
+  char ch;
+  /// Tipo de umidade de cada amostra (nulo: todas do tipo ch)
+  const char *kinds;
+  const double *T, *umidade, *P;
+  MoistAirColumns out;
+  size_t minChunk;
+  unsigned nthreads;
+  /// Processadores nos quais as threads so fixadas (vazio: sem afinidade)
+  vector<int> cpus;
+  /// Prxima amostra a ser distribuda
+  atomic<size_t> next;
+
+  /// Retira o prximo bloco. Retorna false quando no h mais amostras
+  bool take(size_t &i0, size_t &len){
+    size_t i = next.load(memory_order_relaxed);
+    for(;;){
+      if (i >= n) return false;
+      // Auto-escalonamento guiado: blocos proporcionais ao que resta
+      size_t c = (n - i) / (2*nthreads);
+      if (c < minChunk) c = minChunk;
+      if (c > n - i) c = n - i;
+      if (next.compare_exchange_weak(i, i + c, memory_order_relaxed)){
+	i0 = i;
+	len = c;
+	return true;
+      }
+    }
+  }
+
+  void run(unsigned k){
+    if (!cpus.empty()) pin(cpus[k % cpus.size()]);
+    size_t i0, len;
+    while (take(i0, len)){
+      if (kinds)
+	mixed_batch(*m, len, kinds + i0, T + i0, umidade + i0, P + i0, out.shift(i0));
+      else
+	m->batch(len, ch, T + i0, umidade + i0, P + i0, out.shift(i0));
+    }
+  }
+
+  /// Fixa a thread atual no processador cpu
+  static void pin(int cpu){
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#endif
+  }
+};
+
+
+/// Implementao de parallel_batch (kinds nulo: todas as amostras so do tipo ch)
+static int run_parallel(const Psychro &m, size_t n, char ch, const char *kinds,
+			const double *T, const double *umidade, const double *P,
+			const MoistAirColumns &out, const ParallelOptions &opt){
+  unsigned nt = opt.threads;
+  if (nt == 0) nt = thread::hardware_concurrency();
+  if (nt == 0) nt = 1;
+  size_t minChunk = opt.minChunk ? opt.minChunk : 1;
+  // No vale a pena criar threads que no tero trabalho
+  size_t nmax = (n + minChunk - 1) / minChunk;
+  if (nmax < 1) nmax = 1;
+  if (nt > nmax) nt = (unsigned) nmax;
+
+  ParallelWork w;
+  w.m = &m;
+  w.n = n;
+  w.ch = ch;
+  w.kinds = kinds;
+  w.T = T;
+  w.umidade = umidade;
+  w.P = P;
+  w.out = out;
+  w.minChunk = minChunk;
+  w.nthreads = nt;
+  w.next = 0;
+
+#ifdef __linux__
+  // Os processadores permitidos so os da thread que chama, cuja afinidade  restaurada no final
+  cpu_set_t caller;
+  if (opt.affinity && nt > 1 &&
+      pthread_getaffinity_np(pthread_self(), sizeof(caller), &caller) == 0){
+    for (int c = 0; c < CPU_SETSIZE; ++c)
+      if (CPU_ISSET(c, &caller)) w.cpus.push_back(c);
+  }
+#endif
+
+  vector<thread> pool;
+  pool.reserve(nt - 1);
+  for (unsigned k = 1; k < nt; ++k){
+    try{
+      pool.push_back(thread(&ParallelWork::run, &w, k));
+    }catch(const system_error &){
+      break;
+    }
+  }
+
+  w.run(0);
+  for (size_t k = 0; k < pool.size(); ++k) pool[k].join();
+
+#ifdef __linux__
+  if (!w.cpus.empty())
+    pthread_setaffinity_np(pthread_self(), sizeof(caller), &caller);
+#endif
+
+  return (int) pool.size() + 1;
+}
+
+/*! Clculo em lote utilizando vrias threads. Os modelos no so modificados pelas funes de sada reentrantes, portanto todas as threads compartilham o mesmo modelo m e cada uma escreve em partes distintas das colunas de sada.
+
+O custo por amostra varia muito (uma umidade relativa exige poucas operaes, um bulbo mido exige iteraes aninhadas), portanto as amostras no so divididas igualmente entre as threads. Cada thread retira blocos de um contador atmico comum. O tamanho dos blocos  proporcional ao nmero de amostras restantes (auto-escalonamento guiado), com no mnimo opt.minChunk amostras: no incio os blocos so grandes (pouca sincronizao) e no final so pequenos, de modo que nenhuma thread fica com uma cauda longa enquanto as outras esto paradas.
+
+A thread que chama esta funo tambm calcula. Se no for possvel criar threads, o clculo continua com as threads j existentes.
+
+\param m Modelo utilizado
+\param n Nmero de amostras
+\param ch Tipo de umidade ('R', 'W', 'D', 'B' ou 'X', ver Psychro::set)
+\param T Temperaturas em K
+\param umidade Umidades
+\param P Presses em Pa
+\param out Colunas de sada (ponteiros nulos no so calculados)
+\param opt Nmero de threads, tamanho mnimo dos blocos e afinidade
+\return Nmero de threads utilizadas
+*/
+int parallel_batch(const Psychro &m, size_t n, char ch, const double *T,
+		   const double *umidade, const double *P, const MoistAirColumns &out,
+		   const ParallelOptions &opt){
+  return run_parallel(m, n, ch, 0, T, umidade, P, out, opt);
+}
+
+
+/*! Clculo em lote utilizando vrias threads com o tipo de umidade ch[i] na amostra i. Cada bloco retirado por uma thread  calculado por mixed_batch. Ver a verso com um nico tipo de umidade.
+ */
+int parallel_batch(const Psychro &m, size_t n, const char *ch, const double *T,
+		   const double *umidade, const double *P, const MoistAirColumns &out,
+		   const ParallelOptions &opt){
+  return run_parallel(m, n, 0, ch, T, umidade, P, out, opt);
+}
@@ -0,0 +1,86 @@
+#include <cstdlib>
+#include <cstring>
+
+#include <psychro/psychro.h>
+#include <psychro/vecmath.h>
+
+
+using namespace std;
+
+
+/*! O nvel  suportado se o compilador gerou a verso correspondente (ver PSYCHRO_SIMD_DISPATCH) e o processador, consultado pelo CPUID, possui as instrues. Os nveis SIMD_SCALAR e SIMD_BASE sempre so suportados.
+\param level Nvel
+\return true se as funes em lote podem utilizar o nvel
+*/
+bool simd_supported(SimdLevel level){
+  switch(level){
+  case SIMD_SCALAR:
+  case SIMD_BASE:
+    return true;
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+  case SIMD_SSE42:
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse4.2");
+  case SIMD_AVX2:
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+  case SIMD_AVX512:
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx512f");
+#endif
+  default:
+    return false;
+  }
+}
+
+
+int simd_lanes(SimdLevel level){
+  switch(level){
+  case SIMD_SCALAR: return 1;
+  case SIMD_SSE42: return 2;
+  case SIMD_AVX2: return 4;
+  case SIMD_AVX512: return 8;
+  default: return PSYCHRO_LANES;
+  }
+}
+
+
+const char *simd_name(SimdLevel level){
+  switch(level){
+  case SIMD_SCALAR: return "scalar";
+  case SIMD_SSE42: return "sse4.2";
+  case SIMD_AVX2: return "avx2";
+  case SIMD_AVX512: return "avx512";
+  default: return "base";
+  }
+}
+
+
+/*! Escolhe o nvel: o valor de PSYCHRO_SIMD, se houver, ou ento o maior nvel suportado. SIMD_SSE42 s  preferido a SIMD_BASE se a biblioteca tiver sido compilada para menos de 2 elementos.
+ */
+static SimdLevel escolhe(){
+  const char *env = getenv("PSYCHRO_SIMD");
+  if (env && *env){
+    for (int k = SIMD_AVX512; k >= SIMD_SCALAR; --k){
+      if (strcmp(env, simd_name((SimdLevel) k))) continue;
+      while (!simd_supported((SimdLevel) k)) --k;
+      return (SimdLevel) k;
+    }
+  }
+
+  for (int k = SIMD_AVX512; k > SIMD_BASE; --k)
+    if (simd_supported((SimdLevel) k) && simd_lanes((SimdLevel) k) >= PSYCHRO_LANES)
+      return (SimdLevel) k;
+  return SIMD_BASE;
+}
+
+
+/*! Nvel de conjunto de instrues das funes em lote.  escolhido uma nica vez (ver simd.h): na carga da biblioteca ou, se uma funo em lote for chamada durante a inicializao de outro objeto esttico, na primeira chamada.
+ */
+SimdLevel simd_level(){
+  static const SimdLevel nivel = escolhe();
+  return nivel;
+}
+
+/// Faz a escolha na carga da biblioteca
+static const SimdLevel nivelCarga = simd_level();
@@ -0,0 +1,162 @@
+/*! \file desempenho.cpp
+
+\brief Tempo de execuo e nmero de iteraes dos mtodos iterativos
+
+Mede, para cada modelo, o tempo por estado de Psychro::batch e Psychro::batchFloat (teor de umidade, bulbo mido e ponto de orvalho), de Ashrae::WETBULBBatch com e sem perfectGasSeed, e das funes escalares numa srie temporal com e sem partida a quente (ver SolverContext), com o nmero mdio de iteraes de Newton do bulbo mido e do ponto de orvalho por estado. As funes escalares so medidas tambm numa classe derivada sem nenhuma correlao redefinida, que utiliza as funes virtuais em vez do modelo composto estaticamente (ver models.h). Cada tempo  o menor de vrias repeties.
+
+Compilao e execuo (ver simd.h para PSYCHRO_SIMD):
+
+g++ -O2 -std=c++11 -Iinclude test/desempenho.cpp src/[a-z]*.cpp -o desempenho -lpthread
+./desempenho
+*/
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include <psychro/psychro.h>
+
+using namespace std;
+
+
+/// Modelos derivados sem correlaes redefinidas: as funes de sada utilizam as funes virtuais (ver GasPerfeito::nativeBatch)
+class GasPerfeitoVirtual: public GasPerfeito{};
+class AshraeVirtual: public Ashrae{};
+class GiacomoVirtual: public Giacomo{};
+
+
+/// Nmero de estados de cada medida
+static const size_t N = 100000;
+/// Repeties de cada medida (vale a mais rpida)
+static const int REP = 5;
+
+
+/// Srie temporal de um sensor amostrado a 1 Hz: temperatura, umidade relativa e presso variam lentamente
+struct Serie{
+  vector<double> T, u, P, W;
+  Serie(): T(N), u(N), P(N), W(N){
+    for (size_t i = 0; i < N; ++i){
+      double t = i / 600.0;
+      T[i] = 293.15 + 8.0*sin(t) + 0.05*sin(37.0*t);
+      u[i] = 0.55 + 0.3*sin(0.7*t + 1.0);
+      P[i] = 101325.0 + 800.0*sin(0.1*t);
+    }
+  }
+};
+
+
+/// Tempo em ns por estado da mais rpida de REP execues de f
+template<class F>
+static double mede(F f){
+  double melhor = 0;
+  for (int r = 0; r < REP; ++r){
+    chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+    f();
+    double dt = chrono::duration<double, nano>(chrono::steady_clock::now() - t0).count() / N;
+    if (r == 0 || dt < melhor) melhor = dt;
+  }
+  return melhor;
+}
+
+
+/// Psychro::batch e Psychro::batchFloat com as colunas de teor de umidade, bulbo mido e ponto de orvalho
+static void lote(const char *modelo, const Psychro &m, const Serie &s){
+  vector<double> W(N), B(N), D(N);
+  vector<int> status(N);
+  MoistAirColumns out;
+  out.W = &W[0]; out.wetbulb = &B[0]; out.dewpoint = &D[0]; out.status = &status[0];
+  double t = mede([&](){ m.batch(N, 'R', &s.T[0], &s.u[0], &s.P[0], out); });
+
+  vector<float> T(s.T.begin(), s.T.end()), u(s.u.begin(), s.u.end()), P(s.P.begin(), s.P.end());
+  vector<float> Wf(N), Bf(N), Df(N);
+  MoistAirColumnsF outf;
+  outf.W = &Wf[0]; outf.wetbulb = &Bf[0]; outf.dewpoint = &Df[0]; outf.status = &status[0];
+  double tf = mede([&](){ m.batchFloat(N, 'R', &T[0], &u[0], &P[0], outf); });
+  printf("  %-20s %8.1f ns %8.1f ns\n", modelo, t, tf);
+}
+
+
+/// Ashrae::WETBULBBatch com e sem o valor inicial do gs perfeito
+static void bulboUmido(const char *modelo, Ashrae &m, const Serie &s){
+  vector<double> B(N);
+  vector<int> err(N);
+  m.perfectGasSeed = true;
+  double tg = mede([&](){ m.WETBULBBatch(N, &s.T[0], &s.P[0], &s.W[0], &B[0], &err[0]); });
+  m.perfectGasSeed = false;
+  double tt = mede([&](){ m.WETBULBBatch(N, &s.T[0], &s.P[0], &s.W[0], &B[0], &err[0]); });
+  m.perfectGasSeed = true;
+  printf("  %-20s %8.1f ns %8.1f ns\n", modelo, tg, tt);
+}
+
+
+/// Funes escalares na srie temporal, partindo dos valores da amostra anterior ou no (quente = false)
+static void serie(const char *modelo, const Psychro &m, const Serie &s, bool quente){
+  SolverContext cb, cd;
+  vector<MoistAirState> st(N);
+  for (size_t i = 0; i < N; ++i) st[i] = m.state(s.T[i], 'R', s.u[i], s.P[i]);
+  double x = 0;
+  double t = mede([&](){
+      cb = cd = SolverContext();
+      for (size_t i = 0; i < N; ++i){
+	if (!quente){
+	  cb.reset();
+	  cd.reset();
+	}
+	x += m.WETBULB(st[i], cb) + m.DEWPOINT(st[i], cd);
+      }
+    });
+  printf("  %-20s %8.1f ns %8.2f %8.2f%s\n", modelo, t, double(cb.iterations) / N,
+	 double(cd.iterations) / N, (x == x) ? "" : " (NaN)");
+}
+
+
+/// WETBULB e DEWPOINT (sem partida a quente) e evaluate_all escalares com o modelo esttico (m) e com as funes virtuais (virt)
+static void composicao(const char *modelo, const Psychro &m, const Psychro &virt, const Serie &s){
+  vector<MoistAirState> st(N);
+  for (size_t i = 0; i < N; ++i) st[i] = m.state(s.T[i], 'R', s.u[i], s.P[i]);
+  double x = 0;
+  double ts = mede([&](){ for (size_t i = 0; i < N; ++i) x += m.WETBULB(st[i]) + m.DEWPOINT(st[i]); });
+  double tv = mede([&](){ for (size_t i = 0; i < N; ++i) x += virt.WETBULB(st[i]) + virt.DEWPOINT(st[i]); });
+  double es = mede([&](){ for (size_t i = 0; i < N; ++i) x += m.evaluate_all(st[i]).wetbulb; });
+  double ev = mede([&](){ for (size_t i = 0; i < N; ++i) x += virt.evaluate_all(st[i]).wetbulb; });
+  printf("  %-20s %8.1f ns %8.1f ns %8.1f ns %8.1f ns%s\n", modelo, ts, tv, es, ev,
+	 (x == x) ? "" : " (NaN)");
+}
+
+
+int main(){
+  printf("SIMD: %s\n", simd_name(simd_level()));
+  Serie s;
+  GasPerfeito g;
+  Ashrae a, ar;
+  Giacomo gi;
+  ar.fastMode(270.0, 310.0, 95000.0, 105000.0);
+  for (size_t i = 0; i < N; ++i) s.W[i] = a.state(s.T[i], 'R', s.u[i], s.P[i]).W;
+
+  printf("Psychro::batch e batchFloat (W, bulbo mido, ponto de orvalho), por estado:   double   float\n");
+  lote("GasPerfeito", g, s);
+  lote("Ashrae", a, s);
+  lote("Ashrae (fastMode)", ar, s);
+  lote("Giacomo", gi, s);
+
+  printf("WETBULBBatch, por estado:   perfectGasSeed   sem\n");
+  bulboUmido("Ashrae", a, s);
+  bulboUmido("Giacomo", gi, s);
+
+  printf("WETBULB e DEWPOINT escalares, por estado:  iteraes (bulbo mido, orvalho)\n");
+  printf(" sem partida a quente\n");
+  serie("GasPerfeito", g, s, false);
+  serie("Ashrae", a, s, false);
+  serie("Giacomo", gi, s, false);
+  printf(" com partida a quente (SolverContext)\n");
+  serie("GasPerfeito", g, s, true);
+  serie("Ashrae", a, s, true);
+  serie("Giacomo", gi, s, true);
+
+  printf("Funes escalares, por estado:  WETBULB+DEWPOINT (esttico, virtual)  evaluate_all (esttico, virtual)\n");
+  composicao("GasPerfeito", g, GasPerfeitoVirtual(), s);
+  composicao("Ashrae", a, AshraeVirtual(), s);
+  composicao("Giacomo", gi, GiacomoVirtual(), s);
+  return 0;
+}
@@ -0,0 +1,592 @@
+/*! \file teste_lote.cpp
+
+\brief Compara os caminhos de clculo em lote com as funes escalares
+
+Cada caminho (Psychro::batch, mixed_batch, parallel_batch, dedup_batch, grid_eval, ResultCache) deve dar, para cada amostra, o mesmo resultado que Psychro::state seguido das funes de sada reentrantes (DENSITY, VOLUME, ...) do mesmo modelo, a menos do arredondamento, inclusive numa classe derivada que redefine apenas algumas correlaes. As funes de sada dos modelos compostos estaticamente (ver models.h) devem ser idnticas s funes virtuais. O clculo em float (Psychro::batchFloat)  comparado com batch, dentro dos limites documentados em Ashrae::batchFloat.
+
+Compilao e execuo em todos os nveis SIMD (ver simd.h):
+
+g++ -O2 -std=c++11 -Iinclude test/teste_lote.cpp src/[a-z]*.cpp -o teste_lote -lpthread
+for s in scalar base sse4.2 avx2 avx512; do PSYCHRO_SIMD=$s ./teste_lote || break; done
+*/
+
+#include <cmath>
+#include <cstdio>
+#include <new>
+#include <vector>
+
+#include <psychro/psychro.h>
+
+using namespace std;
+
+
+/// Modelo derivado de Ashrae com a presso de vapor 5% maior (apenas as funes escalares)
+class Ashrae105: public Ashrae{
+ public:
+  virtual double Pws(double T, int *err=0) const{ return 1.05 * Ashrae::Pws(T, err); }
+  virtual double dPws(double T) const{ return 1.05 * Ashrae::dPws(T); }
+  virtual double PwsdPws(double T, double &dP) const{
+    double p = Ashrae::PwsdPws(T, dP);
+    dP *= 1.05;
+    return 1.05 * p;
+  }
+};
+
+
+/// Modelos derivados sem nenhuma correlao redefinida: as funes de sada utilizam as funes virtuais (ver GasPerfeito::nativeBatch)
+class GasPerfeitoVirtual: public GasPerfeito{};
+class AshraeVirtual: public Ashrae{};
+class GiacomoVirtual: public Giacomo{};
+
+
+static int falhas = 0;
+
+
+/// Amostras de um tipo de umidade
+struct Amostras{
+  char ch;
+  vector<double> T, u, P;
+  void add(double t, double x, double p){
+    T.push_back(t); u.push_back(x); P.push_back(p);
+  }
+  size_t size() const{ return T.size(); }
+};
+
+
+/// Colunas de sada com todas as propriedades
+struct Colunas{
+  vector<double> v[8];
+  vector<int> status;
+  MoistAirColumns out;
+  Colunas(size_t n): status(n){
+    for (int k = 0; k < 8; ++k) v[k].assign(n, NAN);
+    out.W = &v[0][0]; out.xv = &v[1][0]; out.density = &v[2][0]; out.volume = &v[3][0];
+    out.enthalpy = &v[4][0]; out.relhum = &v[5][0]; out.dewpoint = &v[6][0];
+    out.wetbulb = &v[7][0]; out.status = &status[0];
+  }
+  MoistAirProperties get(size_t i) const{
+    MoistAirProperties r((MoistAirState()));
+    r.W = v[0][i]; r.xv = v[1][i]; r.density = v[2][i]; r.volume = v[3][i];
+    r.enthalpy = v[4][i]; r.relhum = v[5][i]; r.dewpoint = v[6][i]; r.wetbulb = v[7][i];
+    r.status = status[i];
+    return r;
+  }
+};
+
+
+/// Resultado das funes escalares
+static MoistAirProperties referencia(const Psychro &m, double T, char ch, double u, double P){
+  MoistAirState s = m.state(T, ch, u, P);
+  MoistAirProperties r(s);
+  int err = s.status;
+  r.density = m.DENSITY(s, &err);
+  r.volume = m.VOLUME(s, &err);
+  r.enthalpy = m.ENTHALPY(s, &err);
+  r.relhum = m.RELHUM(s, &err);
+  r.dewpoint = m.DEWPOINT(s, &err);
+  r.wetbulb = m.WETBULB(s, &err);
+  r.status = err;
+  return r;
+}
+
+
+static bool igual(double a, double b, double rel){
+  if (std::isnan(a) || std::isnan(b)) return std::isnan(a) && std::isnan(b);
+  return fabs(a - b) <= rel * (fabs(a) + fabs(b)) + 1e-300;
+}
+
+
+/// Compara r com as funes escalares na amostra (T, ch, u, P). Os cdigos de erro devem ser iguais; os valores so comparados apenas sem erro
+static void compara(const char *modelo, const char *caminho, const Psychro &m, double T, char ch,
+		    double u, double P, const MoistAirProperties &r, double rel=1e-7){
+  MoistAirProperties e = referencia(m, T, ch, u, P);
+  const char *nome[] = {"W", "xv", "density", "volume", "enthalpy", "relhum", "dewpoint", "wetbulb"};
+  const double a[] = {r.W, r.xv, r.density, r.volume, r.enthalpy, r.relhum, r.dewpoint, r.wetbulb};
+  const double b[] = {e.W, e.xv, e.density, e.volume, e.enthalpy, e.relhum, e.dewpoint, e.wetbulb};
+  if (r.status != e.status){
+    printf("%s %s %c T=%g u=%g P=%g: status %d, escalar %d\n", modelo, caminho, ch, T, u, P,
+	   r.status, e.status);
+    ++falhas;
+    return;
+  }
+  if (e.status) return;
+  for (int k = 0; k < 8; ++k)
+    if (!igual(a[k], b[k], rel)){
+      printf("%s %s %c T=%g u=%g P=%g: %s %.12g, escalar %.12g\n", modelo, caminho, ch, T, u, P,
+	     nome[k], a[k], b[k]);
+      ++falhas;
+    }
+}
+
+
+/// Amostras de cada tipo de umidade dentro das faixas
+static vector<Amostras> amostras(){
+  const double T[] = {253.15, 272.15, 274.15, 293.15, 323.15};
+  const double P[] = {60000.0, 101325.0, 500000.0};
+  vector<Amostras> a(5);
+  a[0].ch = 'R'; a[1].ch = 'W'; a[2].ch = 'X'; a[3].ch = 'D'; a[4].ch = 'B';
+  for (int i = 0; i < 5; ++i)
+    for (int j = 0; j < 3; ++j){
+      a[0].add(T[i], 0.1, P[j]);
+      a[0].add(T[i], 0.75, P[j]);
+      a[1].add(T[i], 0.0005, P[j]);
+      a[2].add(T[i], 0.001, P[j]);
+      a[3].add(T[i], T[i] - 5.0, P[j]);
+      a[4].add(T[i], T[i] - 2.0, P[j]);
+    }
+  return a;
+}
+
+
+/// Amostras fora das faixas ou invlidas de cada tipo de umidade (cdigos de erro)
+static vector<Amostras> invalidas(){
+  const double T[] = {100.0, 700.0, NAN, INFINITY, 293.15};
+  const double P[] = {0.0, -1000.0, NAN, 1e9, 101325.0};
+  const char ch[] = {'R', 'W', 'X', 'D', 'B'};
+  const double u[] = {0.5, 0.005, 0.005, 283.15, 288.15};
+  vector<Amostras> a(5);
+  for (int k = 0; k < 5; ++k){
+    a[k].ch = ch[k];
+    for (int i = 0; i < 5; ++i)
+      for (int j = 0; j < 5; ++j)
+	a[k].add(T[i], u[k], P[j]);
+  }
+  // Umidades impossveis
+  a[0].add(293.15, 1.5, 101325.0);
+  a[0].add(293.15, -0.1, 101325.0);
+  a[1].add(293.15, -0.001, 101325.0);
+  a[2].add(293.15, 1.2, 101325.0);
+  a[3].add(293.15, 303.15, 101325.0);
+  // Ponto de orvalho abaixo da correlao de presso de vapor do gs perfeito
+  a[3].add(293.15, 200.0, 101325.0);
+  a[4].add(293.15, 303.15, 101325.0);
+  a[4].add(293.15, NAN, 101325.0);
+  return a;
+}
+
+
+/// Todos os caminhos em lote do modelo m
+static void testaModelo(const char *modelo, const Psychro &m){
+  vector<Amostras> todas = amostras(), inv = invalidas();
+  todas.insert(todas.end(), inv.begin(), inv.end());
+  for (size_t k = 0; k < todas.size(); ++k){
+    const Amostras &a = todas[k];
+    size_t n = a.size();
+
+    Colunas c(n);
+    m.batch(n, a.ch, &a.T[0], &a.u[0], &a.P[0], c.out);
+    for (size_t i = 0; i < n; ++i)
+      compara(modelo, "batch", m, a.T[i], a.ch, a.u[i], a.P[i], c.get(i));
+
+    for (size_t i = 0; i < n; ++i)
+      compara(modelo, "evaluate_all", m, a.T[i], a.ch, a.u[i], a.P[i],
+	      m.evaluate_all(m.state(a.T[i], a.ch, a.u[i], a.P[i])));
+
+    Colunas cp(n);
+    ParallelOptions opt;
+    opt.threads = 4;
+    opt.minChunk = 1;
+    parallel_batch(m, n, a.ch, &a.T[0], &a.u[0], &a.P[0], cp.out, opt);
+    for (size_t i = 0; i < n; ++i)
+      compara(modelo, "parallel_batch", m, a.T[i], a.ch, a.u[i], a.P[i], cp.get(i));
+
+    // Cada amostra repetida trs vezes
+    vector<double> T3, u3, P3;
+    for (int r = 0; r < 3; ++r)
+      for (size_t i = 0; i < n; ++i){
+	T3.push_back(a.T[i]); u3.push_back(a.u[i]); P3.push_back(a.P[i]);
+      }
+    Colunas cd(3*n);
+    dedup_batch(m, 3*n, a.ch, &T3[0], &u3[0], &P3[0], cd.out);
+    for (size_t i = 0; i < 3*n; ++i)
+      compara(modelo, "dedup_batch", m, T3[i], a.ch, u3[i], P3[i], cd.get(i));
+
+    ResultCache cache;
+    Colunas cc(3*n);
+    cache.batch(m, 3*n, a.ch, &T3[0], &u3[0], &P3[0], cc.out);
+    for (size_t i = 0; i < 3*n; ++i){
+      compara(modelo, "ResultCache::batch", m, T3[i], a.ch, u3[i], P3[i], cc.get(i));
+      compara(modelo, "ResultCache::get", m, T3[i], a.ch, u3[i], P3[i],
+	      cache.get(m, T3[i], a.ch, u3[i], P3[i]));
+    }
+  }
+
+  // Todas as amostras intercaladas num nico lote com tipos de umidade misturados
+  vector<char> chm;
+  vector<double> Tm, um, Pm;
+  for (size_t i = 0, resta = 1; resta; ++i){
+    resta = 0;
+    for (size_t k = 0; k < todas.size(); ++k)
+      if (i < todas[k].size()){
+	chm.push_back(todas[k].ch);
+	Tm.push_back(todas[k].T[i]); um.push_back(todas[k].u[i]); Pm.push_back(todas[k].P[i]);
+	resta = 1;
+      }
+  }
+  // Caractere que no  tipo de umidade
+  chm.push_back('Q');
+  Tm.push_back(293.15); um.push_back(0.5); Pm.push_back(101325.0);
+  Colunas cm(Tm.size());
+  mixed_batch(m, Tm.size(), &chm[0], &Tm[0], &um[0], &Pm[0], cm.out);
+  for (size_t i = 0; i < Tm.size(); ++i)
+    compara(modelo, "mixed_batch", m, Tm[i], chm[i], um[i], Pm[i], cm.get(i));
+
+  // Malha T  P  umidade
+  const double T[] = {268.15, 283.15, 303.15};
+  const double P[] = {80000.0, 101325.0};
+  const char ch[] = {'R', 'W', 'B'};
+  const double u[][2] = {{0.2, 0.9}, {0.001, 0.004}, {0, 0}};
+  for (int t = 0; t < 3; ++t){
+    size_t n = 3*2*2;
+    vector<double> U(2);
+    Colunas cg(n);
+    if (ch[t] == 'B'){
+      // Bulbo mido abaixo da menor temperatura
+      U[0] = 262.15; U[1] = 265.15;
+    }
+    else{
+      U[0] = u[t][0]; U[1] = u[t][1];
+    }
+    grid_eval(m, 3, T, 2, P, ch[t], 2, &U[0], cg.out);
+    for (int i = 0; i < 3; ++i)
+      for (int j = 0; j < 2; ++j)
+	for (int k = 0; k < 2; ++k)
+	  compara(modelo, "grid_eval", m, T[i], ch[t], U[k], P[j], cg.get((i*2 + j)*2 + k));
+  }
+}
+
+
+/*! Cdigo 109 vindo apenas do ponto de orvalho: os estados (entrada 'D') so especificados com o enhancement factor convergindo; depois o enhancement factor deixa de convergir e DEWPOINT e DEWPOINTBatch devem dar 109 (o cdigo do estado no o encobre)
+ */
+static void testaPontoOrvalho(const char *modelo, Ashrae &m){
+  Amostras a = amostras()[3];
+  size_t n = a.size();
+  vector<MoistAirState> s(n);
+  vector<double> P(n), xv(n), D(n);
+  for (size_t i = 0; i < n; ++i){
+    s[i] = m.state(a.T[i], a.ch, a.u[i], a.P[i]);
+    P[i] = s[i].P;
+    xv[i] = s[i].xv;
+  }
+  Tolerances t = m.tol;
+  m.tol.eFactor = 0.0;
+  vector<int> eb(n);
+  m.DEWPOINTBatch(n, &P[0], &xv[0], &D[0], &eb[0]);
+  for (size_t i = 0; i < n; ++i){
+    int e = 0;
+    m.DEWPOINT(s[i], &e);
+    if (s[i].status || e != 109 || eb[i] != 109){
+      printf("%s D=%g P=%g: status %d, DEWPOINT %d, DEWPOINTBatch %d\n", modelo, a.u[i], a.P[i],
+	     s[i].status, e, eb[i]);
+      ++falhas;
+    }
+  }
+  m.tol = t;
+}
+
+
+/// Cdigos de erro das correlaes de saturao do gs perfeito, distintos dos de FaixaT e FaixaP
+static void testaCodigos(){
+  GasPerfeito g;
+  int ep = 0, et = 0;
+  g.Pws(200.0, &ep);
+  g.Tws(0.5, &et);
+  int es = g.state(293.15, 'D', 200.0, 101325.0).status;
+  if (ep != 17 || et != 18 || es != 17){
+    printf("GasPerfeito: cdigos %d (Pws), %d (Tws), %d (state 'D')\n", ep, et, es);
+    ++falhas;
+  }
+}
+
+
+/// GasPerfeito::WETBULBBatch (valor inicial de Ashrae::WETBULBBatch) deve concordar com WETBULB, inclusive na tolerncia relaxada de Ashrae::seedModel
+static void testaBulboUmido(){
+  GasPerfeito g, relaxado;
+  relaxado.tol = Tolerances::accuracy(1e-3, 1e-6);
+  const GasPerfeito *m[] = {&g, &relaxado};
+  const Amostras a = amostras()[0];
+  size_t n = a.size();
+  vector<double> W(n), B(n);
+  for (int k = 0; k < 2; ++k){
+    for (size_t i = 0; i < n; ++i) W[i] = m[k]->state(a.T[i], 'R', a.u[i], a.P[i]).W;
+    vector<int> err(n, 0);
+    m[k]->WETBULBBatch(n, &a.T[0], &a.P[0], &W[0], &B[0], &err[0]);
+    for (size_t i = 0; i < n; ++i){
+      MoistAirState s = m[k]->state(a.T[i], 'R', a.u[i], a.P[i]);
+      int e = 0;
+      double b = m[k]->WETBULB(s, &e);
+      if (err[i] != e || (!e && !igual(B[i], b, 10*m[k]->tol.wetbulb / b))){
+	printf("GasPerfeito WETBULBBatch T=%g u=%g P=%g: %.12g (%d), escalar %.12g (%d)\n",
+	       a.T[i], a.u[i], a.P[i], B[i], err[i], b, e);
+	++falhas;
+      }
+    }
+  }
+}
+
+
+/*! Partida a quente numa srie temporal (ver SolverContext): o bulbo mido e o ponto de orvalho devem ficar dentro da tolerncia da soluo muito mais apertada, em no mximo duas iteraes por amostra. A referncia usa a mesma tolerncia do enhancement factor, que limita sozinha o ponto de orvalho
+ */
+static void testaPartidaQuente(const char *modelo, const Psychro &m, const Psychro &ref){
+  const size_t n = 2000;
+  SolverContext cb, cd;
+  for (size_t i = 0; i < n; ++i){
+    double t = i / 600.0;
+    double T = 293.15 + 8.0*sin(t) + 0.05*sin(37.0*t), u = 0.55 + 0.3*sin(0.7*t + 1.0);
+    double P = 101325.0 + 800.0*sin(0.1*t);
+    MoistAirState s = m.state(T, 'R', u, P);
+    double B = m.WETBULB(s, cb), D = m.DEWPOINT(s, cd);
+    double Br = ref.WETBULB(s), Dr = ref.DEWPOINT(s);
+    if (fabs(B - Br) > m.tol.wetbulb || fabs(D - Dr) > m.tol.dewpoint){
+      printf("%s partida a quente T=%g u=%g P=%g: bulbo mido %.12g (%.12g), orvalho %.12g (%.12g)\n",
+	     modelo, T, u, P, B, Br, D, Dr);
+      ++falhas;
+    }
+    // A primeira amostra parte das estimativas usuais
+    if (i == 0) cb.iterations = cd.iterations = 0;
+  }
+  if (cb.iterations > long(2*(n - 1)) || cd.iterations > long(2*(n - 1))){
+    printf("%s partida a quente: %ld e %ld iteraes em %zu amostras\n", modelo, cb.iterations,
+	   cd.iterations, n - 1);
+    ++falhas;
+  }
+}
+
+
+/// Funes de sada no reentrantes (set e memria do estado atual, ver Psychro::cached)
+static MoistAirProperties memoria(Psychro &m, double T, double P){
+  MoistAirProperties r((MoistAirState()));
+  m.ClearError();
+  r.W = m.HUMRAT();
+  r.xv = m.MOLFRAC();
+  r.density = m.DENSITY(T, P);
+  r.volume = m.VOLUME(T, P);
+  r.enthalpy = m.ENTHALPY(T, P);
+  r.relhum = m.RELHUM(T, P);
+  r.dewpoint = m.DEWPOINT(T, P);
+  r.wetbulb = m.WETBULB(T, P);
+  r.status = m.ERROR();
+  return r;
+}
+
+
+/// A memria do estado atual deve acompanhar as mudanas de configurao do modelo
+static void testaMemoria(){
+  const double T = 300.15, P = 101325.0;
+  Ashrae a;
+  a.set(T, 'R', 0.5, P);
+  // Os valores so comparados com tolerncia bem menor que o efeito das mudanas de configurao
+  compara("Ashrae", "memria", a, T, 'R', 0.5, P, memoria(a, T, P), 1e-14);
+
+  a.tol = Tolerances::accuracy(0.01, 1e-4);
+  compara("Ashrae", "memria (tol)", a, T, 'R', 0.5, P, memoria(a, T, P), 1e-14);
+  a.virialMethod = Ashrae::VIRIAL_ITERATIVE;
+  compara("Ashrae", "memria (virialMethod)", a, T, 'R', 0.5, P, memoria(a, T, P), 1e-14);
+  a.perfectGasSeed = false;
+  compara("Ashrae", "memria (perfectGasSeed)", a, T, 'R', 0.5, P, memoria(a, T, P), 1e-14);
+  a.fastMode(280.0, 320.0, 90000.0, 110000.0);
+  compara("Ashrae", "memria (fastMode)", a, T, 'R', 0.5, P, memoria(a, T, P), 1e-14);
+  a.Tmax = 290.0;
+  compara("Ashrae", "memria (Tmax)", a, T, 'R', 0.5, P, memoria(a, T, P), 1e-14);
+  if (memoria(a, T, P).status != 10){
+    printf("memria: Tmax no foi considerado\n");
+    ++falhas;
+  }
+}
+
+
+/// Igualdade exata de dois resultados (NaN  igual a NaN)
+static bool identico(const MoistAirProperties &a, const MoistAirProperties &b){
+  const double x[] = {a.W, a.xv, a.density, a.volume, a.enthalpy, a.relhum, a.dewpoint, a.wetbulb};
+  const double y[] = {b.W, b.xv, b.density, b.volume, b.enthalpy, b.relhum, b.dewpoint, b.wetbulb};
+  for (int k = 0; k < 8; ++k)
+    if (!igual(x[k], y[k], 0.0)) return false;
+  return a.status == b.status;
+}
+
+
+/// ResultCache no deve devolver resultados de outro modelo nem de outra configurao, e get e batch devem armazenar o mesmo resultado
+static void testaCache(){
+  const double T = 300.15, P = 101325.0;
+  ResultCache cache;
+
+  // Uma entrada calculada por get  lida por batch e vice-versa, sem diferena de arredondamento
+  vector<Amostras> todas = amostras();
+  Ashrae a;
+  for (size_t k = 0; k < todas.size(); ++k){
+    const Amostras &s = todas[k];
+    size_t n = s.size();
+    Colunas direto(n), lote(n);
+    a.batch(n, s.ch, &s.T[0], &s.u[0], &s.P[0], direto.out);
+    for (size_t i = 0; i < n; i += 2) cache.get(a, s.T[i], s.ch, s.u[i], s.P[i]);
+    cache.batch(a, n, s.ch, &s.T[0], &s.u[0], &s.P[0], lote.out);
+    for (size_t i = 0; i < n; ++i)
+      if (!identico(lote.get(i), direto.get(i)) ||
+	  !identico(cache.get(a, s.T[i], s.ch, s.u[i], s.P[i]), direto.get(i))){
+	printf("ResultCache: get e batch diferem em %c T=%g u=%g P=%g\n", s.ch, s.T[i], s.u[i],
+	       s.P[i]);
+	++falhas;
+      }
+  }
+
+  // Mudana de configurao
+  cache.get(a, T, 'R', 0.5, P);
+  a.Tmax = 290.0;
+  compara("Ashrae", "ResultCache (Tmax)", a, T, 'R', 0.5, P, cache.get(a, T, 'R', 0.5, P));
+
+  // Um modelo construdo no endereo de outro j destrudo
+  union{
+    char bytes[sizeof(Ashrae105)];
+    double alinhamento;
+  } espaco;
+  Ashrae *primeiro = new (espaco.bytes) Ashrae;
+  cache.get(*primeiro, T, 'R', 0.5, P);
+  primeiro->~Ashrae();
+  Ashrae *segundo = new (espaco.bytes) Ashrae105;
+  compara("Ashrae105", "ResultCache (endereo)", *segundo, T, 'R', 0.5, P,
+	  cache.get(*segundo, T, 'R', 0.5, P));
+  segundo->~Ashrae();
+}
+
+
+/*! As funes de sada com o modelo esttico (ver models.h) devem dar exatamente os mesmos resultados que as funes virtuais do mesmo modelo
+ */
+static void testaEstatico(const char *modelo, const Psychro &m, const Psychro &virt){
+  vector<Amostras> todas = amostras();
+  for (size_t k = 0; k < todas.size(); ++k){
+    const Amostras &s = todas[k];
+    for (size_t i = 0; i < s.size(); ++i){
+      MoistAirState e = m.state(s.T[i], s.ch, s.u[i], s.P[i]);
+      if (!identico(referencia(m, s.T[i], s.ch, s.u[i], s.P[i]),
+		    referencia(virt, s.T[i], s.ch, s.u[i], s.P[i])) ||
+	  !identico(m.evaluate_all(e), virt.evaluate_all(e))){
+	printf("%s: modelo esttico difere das funes virtuais em %c T=%g u=%g P=%g\n", modelo,
+	       s.ch, s.T[i], s.u[i], s.P[i]);
+	++falhas;
+      }
+    }
+  }
+}
+
+
+/*! Psychro::batchFloat contra batch com as mesmas entradas arredondadas para float: os cdigos de erro devem ser iguais e as propriedades devem estar dentro dos limites de Ashrae::batchFloat. Se exato, o resultado deve ser o de batch arredondado (GasPerfeito e as classes derivadas, ver GasPerfeito::batchFloat)
+ */
+static void testaFloat(const char *modelo, const Psychro &m, bool exato){
+  vector<Amostras> todas = amostras(), inv = invalidas();
+  todas.insert(todas.end(), inv.begin(), inv.end());
+  // Varredura densa, com pontos de orvalho e bulbos midos dos dois lados de 273.15
+  const char ch[] = {'R', 'W', 'X', 'D', 'B'};
+  for (int k = 0; k < 5; ++k){
+    Amostras a;
+    a.ch = ch[k];
+    for (double T = 253.15; T < 323.15; T += 0.37)
+      for (double P = 60000.0; P < 600000.0; P *= 1.7)
+	for (int j = 1; j <= 10; ++j){
+	  double x = (ch[k] == 'R') ? 0.1*j : (ch[k] == 'W') ? 0.002*j : (ch[k] == 'X') ? 0.003*j :
+	    (ch[k] == 'D') ? T - 3.1*j : T - 1.3*j;
+	  a.add(T, x, P);
+	}
+    todas.push_back(a);
+  }
+
+  const char *nome[] = {"W", "xv", "density", "volume", "enthalpy", "relhum", "dewpoint", "wetbulb"};
+  for (size_t k = 0; k < todas.size(); ++k){
+    const Amostras &a = todas[k];
+    size_t n = a.size();
+    vector<float> T(a.T.begin(), a.T.end()), u(a.u.begin(), a.u.end()), P(a.P.begin(), a.P.end());
+    vector<double> Td(T.begin(), T.end()), ud(u.begin(), u.end()), Pd(P.begin(), P.end());
+    Colunas c(n);
+    m.batch(n, a.ch, &Td[0], &ud[0], &Pd[0], c.out);
+
+    vector<float> v[8];
+    vector<int> status(n);
+    MoistAirColumnsF out;
+    for (int j = 0; j < 8; ++j){
+      v[j].assign(n, NAN);
+      out.*MoistAirColumnsF::column(j) = &v[j][0];
+    }
+    out.status = &status[0];
+    m.batchFloat(n, a.ch, &T[0], &u[0], &P[0], out);
+
+    for (size_t i = 0; i < n; ++i){
+      if (status[i] != c.status[i]){
+	printf("%s batchFloat %c T=%g u=%g P=%g: status %d, batch %d\n", modelo, a.ch, Td[i], ud[i],
+	       Pd[i], status[i], c.status[i]);
+	++falhas;
+	continue;
+      }
+      if (c.status[i]) continue;
+      // Limites de Ashrae::batchFloat: relativos para W, xv, densidade e volume, absolutos para as demais
+      const double lim[] = {(a.ch == 'B') ? 2e-4 : 1.5e-5, (a.ch == 'B') ? 2e-4 : 1.5e-5, 2e-6, 7e-6,
+			    25.0, 7e-5, (a.ch == 'B') ? 2.5e-3 : 5e-4, 4e-4};
+      for (int j = 0; j < 8; ++j){
+	double d = c.v[j][i], f = v[j][i];
+	double e = fabs(f - d);
+	if (j < 4) e /= fabs(d);
+	bool ok = exato ? f == (float) d : (d == f || e <= lim[j]);
+	if (!ok){
+	  printf("%s batchFloat %c T=%g u=%g P=%g: %s %.9g, batch %.12g\n", modelo, a.ch, Td[i], ud[i],
+		 Pd[i], nome[j], f, d);
+	  ++falhas;
+	}
+      }
+    }
+  }
+}
+
+
+int main(){
+  printf("SIMD: %s\n", simd_name(simd_level()));
+
+  testaModelo("GasPerfeito", GasPerfeito());
+  testaModelo("Ashrae", Ashrae());
+  testaModelo("Giacomo", Giacomo());
+  testaModelo("Ashrae105", Ashrae105());
+
+  // Enhancement factor que nunca converge: todos os caminhos devem dar o cdigo 109
+  Ashrae semConvergencia;
+  semConvergencia.tol.eFactor = 0.0;
+  testaModelo("Ashrae (eFactor)", semConvergencia);
+  // Modo rpido: as verses vetoriais ignoram as tabelas e devem concordar com as escalares tabeladas
+  Ashrae rapido;
+  rapido.fastMode(250.0, 330.0, 50000.0, 600000.0);
+  testaModelo("Ashrae (fastMode)", rapido);
+  // Em Giacomo s Tws  tabelada (ver Ashrae::fastTables)
+  Giacomo grapido;
+  if (grapido.fastMode(250.0, 330.0, 50000.0, 600000.0) || grapido.fast->pws_l.contains(300.0) ||
+      grapido.fast->ef_l.contains(300.0, 101325.0) || !grapido.fast->tws_l.contains(log(3000.0))){
+    printf("Giacomo: tabelas do modo rpido\n");
+    ++falhas;
+  }
+  testaModelo("Giacomo (fastMode)", grapido);
+  Ashrae a;
+  Ashrae105 a105;
+  testaPontoOrvalho("Ashrae", a);
+  testaPontoOrvalho("Ashrae105", a105);
+
+  testaCodigos();
+  testaBulboUmido();
+  Ashrae aref;
+  Giacomo gref;
+  aref.tol.wetbulb = aref.tol.dewpoint = gref.tol.wetbulb = gref.tol.dewpoint = 1e-13;
+  testaPartidaQuente("Ashrae", Ashrae(), aref);
+  testaPartidaQuente("Giacomo", Giacomo(), gref);
+  testaMemoria();
+  testaCache();
+  testaFloat("GasPerfeito", GasPerfeito(), true);
+  testaFloat("Ashrae", Ashrae(), false);
+  testaFloat("Giacomo", Giacomo(), false);
+  testaFloat("Ashrae105", Ashrae105(), true);
+  testaFloat("AshraeVirtual", AshraeVirtual(), true);
+  testaFloat("GiacomoVirtual", GiacomoVirtual(), true);
+  testaEstatico("GasPerfeito", GasPerfeito(), GasPerfeitoVirtual());
+  testaEstatico("Ashrae", Ashrae(), AshraeVirtual());
+  testaEstatico("Giacomo", Giacomo(), GiacomoVirtual());
+  AshraeVirtual rapidoVirtual;
+  rapidoVirtual.fastMode(250.0, 330.0, 50000.0, 600000.0);
+  testaEstatico("Ashrae (fastMode)", rapido, rapidoVirtual);
+
+  if (falhas) printf("%d falhas\n", falhas);
+  else printf("OK\n");
+  return falhas ? 1 : 0;
+}